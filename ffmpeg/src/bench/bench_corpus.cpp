@@ -0,0 +1,299 @@
+/**
+    This file is part of @sj/ffmpeg.
+
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/9/3.
+//
+
+#include "bench_suite.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <sys/stat.h>
+#include <vector>
+
+#include "av/ffwrap/ff_includes.hpp"
+#include "av/ffwrap/ff_audio_writer.hpp"
+#include "av/ffwrap/ff_media_decoder.hpp"
+#include "av/ffwrap/ff_media_reader.hpp"
+#include "av/ffwrap/ff_single_stream_audio_transcoder.hpp"
+
+namespace FFAV {
+namespace Bench {
+
+// 语料由 AudioWriter 按固定的信号生成, 编码器由文件后缀决定;
+// 已存在的文件直接复用, 也可以放入同名的文件替换;
+struct CorpusEntry {
+    const char* codec;
+    const char* file_name;
+};
+
+static const CorpusEntry kCorpus[] = {
+    { "mp3", "corpus.mp3" },
+    { "aac", "corpus.m4a" },
+    { "flac", "corpus.flac" },
+    { "opus", "corpus.opus" },
+    { "vorbis", "corpus.ogg" },
+};
+
+static const int kCorpusSampleRate = 48000;
+static const int kCorpusChannels = 2;
+static const int kCorpusSeconds = 30;
+static const int kWriteSeconds = 5;
+static const int kChunkFrames = 1024;
+
+// 播放器的输出格式;
+static const int kPcmSampleRate = 44100;
+static const AVSampleFormat kPcmSampleFormat = AV_SAMPLE_FMT_S16;
+static const int kPcmChannels = 2;
+static const int kPcmFrames = 4096;
+
+struct PacketFrame {
+    AVPacket* pkt { av_packet_alloc() };
+    AVFrame* frame { av_frame_alloc() };
+    ~PacketFrame() {
+        av_packet_free(&pkt);
+        av_frame_free(&frame);
+    }
+};
+
+static bool file_exists(const std::string& path, int64_t* size = nullptr) {
+    struct stat st;
+    if ( stat(path.c_str(), &st) != 0 || st.st_size == 0 ) return false;
+    if ( size ) *size = st.st_size;
+    return true;
+}
+
+// 三个和弦音叠加缓慢的幅度变化及少量噪声, 避免编码器对纯音或静音走捷径;
+static void fill_signal(int16_t* samples, int nb_frames, int64_t start_frame, uint32_t* seed) {
+    static const double kFreqs[] = { 220.0, 277.18, 329.63 };
+    for ( int i = 0 ; i < nb_frames ; ++ i ) {
+        double t = (double)(start_frame + i) / kCorpusSampleRate;
+        double envelope = 0.6 + 0.4 * sin(2 * M_PI * 0.25 * t);
+        for ( int ch = 0 ; ch < kCorpusChannels ; ++ ch ) {
+            double v = 0;
+            for ( double freq : kFreqs ) {
+                v += sin(2 * M_PI * freq * (ch + 1) * t) / 3;
+            }
+            *seed = *seed * 1664525u + 1013904223u;
+            double noise = ((*seed >> 16) / 32768.0 - 1.0) * 0.02;
+            samples[i * kCorpusChannels + ch] = (int16_t)((v * envelope * 0.5 + noise) * INT16_MAX);
+        }
+    }
+}
+
+// 将 seconds 秒的信号写入 path, 返回写入的采样数;
+static int64_t write_signal(const std::string& path, int seconds, int64_t* out_ops) {
+    AudioWriter writer;
+    int ret = writer.init(path, AV_SAMPLE_FMT_S16, kCorpusSampleRate, kCorpusChannels);
+    if ( ret >= 0 ) ret = writer.open();
+    if ( ret < 0 ) return ret;
+
+    std::vector<int16_t> chunk(kChunkFrames * kCorpusChannels);
+    uint32_t seed = 1;
+    int64_t total = (int64_t)seconds * kCorpusSampleRate;
+    int64_t written = 0;
+    int64_t ops = 0;
+    while ( written < total ) {
+        int nb_frames = (int)std::min<int64_t>(kChunkFrames, total - written);
+        fill_signal(chunk.data(), nb_frames, written, &seed);
+        ret = writer.write(chunk.data(), nb_frames * kCorpusChannels * (int)sizeof(int16_t));
+        if ( ret < 0 ) return ret;
+        written += nb_frames;
+        ops += 1;
+    }
+
+    ret = writer.close();
+    if ( ret < 0 ) return ret;
+    if ( out_ops ) *out_ops = ops;
+    return written;
+}
+
+static bool prepare_corpus_file(Suite& suite, const CorpusEntry& entry, const std::string& path) {
+    if ( file_exists(path) ) {
+        return true;
+    }
+
+    // 先写入临时文件, 避免中断后留下不完整的语料;
+    std::string tmp_path = suite.options().corpus_dir + "/.tmp." + entry.file_name;
+    int64_t ret = write_signal(tmp_path, kCorpusSeconds, nullptr);
+    if ( ret < 0 || rename(tmp_path.c_str(), path.c_str()) != 0 ) {
+        remove(tmp_path.c_str());
+        suite.skip(std::string("corpus/") + entry.codec, ret < 0 ? errorString((int)ret) : "rename failed");
+        return false;
+    }
+    return true;
+}
+
+// MediaReader + MediaDecoder: 只解码, 不做格式转换;
+static Round decode_file(const std::string& path) {
+    MediaReader reader;
+    if ( reader.open(path) < 0 ) return Round { -1, 0 };
+    AVStream* stream = reader.getBestStream(AVMEDIA_TYPE_AUDIO);
+    if ( !stream ) return Round { -1, 0 };
+
+    MediaDecoder decoder;
+    if ( decoder.init(stream->codecpar) < 0 ) return Round { -1, 0 };
+
+    PacketFrame pf;
+    Round r;
+    bool eof = false;
+    while ( !eof ) {
+        int ret = reader.readPacket(pf.pkt);
+        if ( ret == AVERROR_EOF ) {
+            eof = true;
+            ret = decoder.send(nullptr);
+        }
+        else if ( ret < 0 ) {
+            return Round { -1, 0 };
+        }
+        else if ( pf.pkt->stream_index != stream->index ) {
+            av_packet_unref(pf.pkt);
+            continue;
+        }
+        else {
+            ret = decoder.send(pf.pkt);
+            av_packet_unref(pf.pkt);
+            r.ops += 1;
+        }
+
+        if ( ret < 0 && ret != AVERROR(EAGAIN) && ret != AVERROR_INVALIDDATA ) {
+            return Round { -1, 0 };
+        }
+
+        while ( (ret = decoder.receive(pf.frame)) >= 0 ) {
+            r.items += pf.frame->nb_samples;
+            av_frame_unref(pf.frame);
+        }
+        if ( ret != AVERROR(EAGAIN) && ret != AVERROR_EOF ) {
+            return Round { -1, 0 };
+        }
+    }
+    return r;
+}
+
+// MediaReader + SingleStreamAudioTranscoder: 与播放器相同的解码到 pcm 的路径;
+static Round decode_file_to_pcm(const std::string& path) {
+    MediaReader reader;
+    if ( reader.open(path) < 0 ) return Round { -1, 0 };
+
+    SingleStreamAudioTranscoder transcoder;
+    if ( transcoder.init(reader.getStreamProvider(), kPcmSampleRate, kPcmSampleFormat, kPcmChannels) < 0 ) return Round { -1, 0 };
+
+    std::vector<uint8_t> buf(kPcmFrames * kPcmChannels * av_get_bytes_per_sample(kPcmSampleFormat));
+    void* out_data[1] = { buf.data() };
+
+    PacketFrame pf;
+    Round r;
+    bool read_eof = false;
+    bool out_eof = false;
+    while ( !out_eof ) {
+        if ( !read_eof ) {
+            int ret = reader.readPacket(pf.pkt);
+            if ( ret == AVERROR_EOF ) {
+                read_eof = true;
+                transcoder.enqueue(nullptr);
+            }
+            else if ( ret < 0 ) {
+                return Round { -1, 0 };
+            }
+            else {
+                transcoder.enqueue(pf.pkt);
+                av_packet_unref(pf.pkt);
+                r.ops += 1;
+            }
+        }
+
+        int nb_samples = 0;
+        do {
+            nb_samples = transcoder.tryTranscode(out_data, kPcmFrames, nullptr, &out_eof);
+            if ( nb_samples < 0 ) return Round { -1, 0 };
+            r.items += nb_samples;
+        } while ( nb_samples > 0 && !out_eof );
+
+        // 已读取到结尾却无法继续转码;
+        if ( read_eof && nb_samples == 0 && !out_eof ) {
+            return Round { -1, 0 };
+        }
+    }
+    return r;
+}
+
+static int probe_sample_rate(const std::string& path) {
+    MediaReader reader;
+    if ( reader.open(path) < 0 ) return 0;
+    AVStream* stream = reader.getBestStream(AVMEDIA_TYPE_AUDIO);
+    return stream ? stream->codecpar->sample_rate : 0;
+}
+
+// sample_rate: 吞吐对应的采样率, 用于换算相对实时播放的倍数;
+static void add_file_params(Result* result, const CorpusEntry& entry, const std::string& path, int sample_rate) {
+    if ( !result ) return;
+    int64_t size = 0;
+    file_exists(path, &size);
+    result->params["file"] = entry.file_name;
+    result->params["codec"] = entry.codec;
+    result->metrics["file_bytes"] = (double)size;
+    if ( sample_rate > 0 ) {
+        result->metrics["realtime"] = result->rate / sample_rate;
+    }
+}
+
+void runCorpusBenchmarks(Suite& suite) {
+    const std::string& dir = suite.options().corpus_dir;
+    mkdir(dir.c_str(), 0755);
+
+    for ( const CorpusEntry& entry : kCorpus ) {
+        std::string codec = entry.codec;
+        std::string path = dir + "/" + entry.file_name;
+
+        // AudioWriter: 编码并封装 kWriteSeconds 秒的 pcm;
+        std::string write_name = "audio_writer/" + codec;
+        if ( suite.isEnabled(write_name) ) {
+            std::string write_path = dir + "/.write." + entry.file_name;
+            Result* result = suite.measure(write_name, "samples/s", [&] {
+                int64_t ops = 0;
+                int64_t written = write_signal(write_path, kWriteSeconds, &ops);
+                return written < 0 ? Round { -1, 0 } : Round { written, ops };
+            });
+            add_file_params(result, entry, write_path, kCorpusSampleRate);
+            remove(write_path.c_str());
+        }
+
+        std::string decode_name = "decode/" + codec;
+        std::string pcm_name = "decode_to_pcm/" + codec;
+        if ( !suite.isEnabled(decode_name) && !suite.isEnabled(pcm_name) ) {
+            continue;
+        }
+
+        if ( !prepare_corpus_file(suite, entry, path) ) {
+            continue;
+        }
+
+        Result* result = suite.measure(decode_name, "samples/s", [&] {
+            return decode_file(path);
+        });
+        add_file_params(result, entry, path, probe_sample_rate(path));
+
+        result = suite.measure(pcm_name, "samples/s", [&] {
+            return decode_file_to_pcm(path);
+        });
+        add_file_params(result, entry, path, kPcmSampleRate);
+    }
+}
+
+}
+}
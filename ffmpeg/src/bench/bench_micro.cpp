@@ -0,0 +1,297 @@
+/**
+    This file is part of @sj/ffmpeg.
+
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/9/3.
+//
+
+#include "bench_suite.hpp"
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#include "av/ffwrap/ff_includes.hpp"
+#include "av/ffwrap/ff_packet_queue.hpp"
+#include "av/ffwrap/ff_audio_fifo.hpp"
+#include "av/ffwrap/ff_sample_buf.h"
+#include "av/ffwrap/ff_filter_graph.hpp"
+
+extern "C" {
+#include "fftools/objpool.h"
+#include "fftools/thread_queue.h"
+}
+
+namespace FFAV {
+namespace Bench {
+
+static const int kFrameSize = 1024;
+static const int kSampleRate = 48000;
+static const int kChannels = 2;
+
+// 生成一帧 48kHz 立体声的正弦波;
+static AVFrame* create_audio_frame(AVSampleFormat sample_fmt, int nb_samples) {
+    AVFrame* frame = av_frame_alloc();
+    frame->format = sample_fmt;
+    frame->sample_rate = kSampleRate;
+    frame->nb_samples = nb_samples;
+    av_channel_layout_default(&frame->ch_layout, kChannels);
+    if ( av_frame_get_buffer(frame, 0) < 0 ) {
+        av_frame_free(&frame);
+        return nullptr;
+    }
+
+    bool planar = av_sample_fmt_is_planar(sample_fmt);
+    for ( int i = 0 ; i < nb_samples ; ++ i ) {
+        double v = 0.5 * sin(2 * M_PI * 440.0 * i / kSampleRate);
+        for ( int ch = 0 ; ch < kChannels ; ++ ch ) {
+            int plane = planar ? ch : 0;
+            int idx = planar ? i : i * kChannels + ch;
+            switch ( sample_fmt ) {
+                case AV_SAMPLE_FMT_FLT:
+                case AV_SAMPLE_FMT_FLTP:
+                    ((float*)frame->data[plane])[idx] = (float)v;
+                    break;
+                case AV_SAMPLE_FMT_S16:
+                case AV_SAMPLE_FMT_S16P:
+                    ((int16_t*)frame->data[plane])[idx] = (int16_t)(v * INT16_MAX);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    return frame;
+}
+
+// PacketQueue: 入队时引用计数 +1, 出队时移交引用, 衡量每个包的往返开销;
+static void bench_packet_queue(Suite& suite) {
+    static const int kBatch = 256;
+    static const int kBatches = 16;
+
+    PacketQueue queue;
+    AVPacket* tmpl = av_packet_alloc();
+    av_new_packet(tmpl, 512);
+    tmpl->duration = kFrameSize;
+    AVPacket* pkt = av_packet_alloc();
+    int64_t pts = 0;
+
+    suite.measure("packet_queue/push_pop", "packets/s", [&] {
+        Round r;
+        for ( int b = 0 ; b < kBatches ; ++ b ) {
+            for ( int i = 0 ; i < kBatch ; ++ i ) {
+                tmpl->pts = tmpl->dts = pts;
+                pts += kFrameSize;
+                queue.push(tmpl);
+            }
+            while ( queue.pop(pkt) ) {
+                av_packet_unref(pkt);
+                r.items += 1;
+            }
+        }
+        r.ops = r.items;
+        return r;
+    });
+
+    av_packet_free(&pkt);
+    av_packet_free(&tmpl);
+}
+
+// AudioFifo: 每次写入并读出一帧 fltp 数据;
+static void bench_audio_fifo(Suite& suite) {
+    static const int kFrames = 64;
+
+    AudioFifo fifo;
+    if ( fifo.init(kSampleRate, AV_SAMPLE_FMT_FLTP, kChannels, kFrameSize * 4) < 0 ) {
+        suite.skip("audio_fifo/write_read", "init failed");
+        return;
+    }
+
+    AVFrame* in = create_audio_frame(AV_SAMPLE_FMT_FLTP, kFrameSize);
+    AVFrame* out = create_audio_frame(AV_SAMPLE_FMT_FLTP, kFrameSize);
+    int64_t pts = 0;
+
+    suite.measure("audio_fifo/write_read", "samples/s", [&] {
+        Round r;
+        for ( int i = 0 ; i < kFrames ; ++ i ) {
+            if ( fifo.write((void**)in->data, kFrameSize, pts) < 0 ) return Round { -1, 0 };
+            pts += kFrameSize;
+            int ret = fifo.read((void**)out->data, kFrameSize, nullptr);
+            if ( ret < 0 ) return Round { -1, 0 };
+            r.items += ret;
+            r.ops += 2;
+        }
+        return r;
+    });
+
+    av_frame_free(&in);
+    av_frame_free(&out);
+}
+
+// SampleBuf::mixTo: 多路混音时每路每个周期调用一次;
+static void bench_sample_buf(Suite& suite, AVSampleFormat sample_fmt) {
+    static const int kCalls = 256;
+
+    std::string name = std::string("sample_buf/mix_to/") + av_get_sample_fmt_name(sample_fmt);
+    if ( !suite.isEnabled(name) ) return;
+
+    SampleBuf src(kFrameSize, sample_fmt, kChannels);
+    AVFrame* tone = create_audio_frame(sample_fmt, kFrameSize);
+    AVFrame* dst = create_audio_frame(sample_fmt, kFrameSize);
+    int planes = av_sample_fmt_is_planar(sample_fmt) ? kChannels : 1;
+    int plane_size = kFrameSize * av_get_bytes_per_sample(sample_fmt) * (planes == 1 ? kChannels : 1);
+    for ( int p = 0 ; p < planes ; ++ p ) {
+        memcpy(src.data()[p], tone->data[p], plane_size);
+    }
+
+    suite.measure(name, "samples/s", [&] {
+        Round r;
+        for ( int i = 0 ; i < kCalls ; ++ i ) {
+            src.mixTo(dst->data, 0.5f);
+        }
+        r.items = (int64_t)kCalls * kFrameSize;
+        r.ops = kCalls;
+        return r;
+    });
+
+    av_frame_free(&tone);
+    av_frame_free(&dst);
+}
+
+// FilterGraph: 逐帧 addFrame/getFrame, 对比空滤镜(调度开销)与播放路径上的重采样;
+static void bench_filter_graph(Suite& suite, const std::string& name, const std::string& filter_descr, int out_sample_rate, AVSampleFormat out_sample_fmt) {
+    static const int kFrames = 64;
+    static const std::string kSrcName = "a";
+    static const std::string kSinkName = "o";
+
+    if ( !suite.isEnabled(name) ) return;
+
+    char ch_layout_desc[64];
+    AVChannelLayout ch_layout;
+    av_channel_layout_default(&ch_layout, kChannels);
+    av_channel_layout_describe(&ch_layout, ch_layout_desc, sizeof(ch_layout_desc));
+
+    FilterGraph graph;
+    int ret = graph.init();
+    if ( ret >= 0 ) ret = graph.addAudioBufferSourceFilter(kSrcName, (AVRational){ 1, kSampleRate }, kSampleRate, AV_SAMPLE_FMT_FLTP, ch_layout_desc);
+    if ( ret >= 0 ) ret = graph.addAudioBufferSinkFilter(kSinkName, out_sample_rate, out_sample_fmt, ch_layout_desc);
+    if ( ret >= 0 ) ret = graph.parse("[" + kSrcName + "]" + filter_descr + "[" + kSinkName + "]");
+    if ( ret >= 0 ) ret = graph.configure();
+    if ( ret < 0 ) {
+        suite.skip(name, errorString(ret));
+        return;
+    }
+
+    AVFrame* in = create_audio_frame(AV_SAMPLE_FMT_FLTP, kFrameSize);
+    AVFrame* out = av_frame_alloc();
+    int64_t pts = 0;
+
+    suite.measure(name, "samples/s", [&] {
+        Round r;
+        for ( int i = 0 ; i < kFrames ; ++ i ) {
+            in->pts = pts;
+            pts += kFrameSize;
+            if ( graph.addFrame(kSrcName, in) < 0 ) return Round { -1, 0 };
+            r.ops += 1;
+            while ( graph.getFrame(kSinkName, out) >= 0 ) {
+                av_frame_unref(out);
+            }
+        }
+        r.items = (int64_t)kFrames * kFrameSize;
+        return r;
+    });
+
+    av_frame_free(&in);
+    av_frame_free(&out);
+}
+
+static void tq_packet_move(void* dst, void* src) {
+    av_packet_move_ref((AVPacket*)dst, (AVPacket*)src);
+}
+
+// ThreadQueue: 一个线程发送, 另一个线程接收, 与主线程到封装线程的交接方式相同;
+static void bench_thread_queue(Suite& suite, bool spsc, size_t queue_size) {
+    static const int kPackets = 1 << 16;
+
+    std::string name = std::string("thread_queue/") + (spsc ? "spsc" : "locked") + "/q" + std::to_string(queue_size);
+    if ( !suite.isEnabled(name) ) return;
+
+    AVPacket* tmpl = av_packet_alloc();
+    av_new_packet(tmpl, 512);
+
+    Result* result = suite.measure(name, "packets/s", [&] {
+        ObjPool* pool = objpool_alloc_packets();
+        if ( !pool ) return Round { -1, 0 };
+        ThreadQueue* tq = spsc ? tq_alloc_spsc(1, queue_size, pool, tq_packet_move)
+                               : tq_alloc(1, queue_size, pool, tq_packet_move);
+        if ( !tq ) return Round { -1, 0 };
+
+        std::thread sender([&] {
+            AVPacket* pkt = av_packet_alloc();
+            for ( int i = 0 ; i < kPackets ; ++ i ) {
+                av_packet_ref(pkt, tmpl);
+                pkt->pts = i;
+                if ( tq_send(tq, 0, pkt) < 0 ) {
+                    av_packet_unref(pkt);
+                    break;
+                }
+            }
+            tq_send_finish(tq, 0);
+            av_packet_free(&pkt);
+        });
+
+        Round r;
+        AVPacket* pkt = av_packet_alloc();
+        for ( ;; ) {
+            int stream_idx = -1;
+            int ret = tq_receive(tq, &stream_idx, pkt);
+            if ( ret >= 0 ) {
+                av_packet_unref(pkt);
+                r.items += 1;
+                continue;
+            }
+            if ( ret != AVERROR_EOF || stream_idx < 0 ) {
+                break;
+            }
+        }
+        sender.join();
+        av_packet_free(&pkt);
+        tq_free(&tq);
+
+        r.ops = r.items;
+        return r.items == kPackets ? r : Round { -1, 0 };
+    });
+    if ( result ) {
+        result->params["queue_size"] = std::to_string(queue_size);
+    }
+
+    av_packet_free(&tmpl);
+}
+
+void runMicroBenchmarks(Suite& suite) {
+    bench_packet_queue(suite);
+    bench_audio_fifo(suite);
+    bench_sample_buf(suite, AV_SAMPLE_FMT_FLT);
+    bench_sample_buf(suite, AV_SAMPLE_FMT_S16);
+    bench_filter_graph(suite, "filter_graph/anull", "anull", kSampleRate, AV_SAMPLE_FMT_FLTP);
+    bench_filter_graph(suite, "filter_graph/aresample_44100_s16", "aresample=44100,aformat=sample_fmts=s16", 44100, AV_SAMPLE_FMT_S16);
+    for ( size_t queue_size : { (size_t)8, (size_t)256 } ) {
+        bench_thread_queue(suite, false, queue_size);
+        bench_thread_queue(suite, true, queue_size);
+    }
+}
+
+}
+}
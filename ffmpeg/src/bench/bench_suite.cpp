@@ -0,0 +1,210 @@
+/**
+    This file is part of @sj/ffmpeg.
+
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/9/3.
+//
+
+#include "bench_suite.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <thread>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavfilter/avfilter.h>
+#include <libavformat/avformat.h>
+#include <libavutil/avutil.h>
+}
+
+namespace FFAV {
+namespace Bench {
+
+using Clock = std::chrono::steady_clock;
+
+static std::string json_escape(const std::string& str) {
+    std::string out;
+    out.reserve(str.size() + 2);
+    for ( unsigned char c : str ) {
+        switch ( c ) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if ( c < 0x20 ) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                }
+                else {
+                    out += (char)c;
+                }
+                break;
+        }
+    }
+    return "\"" + out + "\"";
+}
+
+static std::string json_number(double value) {
+    if ( !std::isfinite(value) ) return "null";
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.6g", value);
+    return buf;
+}
+
+static std::string version_string(unsigned version) {
+    std::ostringstream oss;
+    oss << AV_VERSION_MAJOR(version) << "." << AV_VERSION_MINOR(version) << "." << AV_VERSION_MICRO(version);
+    return oss.str();
+}
+
+std::string errorString(int err) {
+    char buf[AV_ERROR_MAX_STRING_SIZE] = { 0 };
+    av_strerror(err, buf, sizeof(buf));
+    return buf;
+}
+
+Suite::Suite(const Options& options): _options(options) {
+
+}
+
+bool Suite::isEnabled(const std::string& name) const {
+    return _options.filter.empty() || name.find(_options.filter) != std::string::npos;
+}
+
+Result* Suite::measure(const std::string& name, const std::string& unit, const std::function<Round()>& round) {
+    if ( !isEnabled(name) ) {
+        return nullptr;
+    }
+
+    // 预热; 首轮包含分配及缓存冷启动的开销, 不计入结果;
+    Round warmup = round();
+    if ( warmup.items < 0 ) {
+        skip(name, "failed");
+        return nullptr;
+    }
+
+    Result result;
+    result.name = name;
+    result.unit = unit;
+
+    auto min_duration = std::chrono::duration<double>(_options.min_time);
+    auto start = Clock::now();
+    do {
+        auto round_start = Clock::now();
+        Round r = round();
+        double round_seconds = std::chrono::duration<double>(Clock::now() - round_start).count();
+        if ( r.items < 0 ) {
+            skip(name, "failed");
+            return nullptr;
+        }
+
+        result.items += r.items;
+        result.ops += r.ops;
+        result.rounds += 1;
+        if ( round_seconds > 0 ) {
+            result.best_rate = std::max(result.best_rate, r.items / round_seconds);
+        }
+    } while ( result.rounds < _options.repeat || Clock::now() - start < min_duration );
+
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    result.rate = result.seconds > 0 ? result.items / result.seconds : 0;
+    result.ns_per_op = result.ops > 0 ? result.seconds * 1e9 / result.ops : 0;
+
+    fprintf(stderr, "%-48s %14.0f %-10s %10.1f ns/op\n", name.c_str(), result.rate, unit.c_str(), result.ns_per_op);
+    _results.push_back(std::move(result));
+    return &_results.back();
+}
+
+void Suite::skip(const std::string& name, const std::string& reason) {
+    fprintf(stderr, "%-48s skipped: %s\n", name.c_str(), reason.c_str());
+    _skipped.emplace_back(name, reason);
+}
+
+std::string Suite::toJson() const {
+    std::ostringstream oss;
+    oss << "{\n";
+    oss << "  \"suite\": \"ffwrap\",\n";
+    oss << "  \"schema\": 1,\n";
+    oss << "  \"host\": {\n";
+    oss << "    \"ffmpeg\": " << json_escape(av_version_info()) << ",\n";
+    oss << "    \"libavutil\": " << json_escape(version_string(avutil_version())) << ",\n";
+    oss << "    \"libavcodec\": " << json_escape(version_string(avcodec_version())) << ",\n";
+    oss << "    \"libavformat\": " << json_escape(version_string(avformat_version())) << ",\n";
+    oss << "    \"libavfilter\": " << json_escape(version_string(avfilter_version())) << ",\n";
+#if defined(__VERSION__)
+    oss << "    \"compiler\": " << json_escape(__VERSION__) << ",\n";
+#endif
+    oss << "    \"cpus\": " << std::thread::hardware_concurrency() << "\n";
+    oss << "  },\n";
+    oss << "  \"options\": {\n";
+    oss << "    \"min_time\": " << json_number(_options.min_time) << ",\n";
+    oss << "    \"repeat\": " << _options.repeat << ",\n";
+    oss << "    \"filter\": " << json_escape(_options.filter) << "\n";
+    oss << "  },\n";
+
+    oss << "  \"results\": [";
+    for ( size_t i = 0 ; i < _results.size() ; ++ i ) {
+        const Result& r = _results[i];
+        oss << (i == 0 ? "\n" : ",\n");
+        oss << "    { \"name\": " << json_escape(r.name)
+            << ", \"unit\": " << json_escape(r.unit)
+            << ", \"rate\": " << json_number(r.rate)
+            << ", \"best_rate\": " << json_number(r.best_rate)
+            << ", \"ns_per_op\": " << json_number(r.ns_per_op)
+            << ", \"items\": " << r.items
+            << ", \"ops\": " << r.ops
+            << ", \"rounds\": " << r.rounds
+            << ", \"seconds\": " << json_number(r.seconds);
+        if ( !r.params.empty() ) {
+            oss << ", \"params\": {";
+            bool first = true;
+            for ( auto& pair : r.params ) {
+                oss << (first ? " " : ", ") << json_escape(pair.first) << ": " << json_escape(pair.second);
+                first = false;
+            }
+            oss << " }";
+        }
+        if ( !r.metrics.empty() ) {
+            oss << ", \"metrics\": {";
+            bool first = true;
+            for ( auto& pair : r.metrics ) {
+                oss << (first ? " " : ", ") << json_escape(pair.first) << ": " << json_number(pair.second);
+                first = false;
+            }
+            oss << " }";
+        }
+        oss << " }";
+    }
+    oss << (_results.empty() ? "],\n" : "\n  ],\n");
+
+    oss << "  \"skipped\": [";
+    for ( size_t i = 0 ; i < _skipped.size() ; ++ i ) {
+        oss << (i == 0 ? "\n" : ",\n");
+        oss << "    { \"name\": " << json_escape(_skipped[i].first) << ", \"reason\": " << json_escape(_skipped[i].second) << " }";
+    }
+    oss << (_skipped.empty() ? "]\n" : "\n  ]\n");
+    oss << "}\n";
+    return oss.str();
+}
+
+}
+}
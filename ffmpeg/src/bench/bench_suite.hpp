@@ -0,0 +1,95 @@
+/**
+    This file is part of @sj/ffmpeg.
+
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/9/3.
+//
+// 主机端基准测试; 只在 Linux 上构建, 不参与 HarmonyOS 的构建;
+
+#ifndef FFAV_BenchSuite_hpp
+#define FFAV_BenchSuite_hpp
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace FFAV {
+namespace Bench {
+
+struct Options {
+    std::string corpus_dir { "bench_corpus" }; // 语料目录, 不存在的文件会自动生成;
+    std::string out_path;                       // 结果输出路径, 为空时输出到 stdout;
+    std::string filter;                         // 只运行名称中包含该字符串的测试;
+    double min_time { 0.5 };                    // 每项测试的最短计时, 单位秒;
+    int repeat { 3 };                           // 每项测试的最少轮数;
+};
+
+// 一轮测试处理的数据量;
+struct Round {
+    int64_t items { 0 };    // 数据量, 如包数/采样数, 用于计算吞吐;
+    int64_t ops { 0 };      // 调用次数, 用于计算 ns/op;
+};
+
+struct Result {
+    std::string name;
+    std::string unit;       // 吞吐的单位, 如 packets/s;
+    double rate { 0 };      // 所有轮次的平均吞吐;
+    double best_rate { 0 }; // 单轮最高吞吐, 受调度影响较小, 适合用于比较;
+    double ns_per_op { 0 };
+    int64_t items { 0 };
+    int64_t ops { 0 };
+    int rounds { 0 };
+    double seconds { 0 };
+    std::map<std::string, std::string> params;
+    std::map<std::string, double> metrics;
+};
+
+class Suite {
+public:
+    explicit Suite(const Options& options);
+
+    const Options& options() const { return _options; }
+    bool isEnabled(const std::string& name) const;
+
+    // 预热一轮后重复执行 round, 直到累计耗时达到 min_time 且轮数达到 repeat;
+    // round 返回负的 items 表示出错, 该项测试记为跳过并返回 nullptr;
+    // 返回的结果可用于补充参数, 在下一次 measure 之前有效;
+    Result* measure(const std::string& name, const std::string& unit, const std::function<Round()>& round);
+
+    void skip(const std::string& name, const std::string& reason);
+
+    std::string toJson() const;
+
+private:
+    Options _options;
+    std::vector<Result> _results;
+    std::vector<std::pair<std::string, std::string>> _skipped;
+};
+
+// av_err2str 依赖复合字面量, 在 C++ 中不可用;
+std::string errorString(int err);
+
+// ffwrap 及 fftools 队列的微基准;
+void runMicroBenchmarks(Suite& suite);
+// 基于固定语料的解码吞吐;
+void runCorpusBenchmarks(Suite& suite);
+
+}
+}
+
+#endif //FFAV_BenchSuite_hpp
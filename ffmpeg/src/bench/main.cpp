@@ -0,0 +1,94 @@
+/**
+    This file is part of @sj/ffmpeg.
+
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/9/3.
+//
+
+#include "bench_suite.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+extern "C" {
+#include <libavutil/log.h>
+}
+
+static void print_usage(const char* prog) {
+    fprintf(stderr,
+        "usage: %s [options]\n"
+        "  --corpus DIR     corpus directory, missing files are generated (default: bench_corpus)\n"
+        "  --out FILE       write the JSON results to FILE instead of stdout\n"
+        "  --filter STR     only run benchmarks whose name contains STR\n"
+        "  --min-time SEC   minimum measured time per benchmark (default: 0.5)\n"
+        "  --repeat N       minimum number of measured rounds per benchmark (default: 3)\n",
+        prog);
+}
+
+int main(int argc, char** argv) {
+    FFAV::Bench::Options options;
+    for ( int i = 1 ; i < argc ; ++ i ) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if ( strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0 ) {
+            print_usage(argv[0]);
+            return 0;
+        }
+        if ( !value ) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        if ( strcmp(arg, "--corpus") == 0 ) options.corpus_dir = value;
+        else if ( strcmp(arg, "--out") == 0 ) options.out_path = value;
+        else if ( strcmp(arg, "--filter") == 0 ) options.filter = value;
+        else if ( strcmp(arg, "--min-time") == 0 ) options.min_time = atof(value);
+        else if ( strcmp(arg, "--repeat") == 0 ) options.repeat = atoi(value);
+        else {
+            print_usage(argv[0]);
+            return 1;
+        }
+        ++ i;
+    }
+
+    av_log_set_level(AV_LOG_ERROR);
+
+    FFAV::Bench::Suite suite(options);
+    try {
+        FFAV::Bench::runMicroBenchmarks(suite);
+        FFAV::Bench::runCorpusBenchmarks(suite);
+    }
+    catch ( const std::exception& e ) {
+        // ffwrap 在调用顺序错误时抛出异常;
+        fprintf(stderr, "error: %s\n", e.what());
+        return 1;
+    }
+
+    std::string json = suite.toJson();
+    if ( options.out_path.empty() ) {
+        fputs(json.c_str(), stdout);
+        return 0;
+    }
+
+    FILE* file = fopen(options.out_path.c_str(), "w");
+    if ( !file ) {
+        fprintf(stderr, "error: cannot open %s\n", options.out_path.c_str());
+        return 1;
+    }
+    fputs(json.c_str(), file);
+    fclose(file);
+    return 0;
+}
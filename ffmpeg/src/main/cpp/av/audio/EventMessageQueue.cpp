@@ -21,6 +21,7 @@
 // please include "napi/native_api.h".
 
 #include "EventMessageQueue.h"
+#include "av/utils/thread_budget.h"
 
 namespace FFAV {
 
@@ -36,6 +37,7 @@ void EventMessageQueue::setEventCallback(EventCallback callback) {
     
     if ( callback ) {
         if ( !msg_thread ) {
+            budget_job = ThreadBudget::currentJob();
             msg_thread = std::make_unique<std::thread>(&EventMessageQueue::ProcessQueue, this);
         }
     }
@@ -74,6 +76,7 @@ void EventMessageQueue::stop() {
 }
 
 void EventMessageQueue::ProcessQueue() {
+    ThreadBudget::ThreadScope budget_scope(budget_job, NATIVE_THREAD_EVENT);
     while (true) {
         // 这里上锁，确保线程安全
         std::unique_lock<std::mutex> lock(mtx);
@@ -46,6 +46,7 @@ private:
     std::mutex mtx;
     std::condition_variable msg_cv;
     std::unique_ptr<std::thread> msg_thread = nullptr;
+    uint64_t budget_job = 0; // 消息线程所属的任务(ThreadBudget);
     std::queue<std::shared_ptr<EventMessage>> msg_queue;
     bool is_running = true;
     
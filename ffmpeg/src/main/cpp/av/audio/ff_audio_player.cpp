@@ -26,6 +26,9 @@
 #include "av/ohutils/OHUtils.hpp"
 #include "av/utils/logger.h"
 #include "av/ffwrap/ff_audio_item.hpp"
+#include "av/ffwrap/ff_media_probe.hpp"
+#include "av/utils/probe_cache.hpp"
+#include "av/utils/thread_budget.h"
 
 namespace FFAV {
 
@@ -39,7 +42,8 @@ AudioPlayer::AudioPlayer(const std::string& url, const AudioPlaybackOptions& opt
     _output_sample_rate(OUTPUT_SAMPLE_RATE),
     _output_sample_format(OUTPUT_SAMPLE_FORMAT),
     _output_channels(OUTPUT_CHANNELS),
-    _output_bytes_per_sample(av_get_bytes_per_sample(OUTPUT_SAMPLE_FORMAT))
+    _output_bytes_per_sample(av_get_bytes_per_sample(OUTPUT_SAMPLE_FORMAT)),
+    _budget_job(ThreadBudget::beginJob(ThreadBudget::PLAYER))
 {
 
 }
@@ -66,6 +70,8 @@ AudioPlayer::~AudioPlayer() {
         _audio_item = nullptr;
     }
     
+    ThreadBudget::endJob(_budget_job);
+    
 #ifdef DEBUG
     ff_console_print("AAAA: AudioPlayer::~AudioPlayer after");
 #endif
@@ -73,11 +79,13 @@ AudioPlayer::~AudioPlayer() {
 
 void AudioPlayer::prepare() {
     std::lock_guard<std::mutex> lock(mtx);
+    ThreadBudget::JobBinding budget_binding(_budget_job);
     onPrepare();
 }
 
 void AudioPlayer::play() {
     std::lock_guard<std::mutex> lock(mtx);
+    ThreadBudget::JobBinding budget_binding(_budget_job);
     onPlay(PlayWhenReadyChangeReason::USER_REQUEST);
 }
 
@@ -138,6 +146,7 @@ void AudioPlayer::setDefaultOutputDevice(OH_AudioDevice_Type device_type) {
 }
 
 void AudioPlayer::setEventCallback(EventMessageQueue::EventCallback callback) {
+    ThreadBudget::JobBinding budget_binding(_budget_job);
     _event_msg_queue->setEventCallback(callback);
 }
 
@@ -190,6 +199,14 @@ void AudioPlayer::onPrepare() {
     _audio_item->setErrorCallback([&](int ff_err) {
         onFFmpegError(ff_err);
     });
+    // 本地文件命中媒体信息缓存时, 无需等待打开文件即可回调时长;
+    std::string local_path = MediaProbe::localPath(_url);
+    MediaInfo cached_info;
+    if ( !local_path.empty() && ProbeCache::lookup(local_path, cached_info, false) && cached_info.duration > 0 ) {
+        _duration_ms = av_rescale(cached_info.duration, 1000, AV_TIME_BASE);
+        onEvent(std::make_shared<DurationChangeEventMessage>(_duration_ms));
+    }
+    
     // prepare
     _audio_item->prepare();
     
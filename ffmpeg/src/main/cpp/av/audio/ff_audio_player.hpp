@@ -102,6 +102,9 @@ private:
     
     EventMessageQueue* _event_msg_queue = new EventMessageQueue();
     
+    // 播放器在线程预算中对应的任务; 播放器创建的线程均计入该任务;
+    uint64_t _budget_job;
+    
     struct {
         unsigned released :1;
         unsigned prepared :1;
@@ -25,6 +25,7 @@
 
 #include "ff_types.hpp"
 #include <functional>
+#include <string>
 
 namespace FFAV {
 
@@ -0,0 +1,106 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/22.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "ff_media_probe.hpp"
+#include "ff_media_reader.hpp"
+#include "ff_includes.hpp"
+#include "av/utils/probe_cache.hpp"
+
+namespace FFAV {
+
+static void read_metadata(AVDictionary* _Nullable dict, std::map<std::string, std::string>& metadata) {
+    const AVDictionaryEntry* entry = nullptr;
+    while ( (entry = av_dict_iterate(dict, entry)) ) {
+        metadata[entry->key] = entry->value;
+    }
+}
+
+static void read_stream_info(AVStream* stream, MediaStreamInfo& info) {
+    AVCodecParameters* codecpar = stream->codecpar;
+    info.index = stream->index;
+    info.media_type = codecpar->codec_type;
+    info.codec_name = avcodec_get_name(codecpar->codec_id);
+    info.bit_rate = codecpar->bit_rate;
+    info.duration = stream->duration != AV_NOPTS_VALUE ? av_rescale_q(stream->duration, stream->time_base, AV_TIME_BASE_Q) : AV_NOPTS_VALUE;
+    info.sample_rate = codecpar->sample_rate;
+    info.nb_channels = codecpar->ch_layout.nb_channels;
+    info.sample_format = codecpar->codec_type == AVMEDIA_TYPE_AUDIO ? codecpar->format : AV_SAMPLE_FMT_NONE;
+    info.width = codecpar->width;
+    info.height = codecpar->height;
+    AVRational frame_rate = stream->avg_frame_rate.num ? stream->avg_frame_rate : stream->r_frame_rate;
+    info.frame_rate = frame_rate.den ? av_q2d(frame_rate) : 0;
+    read_metadata(stream->metadata, info.metadata);
+}
+
+std::string MediaProbe::localPath(const std::string& url) {
+    if ( url.compare(0, 7, "file://") == 0 ) return url.substr(7);
+    if ( !url.empty() && url[0] == '/' ) return url;
+    return "";
+}
+
+int MediaProbe::probe(const std::string& url, const MediaProbeOptions& options, MediaInfo& info, std::atomic<bool>* _Nullable interrupt_requested) {
+    std::string cache_path = options.use_cache ? localPath(url) : "";
+    if ( !cache_path.empty() && ProbeCache::lookup(cache_path, info, options.find_stream_info, options.verify_content) ) {
+        return 0;
+    }
+    
+    std::map<std::string, std::string> format_options = options.format_options;
+    if ( options.probesize > 0 ) format_options["probesize"] = std::to_string(options.probesize);
+    if ( options.analyzeduration > 0 ) format_options["analyzeduration"] = std::to_string(options.analyzeduration);
+    
+    MediaReader reader;
+    // 转发外部的取消请求, 阻塞在 io 中的打开及探测可以及时退出;
+    reader.setInterruptFlag(interrupt_requested);
+    if ( interrupt_requested && interrupt_requested->load() ) {
+        return AVERROR_EXIT;
+    }
+    
+    int ret = reader.open(url, format_options, options.find_stream_info);
+    if ( ret < 0 ) {
+        return ret;
+    }
+    
+    if ( interrupt_requested && interrupt_requested->load() ) {
+        return AVERROR_EXIT;
+    }
+    
+    const char* format_name = reader.getFormatName();
+    info.format_name = format_name ? format_name : "";
+    info.duration = reader.getDuration();
+    info.start_time = reader.getStartTime();
+    info.bit_rate = reader.getBitRate();
+    read_metadata(reader.getMetadata(), info.metadata);
+    
+    StreamProvider* provider = reader.getStreamProvider();
+    unsigned int nb_streams = provider->getStreamCount();
+    info.streams.resize(nb_streams);
+    for ( unsigned int i = 0 ; i < nb_streams ; ++ i ) {
+        read_stream_info(provider->getStream(i), info.streams[i]);
+    }
+    
+    if ( !cache_path.empty() ) {
+        ProbeCache::store(cache_path, info, options.find_stream_info, options.verify_content);
+    }
+    return 0;
+}
+
+}
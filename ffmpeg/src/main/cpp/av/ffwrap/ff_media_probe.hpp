@@ -0,0 +1,81 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/22.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef FFAV_MediaProbe_hpp
+#define FFAV_MediaProbe_hpp
+
+#include <string>
+#include <map>
+#include <vector>
+#include <atomic>
+#include "ff_types.hpp"
+
+namespace FFAV {
+
+struct MediaStreamInfo {
+    int index;
+    AVMediaType media_type;
+    std::string codec_name;
+    int64_t bit_rate;
+    int64_t duration;       // AV_TIME_BASE, 未知时为 AV_NOPTS_VALUE;
+    // audio
+    int sample_rate;
+    int nb_channels;
+    int sample_format;      // enum AVSampleFormat;
+    // video
+    int width;
+    int height;
+    double frame_rate;
+    std::map<std::string, std::string> metadata;
+};
+
+struct MediaInfo {
+    std::string format_name;
+    int64_t duration;       // AV_TIME_BASE, 未知时为 AV_NOPTS_VALUE;
+    int64_t start_time;     // AV_TIME_BASE, 未知时为 AV_NOPTS_VALUE;
+    int64_t bit_rate;
+    std::vector<MediaStreamInfo> streams;
+    std::map<std::string, std::string> metadata;
+};
+
+struct MediaProbeOptions {
+    int64_t probesize = 0;          // 字节, 0 表示使用 ffmpeg 的默认值;
+    int64_t analyzeduration = 0;    // 微秒, 0 表示使用 ffmpeg 的默认值;
+    bool find_stream_info = true;   // false 时仅读取容器头部信息, 不解析数据包;
+    std::map<std::string, std::string> format_options; // 传递给 avformat_open_input, 如 http 选项;
+    bool use_cache = true;          // 本地文件优先读取 ProbeCache;
+    bool verify_content = false;    // 缓存同时校验文件头部的哈希;
+};
+
+/** 基于 MediaReader 读取媒体信息, 不经过 ffprobe 命令行; */
+class MediaProbe {
+public:
+    // 成功返回 0, 失败返回 ffmpeg 错误码; interrupt_requested 不为空时可用于中断;
+    static int probe(const std::string& url, const MediaProbeOptions& options, MediaInfo& info, std::atomic<bool>* _Nullable interrupt_requested = nullptr);
+    
+    // 本地文件返回文件路径(去除 file:// 前缀), 否则返回空字符串;
+    static std::string localPath(const std::string& url);
+};
+
+}
+
+#endif //FFAV_MediaProbe_hpp
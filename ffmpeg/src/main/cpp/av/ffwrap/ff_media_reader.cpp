@@ -79,9 +79,9 @@ private:
 
 namespace FFAV {
 
-static int interrupt_cb(void* ctx) {
-    std::atomic<bool>* interrupt_requested = static_cast<std::atomic<bool>*>(ctx);
-    bool shouldInterrupt = interrupt_requested->load(); // 是否请求中断
+int MediaReader::interruptCallback(void* ctx) {
+    MediaReader* reader = static_cast<MediaReader*>(ctx);
+    bool shouldInterrupt = reader->isInterrupted(); // 是否请求中断
     return shouldInterrupt ? 1 : 0; // 1 中断, 0 继续;
 }
 
@@ -89,13 +89,13 @@ MediaReader::MediaReader() = default;
 
 MediaReader::~MediaReader() { release(); }
 
-int MediaReader::open(const std::string& url, const std::map<std::string, std::string>& http_options) {
+int MediaReader::open(const std::string& url, const std::map<std::string, std::string>& http_options, bool find_stream_info) {
     _fmt_ctx = avformat_alloc_context();
     if ( _fmt_ctx == nullptr ) {
         return AVERROR(ENOMEM);
     }
 
-    _fmt_ctx->interrupt_callback = { interrupt_cb, &_interrupt_requested };
+    _fmt_ctx->interrupt_callback = { interruptCallback, this };
 
     AVDictionary *options = nullptr;
     for ( auto pair: http_options ) {
@@ -109,13 +109,15 @@ int MediaReader::open(const std::string& url, const std::map<std::string, std::s
         return ret;
     }
      
-    if ( _interrupt_requested.load() ) {
+    if ( isInterrupted() ) {
         return AVERROR_EXIT;
     }
 
-    ret = avformat_find_stream_info(_fmt_ctx, nullptr);
-    if ( ret < 0 ) {
-        return  ret;
+    if ( find_stream_info ) {
+        ret = avformat_find_stream_info(_fmt_ctx, nullptr);
+        if ( ret < 0 ) {
+            return  ret;
+        }
     }
     
     // 遍历流
@@ -189,12 +191,32 @@ StreamProvider* MediaReader::getStreamProvider() {
     return _stream_provider;
 }
 
+int64_t MediaReader::getDuration() {
+    return _fmt_ctx ? _fmt_ctx->duration : AV_NOPTS_VALUE;
+}
+
+int64_t MediaReader::getStartTime() {
+    return _fmt_ctx ? _fmt_ctx->start_time : AV_NOPTS_VALUE;
+}
+
+int64_t MediaReader::getBitRate() {
+    return _fmt_ctx ? _fmt_ctx->bit_rate : 0;
+}
+
+const char* _Nullable MediaReader::getFormatName() {
+    return _fmt_ctx && _fmt_ctx->iformat ? _fmt_ctx->iformat->name : nullptr;
+}
+
+AVDictionary* _Nullable MediaReader::getMetadata() {
+    return _fmt_ctx ? _fmt_ctx->metadata : nullptr;
+}
+
 int MediaReader::readPacket(AVPacket* _Nonnull pkt) {
     if ( _fmt_ctx == nullptr ) {
         throw_error("MediaReader::readPacket - AVFormatContext is not initialized");
     }
 
-    if ( _interrupt_requested.load() ) {
+    if ( isInterrupted() ) {
         return AVERROR_EXIT;
     }
 
@@ -206,7 +228,7 @@ int MediaReader::seek(int64_t timestamp, int stream_index, int flags) {
         throw_error("MediaReader::seek - AVFormatContext is not initialized");
     }
     
-    if ( _interrupt_requested.load() ) {
+    if ( isInterrupted() ) {
         return AVERROR_EXIT;
     }
 
@@ -218,6 +240,14 @@ void MediaReader::setInterrupted() {
     _interrupt_requested.store(true);
 }
 
+void MediaReader::setInterruptFlag(std::atomic<bool>* interrupt_flag) {
+    _interrupt_flag = interrupt_flag;
+}
+
+bool MediaReader::isInterrupted() {
+    return _interrupt_requested.load() || (_interrupt_flag && _interrupt_flag->load());
+}
+
 void MediaReader::release() {
     setInterrupted();
 
@@ -25,6 +25,7 @@
 
 #include <string>
 #include <map>
+#include <atomic>
 #include "ff_types.hpp"
 #include "ff_stream_provider.hpp"
 
@@ -39,7 +40,8 @@ public:
     ~MediaReader();
 
     // 打开媒体文件
-    int open(const std::string& url, const std::map<std::string, std::string>& http_options = {});
+    // find_stream_info: 是否调用 avformat_find_stream_info 读取数据探测流信息; 容器头部信息足够时可跳过以减少 io;
+    int open(const std::string& url, const std::map<std::string, std::string>& http_options = {}, bool find_stream_info = true);
     
     // 请在媒体文件打开成功后获取;
     // 获取流的数量
@@ -62,6 +64,14 @@ public:
     // 请在媒体文件打开成功后获取;
     StreamProvider* getStreamProvider();
     
+    // 请在媒体文件打开成功后获取;
+    // 容器信息; 时间单位为 AV_TIME_BASE, 未知时为 AV_NOPTS_VALUE;
+    int64_t getDuration();
+    int64_t getStartTime();
+    int64_t getBitRate();
+    const char* _Nullable getFormatName();
+    AVDictionary* _Nullable getMetadata();
+    
     // 读取下一帧
     int readPacket(AVPacket* _Nonnull pkt);
 
@@ -80,6 +90,13 @@ public:
 
     void setInterrupted();
     
+    // 外部的中断标记, 请在 open 之前设置; 与 setInterrupted 任一生效即中断打开及读取;
+    void setInterruptFlag(std::atomic<bool>* _Nullable interrupt_flag);
+    
+private:
+    bool isInterrupted();
+    static int interruptCallback(void* ctx);
+    
 private:
     void release();
     
@@ -87,6 +104,7 @@ private:
     AVFormatContext* _Nullable _fmt_ctx = nullptr;     // AVFormatContext 用于管理媒体文件
     StreamProviderImpl* _Nullable _stream_provider = nullptr;
     std::atomic<bool> _interrupt_requested { false };  // 请求读取中断
+    std::atomic<bool>* _Nullable _interrupt_flag = nullptr;  // 外部的中断标记
 };
 
 }
@@ -0,0 +1,187 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/24.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "ff_media_scanner.hpp"
+#include "ff_includes.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <dirent.h>
+#include <sys/stat.h>
+
+namespace FFAV {
+
+static bool match_extension(const std::string& name, const std::vector<std::string>& extensions) {
+    if ( extensions.empty() ) return true;
+    size_t dot = name.rfind('.');
+    if ( dot == std::string::npos ) return false;
+    std::string ext = name.substr(dot + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+    return std::find(extensions.begin(), extensions.end(), ext) != extensions.end();
+}
+
+// 已扫描的目录, 以 (st_dev, st_ino) 标识; 符号链接指向已扫描的目录(如 a/loop -> ..)时跳过, 避免循环递归;
+struct DirId {
+    dev_t dev;
+    ino_t ino;
+    bool operator==(const DirId& other) const { return dev == other.dev && ino == other.ino; }
+};
+
+struct DirIdHash {
+    size_t operator()(const DirId& id) const { return std::hash<uint64_t>()(static_cast<uint64_t>(id.dev) * 1000003u ^ static_cast<uint64_t>(id.ino)); }
+};
+
+using VisitedDirs = std::unordered_set<DirId, DirIdHash>;
+
+static void collect_dir(const std::string& dir, const MediaScanner::Options& options, std::vector<std::string>& urls, VisitedDirs& visited) {
+    DIR* d = opendir(dir.c_str());
+    if ( d == nullptr ) return;
+    
+    struct stat dir_info;
+    if ( fstat(dirfd(d), &dir_info) != 0 || !visited.insert(DirId { dir_info.st_dev, dir_info.st_ino }).second ) {
+        closedir(d);
+        return;
+    }
+    
+    std::vector<std::string> sub_dirs;
+    struct dirent* entry;
+    while ( (entry = readdir(d)) != nullptr ) {
+        const char* name = entry->d_name;
+        if ( name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')) ) continue;
+        
+        std::string path = dir.back() == '/' ? dir + name : dir + "/" + name;
+        unsigned char type = entry->d_type;
+        if ( type == DT_UNKNOWN || type == DT_LNK ) {
+            struct stat info;
+            if ( stat(path.c_str(), &info) != 0 ) continue;
+            type = S_ISDIR(info.st_mode) ? DT_DIR : S_ISREG(info.st_mode) ? DT_REG : DT_UNKNOWN;
+            if ( type == DT_DIR && visited.count(DirId { info.st_dev, info.st_ino }) ) continue;
+        }
+        
+        if ( type == DT_DIR ) {
+            if ( options.recursive ) sub_dirs.push_back(std::move(path));
+        }
+        else if ( type == DT_REG && match_extension(name, options.extensions) ) {
+            urls.push_back(std::move(path));
+        }
+    }
+    closedir(d);
+    
+    for ( auto& sub_dir : sub_dirs ) {
+        collect_dir(sub_dir, options, urls, visited);
+    }
+}
+
+std::vector<std::string> MediaScanner::collect(const std::vector<std::string>& inputs, const Options& options) {
+    std::vector<std::string> urls;
+    VisitedDirs visited;
+    for ( auto& input : inputs ) {
+        std::string path = MediaProbe::localPath(input);
+        struct stat info;
+        if ( !path.empty() && stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode) ) {
+            collect_dir(path, options, urls, visited);
+        }
+        else {
+            urls.push_back(input);
+        }
+    }
+    return urls;
+}
+
+uint32_t MediaScanner::scan(const std::vector<std::string>& urls, const Options& options, const BatchCallback& callback, std::atomic<bool>* _Nullable cancel_requested) {
+    uint32_t total = static_cast<uint32_t>(urls.size());
+    if ( total == 0 ) return 0;
+    
+    int nb_workers = options.concurrency > 0 ? options.concurrency : static_cast<int>(std::thread::hardware_concurrency());
+    nb_workers = std::max(1, std::min(nb_workers, static_cast<int>(total)));
+    size_t batch_size = std::max<size_t>(options.batch_size, 1);
+    
+    std::atomic<uint32_t> next_index { 0 };
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::vector<Result> pending;
+    uint32_t completed = 0;
+    int nb_running = nb_workers;
+    
+    std::mutex callback_mtx; // 保证回调不会并发;
+    auto deliver = [&](std::unique_lock<std::mutex>& lock) {
+        std::vector<Result> batch;
+        batch.swap(pending);
+        uint32_t nb_completed = completed;
+        // 持有 mtx 时获取回调锁以保持批次顺序, 回调期间释放 mtx;
+        std::unique_lock<std::mutex> callback_lock(callback_mtx);
+        lock.unlock();
+        if ( !batch.empty() ) callback(std::move(batch), nb_completed, total);
+        callback_lock.unlock();
+        lock.lock();
+    };
+    
+    auto is_cancelled = [&] { return cancel_requested && cancel_requested->load(); };
+    
+    auto worker = [&] {
+        while ( !is_cancelled() ) {
+            uint32_t index = next_index.fetch_add(1);
+            if ( index >= total ) break;
+            
+            Result result;
+            result.url = urls[index];
+            result.ret = MediaProbe::probe(result.url, options.probe_options, result.info, cancel_requested);
+            
+            std::unique_lock<std::mutex> lock(mtx);
+            pending.push_back(std::move(result));
+            completed += 1;
+            if ( pending.size() >= batch_size ) {
+                deliver(lock);
+            }
+        }
+        
+        std::lock_guard<std::mutex> lock(mtx);
+        nb_running -= 1;
+        cv.notify_all();
+    };
+    
+    std::vector<std::thread> threads;
+    threads.reserve(nb_workers);
+    for ( int i = 0 ; i < nb_workers ; ++ i ) {
+        threads.emplace_back(worker);
+    }
+    
+    // 定时投递未达到 batch_size 的结果;
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        while ( nb_running > 0 ) {
+            cv.wait_for(lock, std::chrono::milliseconds(std::max(options.batch_interval_ms, 1)));
+            if ( !pending.empty() ) deliver(lock);
+        }
+        if ( !pending.empty() ) deliver(lock);
+    }
+    
+    for ( auto& thread : threads ) {
+        thread.join();
+    }
+    return completed;
+}
+
+}
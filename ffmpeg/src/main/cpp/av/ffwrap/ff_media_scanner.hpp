@@ -0,0 +1,68 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/24.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef FFAV_MediaScanner_hpp
+#define FFAV_MediaScanner_hpp
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+#include "ff_media_probe.hpp"
+
+namespace FFAV {
+
+/**
+ * 批量读取媒体信息;
+ *
+ * 在多个工作线程中并行调用 MediaProbe::probe, 结果按批次回调;
+ */
+class MediaScanner {
+public:
+    struct Options {
+        MediaProbeOptions probe_options;
+        int concurrency = 0;            // 工作线程数量, 0 表示使用 CPU 核心数;
+        size_t batch_size = 32;         // 每批最多的结果数量;
+        int batch_interval_ms = 200;    // 未达到 batch_size 时, 结果最多等待的时长;
+        bool recursive = true;          // 是否扫描子目录;
+        std::vector<std::string> extensions; // 扫描目录时按后缀过滤(小写, 不含 '.'), 为空时不过滤;
+    };
+    
+    struct Result {
+        std::string url;
+        int ret;        // 0 成功, 否则为 ffmpeg 错误码;
+        MediaInfo info;
+    };
+    
+    // 在工作线程中回调; 同一时间只有一个线程回调;
+    using BatchCallback = std::function<void(std::vector<Result>&& batch, uint32_t completed, uint32_t total)>;
+    
+    // 展开目录, 返回待扫描的文件列表; 非目录的路径或 url 原样保留;
+    static std::vector<std::string> collect(const std::vector<std::string>& inputs, const Options& options);
+    
+    // 阻塞执行直到全部完成或取消; 返回已完成的数量;
+    static uint32_t scan(const std::vector<std::string>& urls, const Options& options, const BatchCallback& callback, std::atomic<bool>* _Nullable cancel_requested = nullptr);
+};
+
+}
+
+#endif //FFAV_MediaScanner_hpp
@@ -25,6 +25,7 @@
 #include "ff_media_reader.hpp"
 #include "ff_includes.hpp"
 #include "ff_throw.hpp"
+#include "av/utils/thread_budget.h"
 
 namespace FFAV {
 
@@ -44,6 +45,7 @@ void PacketReader::prepare(const std::string &url, const std::map<std::string, s
     
     _url = url;
     _http_options = http_options;
+    _budget_job = ThreadBudget::currentJob();
     
     // 启动读取线程
     _read_thread = std::make_unique<std::thread>(&PacketReader::ReadLoop, this);
@@ -149,6 +151,7 @@ AVStream* PacketReader::getFirstStream(AVMediaType mediaType) {
 }
 
 void PacketReader::ReadLoop() {
+    ThreadBudget::ThreadScope budget_scope(_budget_job, NATIVE_THREAD_READER);
     int ret = 0;
     {
         std::unique_lock<std::mutex> lock(_mtx);
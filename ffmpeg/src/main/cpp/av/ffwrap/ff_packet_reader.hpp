@@ -83,6 +83,7 @@ private:
     };
     
     std::unique_ptr<std::thread> _read_thread;
+    uint64_t _budget_job { 0 }; // 读取线程所属的任务(ThreadBudget);
     std::mutex _mtx;
     std::condition_variable _cv;
     
@@ -0,0 +1,318 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/30.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "ff_parallel_transcoder.hpp"
+#include "ff_media_reader.hpp"
+#include "ff_includes.hpp"
+#include "fftools/interaction/mem_io.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace FFAV {
+
+// 分段前后多编码的时长, 用于编码器预热及边界处的重叠窗口;
+static constexpr int64_t PARALLEL_PREROLL_US = 200000;
+
+static int interrupt_cb(void* ctx) {
+    std::atomic<bool>* interrupt_requested = static_cast<std::atomic<bool>*>(ctx);
+    return interrupt_requested && interrupt_requested->load() ? 1 : 0;
+}
+
+static const AVCodec* find_audio_encoder(const std::string& output, const ParallelTranscoder::Options& options) {
+    if ( !options.encoder_name.empty() ) {
+        return avcodec_find_encoder_by_name(options.encoder_name.c_str());
+    }
+    const AVOutputFormat* oformat = av_guess_format(options.output_format.empty() ? nullptr : options.output_format.c_str(), output.c_str(), nullptr);
+    if ( oformat == nullptr ) {
+        return nullptr;
+    }
+    AVCodecID codec_id = av_guess_codec(oformat, nullptr, output.c_str(), nullptr, AVMEDIA_TYPE_AUDIO);
+    return codec_id != AV_CODEC_ID_NONE ? avcodec_find_encoder(codec_id) : nullptr;
+}
+
+static int select_sample_rate(const AVCodec* codec, int preferred_sample_rate) {
+    const int* rates = codec->supported_samplerates;
+    if ( !rates || rates[0] == 0 ) {
+        return preferred_sample_rate;
+    }
+    int best_sample_rate = rates[0];
+    for ( int idx = 0 ; rates[idx] != 0 ; ++ idx ) {
+        if ( rates[idx] == preferred_sample_rate ) return rates[idx];
+        if ( abs(rates[idx] - preferred_sample_rate) < abs(best_sample_rate - preferred_sample_rate) ) best_sample_rate = rates[idx];
+    }
+    return best_sample_rate;
+}
+
+// 打开一次编码器以获取帧长及开头插入的采样数;
+static int probe_encoder(const AVCodec* codec, int sample_rate, int nb_channels, AVSampleFormat sample_fmt, int& frame_size, int& initial_padding) {
+    AVCodecContext* ctx = avcodec_alloc_context3(codec);
+    if ( ctx == nullptr ) {
+        return AVERROR(ENOMEM);
+    }
+    ctx->sample_rate = sample_rate;
+    ctx->time_base = { 1, sample_rate };
+    ctx->sample_fmt = codec->sample_fmts ? codec->sample_fmts[0] : sample_fmt;
+    ctx->strict_std_compliance = FF_COMPLIANCE_EXPERIMENTAL;
+    av_channel_layout_default(&ctx->ch_layout, nb_channels);
+    
+    int ret = avcodec_open2(ctx, codec, nullptr);
+    if ( ret == 0 ) {
+        bool variable_frame_size = codec->capabilities & AV_CODEC_CAP_VARIABLE_FRAME_SIZE;
+        frame_size = variable_frame_size ? 0 : ctx->frame_size;
+        initial_padding = ctx->initial_padding;
+    }
+    avcodec_free_context(&ctx);
+    return ret;
+}
+
+int ParallelTranscoder::plan(const std::string& input, const std::string& output, const Options& options, Plan& plan) {
+    MediaReader reader;
+    int ret = reader.open(input);
+    if ( ret < 0 ) {
+        return ret;
+    }
+    
+    AVStream* stream = reader.getBestStream(AVMEDIA_TYPE_AUDIO);
+    if ( stream == nullptr ) {
+        return AVERROR_STREAM_NOT_FOUND;
+    }
+    
+    AVCodecParameters* codecpar = stream->codecpar;
+    int64_t duration_us = stream->duration != AV_NOPTS_VALUE ? av_rescale_q(stream->duration, stream->time_base, AV_TIME_BASE_Q) : reader.getDuration();
+    int nb_channels = options.nb_channels > 0 ? options.nb_channels : codecpar->ch_layout.nb_channels;
+    int sample_rate = options.sample_rate > 0 ? options.sample_rate : codecpar->sample_rate;
+    
+    plan.segments.clear();
+    plan.sample_rate = sample_rate;
+    plan.frame_size = 0;
+    plan.initial_padding = 0;
+    
+    const AVCodec* codec = find_audio_encoder(output, options);
+    if ( codec && sample_rate > 0 && nb_channels > 0 ) {
+        plan.sample_rate = select_sample_rate(codec, sample_rate);
+        if ( probe_encoder(codec, plan.sample_rate, nb_channels, static_cast<AVSampleFormat>(codecpar->format), plan.frame_size, plan.initial_padding) < 0 ) {
+            plan.frame_size = 0;
+            plan.initial_padding = 0;
+        }
+    }
+    
+    // 帧长不固定时各段的数据包无法对齐, 不分段;
+    int nb_segments = std::max(1, options.segments);
+    if ( plan.frame_size <= 0 || duration_us == AV_NOPTS_VALUE || duration_us <= 0 ) {
+        nb_segments = 1;
+    }
+    else if ( options.segment_duration_us > 0 ) {
+        nb_segments = static_cast<int>(std::max<int64_t>(1, (duration_us + options.segment_duration_us - 1) / options.segment_duration_us));
+    }
+    else if ( options.min_segment_duration_us > 0 ) {
+        nb_segments = static_cast<int>(std::min<int64_t>(nb_segments, std::max<int64_t>(1, duration_us / options.min_segment_duration_us)));
+    }
+    
+    if ( nb_segments == 1 ) {
+        plan.segments.push_back({ 0, 0, 0, INT64_MIN, INT64_MAX });
+        return 0;
+    }
+    
+    // 分段边界及预热范围均按帧对齐, 各段输出的数据包位于同一网格上, 拼接时既无空隙也不重叠;
+    int64_t frame_size = plan.frame_size;
+    int64_t nb_frames = av_rescale(duration_us, plan.sample_rate, AV_TIME_BASE) / frame_size;
+    int64_t segment_frames = (nb_frames + nb_segments - 1) / nb_segments;
+    int64_t preroll_frames = std::max<int64_t>(4, (av_rescale(PARALLEL_PREROLL_US, plan.sample_rate, AV_TIME_BASE) + frame_size - 1) / frame_size);
+    for ( int i = 0 ; i < nb_segments ; ++ i ) {
+        int64_t keep_start = i * segment_frames * frame_size;
+        int64_t keep_end = (i + 1) * segment_frames * frame_size;
+        bool is_last = i == nb_segments - 1;
+        
+        Segment segment;
+        segment.read_start_sample = std::max<int64_t>(0, keep_start - preroll_frames * frame_size);
+        segment.read_start_us = av_rescale(segment.read_start_sample, AV_TIME_BASE, plan.sample_rate);
+        segment.read_duration_us = is_last ? 0 : av_rescale_rnd(keep_end + preroll_frames * frame_size - segment.read_start_sample, AV_TIME_BASE, plan.sample_rate, AV_ROUND_UP);
+        segment.keep_start_sample = i == 0 ? INT64_MIN : keep_start;
+        segment.keep_end_sample = is_last ? INT64_MAX : keep_end;
+        plan.segments.push_back(segment);
+    }
+    return 0;
+}
+
+static int open_segment(AVFormatContext** ctx, const std::string& url, std::atomic<bool>* interrupt_requested) {
+    AVFormatContext* fmt_ctx = avformat_alloc_context();
+    if ( fmt_ctx == nullptr ) {
+        return AVERROR(ENOMEM);
+    }
+    fmt_ctx->interrupt_callback = { interrupt_cb, interrupt_requested };
+    
+    int ret = 0;
+    if ( native_mem_io_is_url(url.c_str()) ) {
+        ret = native_mem_io_open(&fmt_ctx->pb, url.c_str(), AVIO_FLAG_READ, &fmt_ctx->interrupt_callback);
+        if ( ret < 0 ) {
+            avformat_free_context(fmt_ctx);
+            return ret;
+        }
+        fmt_ctx->flags |= AVFMT_FLAG_CUSTOM_IO;
+    }
+    
+    AVIOContext* pb = fmt_ctx->pb;
+    ret = avformat_open_input(&fmt_ctx, url.c_str(), nullptr, nullptr);
+    if ( ret < 0 ) {
+        // 打开失败时 fmt_ctx 已被释放, 自定义的 pb 需自行关闭;
+        if ( pb ) native_mem_io_closep(&pb);
+        return ret;
+    }
+    *ctx = fmt_ctx;
+    return 0;
+}
+
+static void close_segment(AVFormatContext** ctx) {
+    AVIOContext* pb = (*ctx)->flags & AVFMT_FLAG_CUSTOM_IO ? (*ctx)->pb : nullptr;
+    avformat_close_input(ctx);
+    if ( pb ) native_mem_io_closep(&pb);
+}
+
+static int open_output(AVFormatContext** ctx, const std::string& url, const std::string& format, AVCodecParameters* codecpar, AVDictionary* metadata, const ParallelTranscoder::Plan& plan, std::atomic<bool>* interrupt_requested) {
+    AVFormatContext* fmt_ctx = nullptr;
+    int ret = avformat_alloc_output_context2(&fmt_ctx, nullptr, format.empty() ? nullptr : format.c_str(), url.c_str());
+    if ( ret < 0 ) {
+        return ret;
+    }
+    fmt_ctx->interrupt_callback = { interrupt_cb, interrupt_requested };
+    
+    AVStream* stream = avformat_new_stream(fmt_ctx, nullptr);
+    if ( stream == nullptr ) {
+        avformat_free_context(fmt_ctx);
+        return AVERROR(ENOMEM);
+    }
+    avcodec_parameters_copy(stream->codecpar, codecpar);
+    stream->codecpar->codec_tag = 0;
+    stream->codecpar->initial_padding = plan.initial_padding;
+    stream->time_base = { 1, plan.sample_rate };
+    av_dict_copy(&fmt_ctx->metadata, metadata, 0);
+    
+    if ( native_mem_io_is_url(url.c_str()) ) {
+        ret = native_mem_io_open(&fmt_ctx->pb, url.c_str(), AVIO_FLAG_WRITE, &fmt_ctx->interrupt_callback);
+    }
+    else if ( !(fmt_ctx->oformat->flags & AVFMT_NOFILE) ) {
+        ret = avio_open2(&fmt_ctx->pb, url.c_str(), AVIO_FLAG_WRITE, &fmt_ctx->interrupt_callback, nullptr);
+    }
+    if ( ret >= 0 ) {
+        ret = avformat_write_header(fmt_ctx, nullptr);
+    }
+    *ctx = fmt_ctx;
+    return ret < 0 ? ret : 0;
+}
+
+static void close_output(AVFormatContext** ctx, const std::string& url) {
+    AVFormatContext* fmt_ctx = *ctx;
+    if ( fmt_ctx == nullptr ) {
+        return;
+    }
+    if ( native_mem_io_is_url(url.c_str()) ) {
+        native_mem_io_closep(&fmt_ctx->pb);
+    }
+    else if ( !(fmt_ctx->oformat->flags & AVFMT_NOFILE) ) {
+        avio_closep(&fmt_ctx->pb);
+    }
+    avformat_free_context(fmt_ctx);
+    *ctx = nullptr;
+}
+
+int ParallelTranscoder::stitch(const std::vector<std::string>& segment_urls, const Plan& plan, const std::string& output, const std::string& output_format, std::atomic<bool>* interrupt_requested) {
+    if ( segment_urls.size() != plan.segments.size() || segment_urls.empty() || plan.sample_rate <= 0 ) {
+        return AVERROR(EINVAL);
+    }
+    
+    AVRational sample_tb = { 1, plan.sample_rate };
+    AVFormatContext* out_ctx = nullptr;
+    AVPacket* pkt = av_packet_alloc();
+    int64_t next_sample = INT64_MIN; // 下一个数据包的最小起始位置, 保证时间戳递增;
+    int ret = pkt ? 0 : AVERROR(ENOMEM);
+    bool header_written = false;
+    
+    for ( size_t i = 0 ; ret >= 0 && i < segment_urls.size() ; ++ i ) {
+        const Segment& segment = plan.segments[i];
+        AVFormatContext* in_ctx = nullptr;
+        ret = open_segment(&in_ctx, segment_urls[i], interrupt_requested);
+        if ( ret < 0 ) {
+            break;
+        }
+        
+        int stream_index = av_find_best_stream(in_ctx, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+        if ( stream_index < 0 ) {
+            ret = stream_index;
+            close_segment(&in_ctx);
+            break;
+        }
+        AVStream* in_stream = in_ctx->streams[stream_index];
+        
+        if ( out_ctx == nullptr ) {
+            ret = open_output(&out_ctx, output, output_format, in_stream->codecpar, in_ctx->metadata, plan, interrupt_requested);
+            header_written = ret >= 0;
+            if ( ret < 0 ) {
+                close_segment(&in_ctx);
+                break;
+            }
+        }
+        AVStream* out_stream = out_ctx->streams[0];
+        
+        // 分段输出的第一个数据包从 read_start_sample - initial_padding 开始, 容器可能整体平移时间戳, 因此按相对第一个数据包的偏移计算;
+        int64_t first_ts = AV_NOPTS_VALUE;
+        while ( (ret = av_read_frame(in_ctx, pkt)) >= 0 ) {
+            int64_t ts = pkt->pts != AV_NOPTS_VALUE ? pkt->pts : pkt->dts;
+            if ( pkt->stream_index != stream_index || ts == AV_NOPTS_VALUE ) {
+                av_packet_unref(pkt);
+                continue;
+            }
+            if ( first_ts == AV_NOPTS_VALUE ) first_ts = ts;
+            
+            int64_t start_sample = segment.read_start_sample - plan.initial_padding + av_rescale_q(ts - first_ts, in_stream->time_base, sample_tb);
+            if ( start_sample < segment.keep_start_sample || start_sample >= segment.keep_end_sample || start_sample < next_sample ) {
+                av_packet_unref(pkt);
+                if ( start_sample >= segment.keep_end_sample ) break;
+                continue;
+            }
+            
+            int64_t duration = av_rescale_q(pkt->duration, in_stream->time_base, sample_tb);
+            next_sample = start_sample + std::max<int64_t>(1, duration);
+            pkt->pts = pkt->dts = start_sample;
+            pkt->duration = duration;
+            pkt->stream_index = 0;
+            pkt->pos = -1;
+            av_packet_rescale_ts(pkt, sample_tb, out_stream->time_base);
+            ret = av_write_frame(out_ctx, pkt);
+            av_packet_unref(pkt);
+            if ( ret < 0 ) {
+                break;
+            }
+        }
+        if ( ret == AVERROR_EOF ) ret = 0;
+        if ( ret >= 0 && interrupt_requested && interrupt_requested->load() ) ret = AVERROR_EXIT;
+        close_segment(&in_ctx);
+    }
+    
+    if ( ret >= 0 && header_written ) {
+        ret = av_write_trailer(out_ctx);
+    }
+    close_output(&out_ctx, output);
+    av_packet_free(&pkt);
+    return ret;
+}
+
+}
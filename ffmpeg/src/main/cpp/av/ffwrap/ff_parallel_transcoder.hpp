@@ -0,0 +1,76 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/30.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef FFAV_ParallelTranscoder_hpp
+#define FFAV_ParallelTranscoder_hpp
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace FFAV {
+
+/**
+ * 单个输入的分段并行转码(仅音频);
+ *
+ * plan 按编码器的帧长将输入切分为多段, 各段由独立的 ffmpeg 命令同时编码; 每段额外向前/向后多编码一小段(preroll/postroll),
+ * 使编码器在分段边界处的状态与整体编码时接近; stitch 按采样位置裁掉多余的数据包, 将各段无损拼接为一个输出;
+ * 编码器开头插入的采样(initial_padding)只保留第一段的, 结尾的填充只保留最后一段的;
+ */
+class ParallelTranscoder {
+public:
+    struct Options {
+        int segments = 0;                       // 分段数量;
+        int64_t min_segment_duration_us = 10 * 1000000LL; // 每段的最短时长, 输入过短时减少分段;
+        int64_t segment_duration_us = 0;        // 大于 0 时按该时长分段, 忽略 segments 及 min_segment_duration_us;
+        std::string encoder_name;               // 编码器名称, 为空时根据输出格式推断;
+        std::string output_format;              // 输出格式, 为空时根据输出地址推断;
+        int sample_rate = 0;                    // 输出采样率, 0 表示与输入一致;
+        int nb_channels = 0;                    // 输出声道数, 0 表示与输入一致;
+    };
+    
+    struct Segment {
+        int64_t read_start_us;      // 分段命令的 -ss;
+        int64_t read_duration_us;   // 分段命令的 -t, 0 表示读到结尾;
+        int64_t read_start_sample;  // read_start_us 对应的采样位置;
+        int64_t keep_start_sample;  // 拼接时保留 [keep_start_sample, keep_end_sample) 内开始的数据包;
+        int64_t keep_end_sample;
+    };
+    
+    struct Plan {
+        std::vector<Segment> segments;  // 只有一段时无需拼接, 直接转码到输出即可;
+        int sample_rate = 0;            // 输出采样率, 采样位置均以此为单位;
+        int frame_size = 0;             // 编码器每帧的采样数;
+        int initial_padding = 0;        // 编码器在开头插入的采样数;
+    };
+    
+    // 读取输入及编码器信息生成分段; 编码器帧长不固定或无法确定时只生成一段;
+    static int plan(const std::string& input, const std::string& output, const Options& options, Plan& plan);
+    
+    // 按 plan 拼接各段的输出(需包含第一条音频流, 建议使用 nut 格式以保留精确的时间戳);
+    static int stitch(const std::vector<std::string>& segment_urls, const Plan& plan, const std::string& output, const std::string& output_format, std::atomic<bool>* _Nullable interrupt_requested = nullptr);
+};
+
+}
+
+#endif //FFAV_ParallelTranscoder_hpp
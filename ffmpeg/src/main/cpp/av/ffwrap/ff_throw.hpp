@@ -24,6 +24,8 @@
 #ifndef FFAV_Throw_hpp
 #define FFAV_Throw_hpp
 
+#include <cstdarg>
+#include <cstdio>
 #include <stdexcept>
 #include <string>
 
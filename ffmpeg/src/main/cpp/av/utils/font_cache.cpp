@@ -0,0 +1,265 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/9/2.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "font_cache.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include <fontconfig/fontconfig.h>
+
+namespace FFAV {
+
+// 使用字体的滤镜; 只做粗略匹配, 误判时仅多构建一次索引;
+static const char* const FONT_FILTERS[] = { "subtitles", "drawtext", "ass" };
+
+enum class FontCacheState {
+    IDLE,
+    BUILDING,
+    READY,
+};
+
+static std::mutex font_cache_mutex;
+static std::condition_variable font_cache_cond;
+static FontCacheState font_cache_state = FontCacheState::IDLE;
+// 常驻的配置, 持有对缓存文件映射的引用, 滤镜内创建的配置打开相同的缓存文件时直接复用映射;
+static FcConfig* font_cache_config = nullptr;
+static FontCache::Stats font_cache_stats = { 0 };
+// invalidate 时递增, 构建完成时与开始时不一致则结果作废;
+static uint64_t font_cache_generation = 0;
+// 正在执行的使用字体的命令数; 被丢弃的配置在其为 0 时释放;
+static int font_cache_users = 0;
+static std::vector<FcConfig*> font_cache_retired;
+
+static std::mutex font_config_mutex;
+static bool font_config_ready = false;
+static bool font_config_env_ready = false;
+
+static const char* const FONT_CONFIG_ROOT_DIR = "/data/storage/el2/base/files/sj_ff_av";
+
+// 在 sj_ff_av 目录中生成默认的配置; 成功时返回 true;
+static bool WriteDefaultConfig() {
+    const char* root_dir = FONT_CONFIG_ROOT_DIR;
+    struct stat info;
+    if ( stat(root_dir, &info) != 0 ) {
+        if ( mkdir(root_dir, 0755) != 0 ) {
+            return false;
+        }
+    }
+
+    // cachedir: 字体目录的扫描结果持久化在应用目录中, 系统默认的缓存目录不可写, 否则每次构建字体索引都需要重新扫描;
+    std::string font_cfg = std::string(
+            "<?xml version=\"1.0\"?>"
+            "<!DOCTYPE fontconfig SYSTEM \"fonts.dtd\">"
+            "<fontconfig>"
+                "<dir>/system/fonts</dir>"
+                "<cachedir>") + root_dir + "/fontconfig</cachedir>"
+            "</fontconfig>";
+
+    // 与已有的配置一致时直接使用, 旧版本写入的配置缺少 cachedir, 需要重写;
+    std::string font_cfg_default_file_path = std::string(root_dir) + "/fonts.conf";
+    FILE* file = fopen(font_cfg_default_file_path.c_str(), "r");
+    if ( file ) {
+        std::string content(font_cfg.size() + 1, '\0');
+        size_t size = fread(&content[0], 1, content.size(), file);
+        fclose(file);
+        content.resize(size);
+        if ( content == font_cfg ) {
+            return true;
+        }
+    }
+
+    file = fopen(font_cfg_default_file_path.c_str(), "w");
+    if ( !file ) {
+        return false;
+    }
+
+    if ( fputs(font_cfg.c_str(), file) < 0 ) {
+        fclose(file);
+        return false;
+    }
+
+    fclose(file);
+    return true;
+}
+
+void FontCache::initEnv() {
+    std::lock_guard<std::mutex> lock(font_config_mutex);
+    // 模块在多个 env 中加载时只设置一次, 之后工作线程可能已在执行命令, 也不能覆盖 setConfigDir 指定的目录;
+    if ( font_config_env_ready ) {
+        return;
+    }
+    setenv("FONTCONFIG_PATH", FONT_CONFIG_ROOT_DIR, true);
+    font_config_env_ready = true;
+}
+
+void FontCache::ensureConfig() {
+    std::lock_guard<std::mutex> lock(font_config_mutex);
+    if ( font_config_ready ) {
+        return;
+    }
+    
+    // 只写入配置文件, 不修改环境变量(工作线程中其他命令可能正在读取); 写入失败时(如目录暂不可用)不标记, 下次调用时重试;
+    if ( WriteDefaultConfig() ) {
+        font_config_ready = true;
+    }
+}
+
+void FontCache::setConfigDir(const std::string& dir) {
+    {
+        std::lock_guard<std::mutex> lock(font_config_mutex);
+        setenv("FONTCONFIG_PATH", dir.c_str(), true);
+        // 使用指定的目录, 不再生成默认配置;
+        font_config_ready = true;
+        font_config_env_ready = true;
+    }
+    invalidate();
+}
+
+// name 作为滤镜名出现在滤镜描述中, 即位于开头或 , ; ] 之后, 且其后为 = , ; [ 或结尾;
+static bool ContainsFilter(const char* descr, const char* name) {
+    size_t len = strlen(name);
+    for ( const char* p = strstr(descr, name) ; p ; p = strstr(p + 1, name) ) {
+        bool starts = p == descr || strchr(",;] \t", p[-1]);
+        bool ends = p[len] == '\0' || strchr("=,;[ \t", p[len]);
+        if ( starts && ends ) return true;
+    }
+    return false;
+}
+
+// 取出待释放的配置, 没有命令使用时才释放; 需持有 font_cache_mutex;
+static std::vector<FcConfig*> TakeRetiredConfigs() {
+    std::vector<FcConfig*> configs;
+    if ( font_cache_users == 0 ) configs.swap(font_cache_retired);
+    return configs;
+}
+
+static void DestroyConfigs(const std::vector<FcConfig*>& configs) {
+    for ( FcConfig* config : configs ) FcConfigDestroy(config);
+}
+
+bool FontCache::isRequired(int argc, char** argv) {
+    for ( int i = 1 ; i < argc ; ++ i ) {
+        for ( const char* filter : FONT_FILTERS ) {
+            if ( ContainsFilter(argv[i], filter) ) return true;
+        }
+    }
+    return false;
+}
+
+void FontCache::prepare() {
+    std::unique_lock<std::mutex> lock(font_cache_mutex);
+    if ( font_cache_state == FontCacheState::BUILDING ) {
+        font_cache_stats.waits += 1;
+        font_cache_cond.wait(lock, [] { return font_cache_state != FontCacheState::BUILDING; });
+    }
+    // 构建失败或等待的构建被作废时, 由当前线程重新构建;
+    if ( font_cache_state != FontCacheState::IDLE ) {
+        return;
+    }
+    
+    font_cache_state = FontCacheState::BUILDING;
+    uint64_t generation = font_cache_generation;
+    lock.unlock();
+    
+    ensureConfig();
+    
+    // 加载 FONTCONFIG_PATH 中的配置并构建索引; 缓存文件不存在或已过期时扫描字体目录并写入缓存;
+    auto start = std::chrono::steady_clock::now();
+    FcConfig* config = FcInitLoadConfigAndFonts();
+    FcFontSet* fonts = config ? FcConfigGetFonts(config, FcSetSystem) : nullptr;
+    int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    
+    lock.lock();
+    font_cache_stats.build_time_ms = elapsed;
+    font_cache_stats.builds += 1;
+    if ( generation != font_cache_generation ) {
+        // 构建期间配置目录已变更, 结果作废, 下次 prepare 时按新的配置构建;
+        if ( config ) font_cache_retired.push_back(config);
+        font_cache_state = FontCacheState::IDLE;
+        font_cache_cond.notify_all();
+        std::vector<FcConfig*> retired = TakeRetiredConfigs();
+        lock.unlock();
+        DestroyConfigs(retired);
+        return;
+    }
+    font_cache_config = config;
+    // 构建失败时保持 IDLE, 滤镜仍可自行加载字体;
+    font_cache_state = config ? FontCacheState::READY : FontCacheState::IDLE;
+    font_cache_stats.ready = config != nullptr;
+    font_cache_stats.fonts = fonts ? static_cast<uint32_t>(fonts->nfont) : 0;
+    font_cache_cond.notify_all();
+}
+
+void FontCache::prepareAsync() {
+    std::thread([] { FontCache::prepare(); }).detach();
+}
+
+void FontCache::invalidate() {
+    std::vector<FcConfig*> retired;
+    {
+        std::lock_guard<std::mutex> lock(font_cache_mutex);
+        font_cache_generation += 1;
+        if ( font_cache_config ) {
+            font_cache_retired.push_back(font_cache_config);
+            font_cache_config = nullptr;
+        }
+        // 正在构建时由构建线程处理;
+        if ( font_cache_state == FontCacheState::READY ) font_cache_state = FontCacheState::IDLE;
+        font_cache_stats.ready = false;
+        font_cache_stats.fonts = 0;
+        retired = TakeRetiredConfigs();
+    }
+    DestroyConfigs(retired);
+}
+
+FontCache::Stats FontCache::getStats() {
+    std::lock_guard<std::mutex> lock(font_cache_mutex);
+    return font_cache_stats;
+}
+
+FontCache::JobScope::JobScope(bool required): _required(required) {
+    if ( !_required ) return;
+    {
+        std::lock_guard<std::mutex> lock(font_cache_mutex);
+        font_cache_users += 1;
+    }
+    prepare();
+}
+
+FontCache::JobScope::~JobScope() {
+    if ( !_required ) return;
+    std::vector<FcConfig*> retired;
+    {
+        std::lock_guard<std::mutex> lock(font_cache_mutex);
+        font_cache_users -= 1;
+        retired = TakeRetiredConfigs();
+    }
+    DestroyConfigs(retired);
+}
+
+}
@@ -0,0 +1,83 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/9/2.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef FFAV_FontCache_hpp
+#define FFAV_FontCache_hpp
+
+#include <stdint.h>
+#include <string>
+
+namespace FFAV {
+
+/**
+ * 进程内共享的字体索引(fontconfig);
+ *
+ * 字体目录的扫描结果由 fontconfig 写入 sj_ff_av 目录中的缓存文件, 只在首次使用或系统字体变化时扫描, 之后只需映射缓存文件;
+ * 构建后常驻一份配置, 缓存文件在进程内只映射一次, 并发执行的 subtitles/ass/drawtext 滤镜打开字体时复用同一份只读数据;
+ */
+class FontCache final {
+public:
+    struct Stats {
+        bool ready;
+        uint32_t fonts;         // 索引中的字体数量;
+        int64_t build_time_ms;  // 最近一次构建(扫描或加载缓存)的耗时;
+        uint32_t builds;
+        uint32_t waits;         // 等待其他线程构建完成的次数;
+    };
+
+    // 将 FONTCONFIG_PATH 设置为 sj_ff_av 目录; 修改环境变量与其他线程读取之间存在竞争, 需在模块初始化时(工作线程启动前)调用一次;
+    static void initEnv();
+    // 未指定配置目录时在 sj_ff_av 目录中生成默认配置; 可在工作线程中调用, 不修改环境变量; 成功后不再访问文件系统;
+    static void ensureConfig();
+    // 指定 fontconfig 的配置目录(FONTCONFIG_PATH), 之后的命令按新的配置重新构建字体索引; 在 js 线程中调用, 请在执行命令前设置;
+    static void setConfigDir(const std::string& dir);
+    // 命令中是否使用了需要字体的滤镜;
+    static bool isRequired(int argc, char** argv);
+    // 构建字体索引, 已构建时立即返回; 多个线程同时调用时只构建一次, 其余线程等待构建完成;
+    static void prepare();
+    // 在后台线程中构建;
+    static void prepareAsync();
+    // 丢弃已构建的索引, 下次 prepare 时重新构建; 不等待正在进行的构建, 其结果作废; 旧索引在没有使用字体的命令执行时释放;
+    static void invalidate();
+    static Stats getStats();
+
+    // 使用字体的命令执行期间持有; required 为 true 时构建字体索引, 并在作用域内保留当前的索引;
+    class JobScope {
+    public:
+        explicit JobScope(bool required);
+        ~JobScope();
+        JobScope(const JobScope&) = delete;
+        JobScope& operator=(const JobScope&) = delete;
+    private:
+        bool _required;
+    };
+
+private:
+    FontCache() = delete;
+    ~FontCache() = delete;
+    FontCache(const FontCache&) = delete;
+    FontCache& operator=(const FontCache&) = delete;
+};
+
+}
+
+#endif //FFAV_FontCache_hpp
@@ -0,0 +1,261 @@
+/**
+    This file is part of @sj/ffmpeg.
+
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/20.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "job_scheduler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <pthread.h>
+
+namespace FFAV {
+
+// ffmpeg_main 的调用栈较深, 工作线程栈大小与 libuv 线程池保持一致;
+static constexpr size_t JOB_WORKER_STACK_SIZE = 8 * 1024 * 1024;
+
+static int64_t job_now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+class JobSchedulerImpl {
+public:
+    JobSchedulerImpl() {
+        unsigned int nb_cores = std::thread::hardware_concurrency();
+        _max_concurrent_jobs = std::max(2, static_cast<int>(nb_cores / 2));
+    }
+
+    void submit(JobScheduler::Job job, JobScheduler::Priority priority) {
+        if ( priority < JobScheduler::INTERACTIVE || priority > JobScheduler::BACKGROUND ) {
+            priority = JobScheduler::NORMAL;
+        }
+
+        std::lock_guard<std::mutex> lock(_mtx);
+        _queues[priority].push_back({ std::move(job), job_now_us() });
+        spawnWorkerIfNeeded();
+        _cv.notify_one();
+    }
+
+    void setWorkerInitializer(JobScheduler::Job initializer) {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _worker_initializer = std::move(initializer);
+    }
+
+    void setIdleCallback(JobScheduler::Job callback) {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _idle_callback = std::move(callback);
+    }
+
+    void prewarm(int count) {
+        std::lock_guard<std::mutex> lock(_mtx);
+        spawnWorkers(std::min(count, _max_concurrent_jobs));
+    }
+
+    void addExternalJobs(int count) {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _external_jobs = std::max(0, _external_jobs + count);
+        if ( count < 0 ) _cv.notify_all();
+    }
+
+    void setMaxConcurrentJobs(int count) {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _max_concurrent_jobs = std::max(1, count);
+        spawnWorkerIfNeeded();
+        _cv.notify_all();
+    }
+
+    int getMaxConcurrentJobs() {
+        std::lock_guard<std::mutex> lock(_mtx);
+        return _max_concurrent_jobs;
+    }
+
+    JobScheduler::Stats getStats() {
+        std::lock_guard<std::mutex> lock(_mtx);
+        JobScheduler::Stats stats;
+        stats.max_concurrent_jobs = _max_concurrent_jobs;
+        stats.workers = _nb_workers;
+        stats.running_jobs = _running_jobs + _external_jobs;
+        for ( int i = 0 ; i < JobScheduler::PriorityCount ; ++ i ) {
+            stats.queued_jobs[i] = static_cast<int>(_queues[i].size());
+        }
+        stats.completed_jobs = _completed_jobs;
+        stats.last_wait_time_us = _last_wait_time_us;
+        stats.avg_wait_time_us = _nb_dequeued_jobs > 0 ? _total_wait_time_us / static_cast<int64_t>(_nb_dequeued_jobs) : 0;
+        stats.max_wait_time_us = _max_wait_time_us;
+        return stats;
+    }
+
+private:
+    struct Entry {
+        JobScheduler::Job job;
+        int64_t enqueue_time_us;
+    };
+
+    std::mutex _mtx;
+    std::condition_variable _cv;
+    std::deque<Entry> _queues[JobScheduler::PriorityCount];
+
+    int _max_concurrent_jobs;
+    int _nb_workers { 0 };
+    JobScheduler::Job _worker_initializer;
+    JobScheduler::Job _idle_callback;
+    int _running_jobs { 0 };
+    int _external_jobs { 0 }; // 不占用工作线程;
+
+    uint64_t _completed_jobs { 0 };
+    uint64_t _nb_dequeued_jobs { 0 };
+    int64_t _total_wait_time_us { 0 };
+    int64_t _last_wait_time_us { 0 };
+    int64_t _max_wait_time_us { 0 };
+
+    bool hasQueuedJobs() {
+        for ( auto& queue : _queues ) {
+            if ( !queue.empty() ) return true;
+        }
+        return false;
+    }
+
+    // 按需创建工作线程, 线程数量不超过并发上限; 需在持有锁时调用;
+    void spawnWorkerIfNeeded() {
+        size_t nb_queued = 0;
+        for ( auto& queue : _queues ) nb_queued += queue.size();
+
+        int nb_idle_workers = _nb_workers - _running_jobs;
+        int nb_needed = static_cast<int>(nb_queued) - nb_idle_workers;
+        if ( nb_needed > 0 ) spawnWorkers(std::min(_nb_workers + nb_needed, _max_concurrent_jobs));
+    }
+
+    // 创建工作线程直到数量达到 count; 需在持有锁时调用;
+    void spawnWorkers(int count) {
+        while ( _nb_workers < count ) {
+            pthread_attr_t attr;
+            pthread_attr_init(&attr);
+            pthread_attr_setstacksize(&attr, JOB_WORKER_STACK_SIZE);
+            pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+            pthread_t tid;
+            int ret = pthread_create(&tid, &attr, JobSchedulerImpl::WorkerEntry, this);
+            pthread_attr_destroy(&attr);
+            if ( ret != 0 ) {
+                break;
+            }
+            _nb_workers += 1;
+        }
+    }
+
+    static void* WorkerEntry(void* ctx) {
+        pthread_setname_np(pthread_self(), "ff_job_worker");
+        JobSchedulerImpl* impl = static_cast<JobSchedulerImpl*>(ctx);
+        JobScheduler::Job initializer;
+        {
+            std::lock_guard<std::mutex> lock(impl->_mtx);
+            initializer = impl->_worker_initializer;
+        }
+        if ( initializer ) initializer();
+        impl->workerLoop();
+        return nullptr;
+    }
+
+    void workerLoop() {
+        std::unique_lock<std::mutex> lock(_mtx);
+        while ( true ) {
+            _cv.wait(lock, [this] { return _running_jobs + _external_jobs < _max_concurrent_jobs && hasQueuedJobs(); });
+
+            Entry entry;
+            for ( auto& queue : _queues ) {
+                if ( !queue.empty() ) {
+                    entry = std::move(queue.front());
+                    queue.pop_front();
+                    break;
+                }
+            }
+
+            int64_t wait_time_us = job_now_us() - entry.enqueue_time_us;
+            _nb_dequeued_jobs += 1;
+            _total_wait_time_us += wait_time_us;
+            _last_wait_time_us = wait_time_us;
+            _max_wait_time_us = std::max(_max_wait_time_us, wait_time_us);
+            _running_jobs += 1;
+
+            lock.unlock();
+            entry.job();
+            entry.job = nullptr;
+            lock.lock();
+
+            _running_jobs -= 1;
+            _completed_jobs += 1;
+            _cv.notify_one();
+
+            if ( _idle_callback && _running_jobs + _external_jobs == 0 && !hasQueuedJobs() ) {
+                JobScheduler::Job callback = _idle_callback;
+                lock.unlock();
+                callback();
+                lock.lock();
+            }
+        }
+    }
+};
+
+} // namespace FFAV
+
+
+namespace FFAV {
+
+// 工作线程常驻且已分离, 调度器随进程存在, 不做析构;
+static JobSchedulerImpl& SharedJobScheduler() {
+    static JobSchedulerImpl* instance = new JobSchedulerImpl();
+    return *instance;
+}
+
+void JobScheduler::submit(Job job, Priority priority) {
+    SharedJobScheduler().submit(std::move(job), priority);
+}
+
+void JobScheduler::addExternalJobs(int count) {
+    SharedJobScheduler().addExternalJobs(count);
+}
+
+void JobScheduler::setMaxConcurrentJobs(int count) {
+    SharedJobScheduler().setMaxConcurrentJobs(count);
+}
+
+int JobScheduler::getMaxConcurrentJobs() {
+    return SharedJobScheduler().getMaxConcurrentJobs();
+}
+
+void JobScheduler::setWorkerInitializer(Job initializer) {
+    SharedJobScheduler().setWorkerInitializer(std::move(initializer));
+}
+
+void JobScheduler::setIdleCallback(Job callback) {
+    SharedJobScheduler().setIdleCallback(std::move(callback));
+}
+
+void JobScheduler::prewarm(int count) {
+    SharedJobScheduler().prewarm(count);
+}
+
+JobScheduler::Stats JobScheduler::getStats() {
+    return SharedJobScheduler().getStats();
+}
+
+} // namespace FFAV
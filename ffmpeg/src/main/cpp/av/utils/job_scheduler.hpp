@@ -0,0 +1,90 @@
+/**
+    This file is part of @sj/ffmpeg.
+
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/20.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef FFAV_JobScheduler_hpp
+#define FFAV_JobScheduler_hpp
+
+#include <stdint.h>
+#include <functional>
+
+namespace FFAV {
+
+/**
+ * 进程内共享的任务调度器;
+ *
+ * 使用独立的工作线程执行耗时任务(如 ffmpeg_main), 避免占用 libuv 的 async work 线程池;
+ * 同时运行的任务数量受 maxConcurrentJobs 限制, 排队中的任务按优先级出队, 同优先级先进先出;
+ */
+class JobScheduler final {
+public:
+    enum Priority {
+        INTERACTIVE = 0,
+        NORMAL = 1,
+        BACKGROUND = 2,
+    };
+    static constexpr int PriorityCount = 3;
+
+    struct Stats {
+        int max_concurrent_jobs;
+        int workers;                        // 已创建的工作线程数量;
+        int running_jobs;
+        int queued_jobs[PriorityCount];     // 各优先级排队中的任务数量;
+        uint64_t completed_jobs;
+        int64_t last_wait_time_us;          // 最近一次出队的任务在队列中等待的时长;
+        int64_t avg_wait_time_us;
+        int64_t max_wait_time_us;
+    };
+
+    using Job = std::function<void()>;
+
+    // 提交任务; 任务在工作线程中执行;
+    static void submit(Job job, Priority priority = NORMAL);
+
+    // 设置工作线程启动时执行的初始化函数, 每个线程执行一次; 需在提交任务前设置;
+    static void setWorkerInitializer(Job initializer);
+    
+    // 设置调度器空闲(没有正在运行及排队的任务)时执行的函数, 在刚结束任务的工作线程中调用; 用于写入延迟保存的数据;
+    static void setIdleCallback(Job callback);
+    
+    // 预先创建工作线程(不超过并发上限)并完成初始化, 避免首批任务等待线程创建;
+    static void prewarm(int count);
+    
+    // 在调度器之外的线程中执行的任务(如流水线的其余阶段)计入正在运行的任务, 排队的任务按剩余的并发数执行;
+    // 不会等待, count < 0 时移除;
+    static void addExternalJobs(int count);
+
+    // 设置同时运行的任务数量上限, 最小为 1; 调小时正在运行的任务不受影响;
+    static void setMaxConcurrentJobs(int count);
+    static int getMaxConcurrentJobs();
+
+    static Stats getStats();
+
+private:
+    JobScheduler() = delete;
+    ~JobScheduler() = delete;
+    JobScheduler(const JobScheduler&) = delete;
+    JobScheduler& operator=(const JobScheduler&) = delete;
+};
+
+}
+
+#endif //FFAV_JobScheduler_hpp
@@ -0,0 +1,509 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/23.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "probe_cache.hpp"
+#include <cstdio>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace FFAV {
+
+static const char* const PROBE_CACHE_DIR = "/data/storage/el2/base/files/sj_ff_av";
+static const char* const PROBE_CACHE_FILE = "/data/storage/el2/base/files/sj_ff_av/probe_cache.bin";
+static const char* const PROBE_CACHE_TMP_FILE = "/data/storage/el2/base/files/sj_ff_av/probe_cache.bin.tmp";
+
+static constexpr uint32_t PROBE_CACHE_MAGIC = 0x43504A53; // "SJPC"
+static constexpr uint32_t PROBE_CACHE_VERSION = 1;
+static constexpr uint64_t PROBE_CACHE_DEFAULT_MAX_SIZE = 8 * 1024 * 1024;
+static constexpr size_t PROBE_CACHE_CONTENT_HASH_SIZE = 1024;
+
+static constexpr uint32_t ENTRY_FLAG_COMPLETE = 1 << 0;
+static constexpr uint32_t ENTRY_FLAG_CONTENT_HASH = 1 << 1;
+
+struct ProbeCacheFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t nb_entries;
+    uint32_t reserved;
+};
+
+struct ProbeCacheRecordHeader {
+    uint32_t record_size;   // 包含 header, path 及 info;
+    uint32_t path_len;
+    int64_t file_size;
+    int64_t mtime_ns;
+    uint64_t content_hash;
+    uint32_t flags;
+    uint32_t info_len;
+};
+
+// 文件头部的 FNV-1a 哈希;
+static bool content_hash(const std::string& path, uint64_t* hash) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if ( fd < 0 ) return false;
+    uint8_t buf[PROBE_CACHE_CONTENT_HASH_SIZE];
+    ssize_t len = ::read(fd, buf, sizeof(buf));
+    ::close(fd);
+    if ( len < 0 ) return false;
+    
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for ( ssize_t i = 0 ; i < len ; ++ i ) {
+        h ^= buf[i];
+        h *= 0x100000001b3ULL;
+    }
+    *hash = h;
+    return true;
+}
+
+static bool file_stat(const std::string& path, int64_t* file_size, int64_t* mtime_ns) {
+    struct stat info;
+    if ( stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode) ) {
+        return false;
+    }
+    *file_size = info.st_size;
+    *mtime_ns = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000LL + info.st_mtim.tv_nsec;
+    return true;
+}
+
+// MediaInfo 序列化;
+class ProbeCacheWriter {
+public:
+    ProbeCacheWriter(std::string& out): _out(out) { }
+    
+    void put(const void* data, size_t len) { _out.append(reinterpret_cast<const char*>(data), len); }
+    template<typename T> void put(T value) { put(&value, sizeof(value)); }
+    void put(const std::string& str) { put(static_cast<uint32_t>(str.size())); put(str.data(), str.size()); }
+    void put(const std::map<std::string, std::string>& dict) {
+        put(static_cast<uint32_t>(dict.size()));
+        for ( auto& pair : dict ) { put(pair.first); put(pair.second); }
+    }
+    
+private:
+    std::string& _out;
+};
+
+class ProbeCacheReader {
+public:
+    ProbeCacheReader(const uint8_t* data, size_t len): _data(data), _len(len) { }
+    
+    bool get(void* out, size_t len) {
+        if ( _len - _pos < len ) return false;
+        memcpy(out, _data + _pos, len);
+        _pos += len;
+        return true;
+    }
+    template<typename T> bool get(T* value) { return get(value, sizeof(T)); }
+    size_t remaining() const { return _len - _pos; }
+    bool get(std::string* str) {
+        uint32_t len;
+        if ( !get(&len) || _len - _pos < len ) return false;
+        str->assign(reinterpret_cast<const char*>(_data + _pos), len);
+        _pos += len;
+        return true;
+    }
+    bool get(std::map<std::string, std::string>* dict) {
+        uint32_t count;
+        if ( !get(&count) ) return false;
+        for ( uint32_t i = 0 ; i < count ; ++ i ) {
+            std::string key, value;
+            if ( !get(&key) || !get(&value) ) return false;
+            (*dict)[key] = std::move(value);
+        }
+        return true;
+    }
+    
+private:
+    const uint8_t* _data;
+    size_t _len;
+    size_t _pos { 0 };
+};
+
+static void serialize_media_info(const MediaInfo& info, std::string& out) {
+    ProbeCacheWriter w(out);
+    w.put(info.format_name);
+    w.put(info.duration);
+    w.put(info.start_time);
+    w.put(info.bit_rate);
+    w.put(info.metadata);
+    w.put(static_cast<uint32_t>(info.streams.size()));
+    for ( auto& stream : info.streams ) {
+        w.put(static_cast<int32_t>(stream.index));
+        w.put(static_cast<int32_t>(stream.media_type));
+        w.put(stream.codec_name);
+        w.put(stream.bit_rate);
+        w.put(stream.duration);
+        w.put(static_cast<int32_t>(stream.sample_rate));
+        w.put(static_cast<int32_t>(stream.nb_channels));
+        w.put(static_cast<int32_t>(stream.sample_format));
+        w.put(static_cast<int32_t>(stream.width));
+        w.put(static_cast<int32_t>(stream.height));
+        w.put(stream.frame_rate);
+        w.put(stream.metadata);
+    }
+}
+
+// 每个流的记录至少包含的字节数(字符串及字典为空时);
+static constexpr size_t PROBE_CACHE_MIN_STREAM_SIZE =
+    sizeof(int32_t) * 7 + sizeof(uint32_t) * 2 + sizeof(MediaStreamInfo::bit_rate) + sizeof(MediaStreamInfo::duration) + sizeof(MediaStreamInfo::frame_rate);
+
+static bool deserialize_media_info(const uint8_t* data, size_t len, MediaInfo& info) {
+    ProbeCacheReader r(data, len);
+    uint32_t nb_streams;
+    if ( !r.get(&info.format_name) || !r.get(&info.duration) || !r.get(&info.start_time) || 
+         !r.get(&info.bit_rate) || !r.get(&info.metadata) || !r.get(&nb_streams) ) {
+        return false;
+    }
+    // 损坏的记录中 nb_streams 可能很大, 先按剩余字节数校验, 避免分配过多内存;
+    if ( nb_streams > r.remaining() / PROBE_CACHE_MIN_STREAM_SIZE ) {
+        return false;
+    }
+    info.streams.resize(nb_streams);
+    for ( auto& stream : info.streams ) {
+        int32_t index, media_type, sample_rate, nb_channels, sample_format, width, height;
+        if ( !r.get(&index) || !r.get(&media_type) || !r.get(&stream.codec_name) || !r.get(&stream.bit_rate) ||
+             !r.get(&stream.duration) || !r.get(&sample_rate) || !r.get(&nb_channels) || !r.get(&sample_format) ||
+             !r.get(&width) || !r.get(&height) || !r.get(&stream.frame_rate) || !r.get(&stream.metadata) ) {
+            return false;
+        }
+        stream.index = index;
+        stream.media_type = static_cast<AVMediaType>(media_type);
+        stream.sample_rate = sample_rate;
+        stream.nb_channels = nb_channels;
+        stream.sample_format = sample_format;
+        stream.width = width;
+        stream.height = height;
+    }
+    return true;
+}
+
+class ProbeCacheImpl {
+public:
+    bool lookup(const std::string& path, MediaInfo& info, bool complete, bool verify_content) {
+        int64_t file_size, mtime_ns;
+        bool exists = file_stat(path, &file_size, &mtime_ns);
+        
+        uint64_t hash = 0;
+        if ( exists && verify_content && !content_hash(path, &hash) ) {
+            exists = false;
+        }
+        
+        std::lock_guard<std::mutex> lock(_mtx);
+        loadIfNeeded();
+        auto it = exists ? _entries.find(path) : _entries.end();
+        if ( it == _entries.end() ) {
+            _misses += 1;
+            return false;
+        }
+        
+        Entry& entry = it->second;
+        if ( entry.file_size != file_size || entry.mtime_ns != mtime_ns ||
+             (complete && !(entry.flags & ENTRY_FLAG_COMPLETE)) ||
+             (verify_content && (!(entry.flags & ENTRY_FLAG_CONTENT_HASH) || entry.content_hash != hash)) ) {
+            _misses += 1;
+            return false;
+        }
+        
+        const uint8_t* data = entry.mapped ? entry.mapped : reinterpret_cast<const uint8_t*>(entry.owned.data());
+        MediaInfo cached_info;
+        if ( !deserialize_media_info(data, entry.info_len, cached_info) ) {
+            // 丢弃损坏的记录, 下次写入时一并从磁盘移除;
+            remove(it);
+            _nb_dirty += 1;
+            _misses += 1;
+            return false;
+        }
+        info = std::move(cached_info);
+        
+        _lru.splice(_lru.begin(), _lru, entry.lru_it);
+        _hits += 1;
+        return true;
+    }
+    
+    void store(const std::string& path, const MediaInfo& info, bool complete, bool verify_content) {
+        int64_t file_size, mtime_ns;
+        if ( !file_stat(path, &file_size, &mtime_ns) ) {
+            return;
+        }
+        uint64_t hash = 0;
+        bool has_hash = verify_content && content_hash(path, &hash);
+        
+        Entry entry;
+        entry.file_size = file_size;
+        entry.mtime_ns = mtime_ns;
+        entry.content_hash = hash;
+        entry.flags = (complete ? ENTRY_FLAG_COMPLETE : 0) | (has_hash ? ENTRY_FLAG_CONTENT_HASH : 0);
+        serialize_media_info(info, entry.owned);
+        entry.info_len = static_cast<uint32_t>(entry.owned.size());
+        
+        std::lock_guard<std::mutex> lock(_mtx);
+        loadIfNeeded();
+        auto it = _entries.find(path);
+        if ( it != _entries.end() ) {
+            // 已有完整的记录时不使用部分结果覆盖;
+            if ( !complete && (it->second.flags & ENTRY_FLAG_COMPLETE) && 
+                 it->second.file_size == file_size && it->second.mtime_ns == mtime_ns ) {
+                return;
+            }
+            remove(it);
+        }
+        
+        _lru.push_front(path);
+        entry.lru_it = _lru.begin();
+        _size += recordSize(path, entry);
+        _entries.emplace(path, std::move(entry));
+        evictIfNeeded();
+        // 写入会重写整个缓存文件并持有锁, 不在此处进行; 由调度器空闲时或显式调用 flush 写入;
+        _nb_dirty += 1;
+    }
+    
+    void setMaxSize(uint64_t max_size) {
+        std::lock_guard<std::mutex> lock(_mtx);
+        loadIfNeeded();
+        _max_size = max_size;
+        if ( evictIfNeeded() ) _nb_dirty += 1;
+    }
+    
+    void clear() {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _loaded = true;
+        _entries.clear();
+        _lru.clear();
+        _size = 0;
+        _nb_dirty = 0;
+        unmap();
+        ::unlink(PROBE_CACHE_FILE);
+    }
+    
+    void flush() {
+        std::lock_guard<std::mutex> lock(_mtx);
+        if ( _nb_dirty > 0 ) save();
+    }
+    
+    ProbeCache::Stats getStats() {
+        std::lock_guard<std::mutex> lock(_mtx);
+        loadIfNeeded();
+        return { static_cast<uint32_t>(_entries.size()), _size, _max_size, _hits, _misses };
+    }
+    
+private:
+    struct Entry {
+        int64_t file_size;
+        int64_t mtime_ns;
+        uint64_t content_hash;
+        uint32_t flags;
+        uint32_t info_len;
+        const uint8_t* mapped = nullptr;    // 指向映射的缓存文件;
+        std::string owned;                  // 尚未写入磁盘的记录;
+        std::list<std::string>::iterator lru_it;
+    };
+    
+    std::mutex _mtx;
+    std::unordered_map<std::string, Entry> _entries;
+    std::list<std::string> _lru; // 最近使用的在前;
+    uint64_t _size { sizeof(ProbeCacheFileHeader) };
+    uint64_t _max_size { PROBE_CACHE_DEFAULT_MAX_SIZE };
+    uint64_t _hits { 0 };
+    uint64_t _misses { 0 };
+    int _nb_dirty { 0 };
+    bool _loaded { false };
+    
+    uint8_t* _map_data { nullptr };
+    size_t _map_size { 0 };
+    
+    static uint64_t recordSize(const std::string& path, const Entry& entry) {
+        return sizeof(ProbeCacheRecordHeader) + path.size() + entry.info_len;
+    }
+    
+    void remove(std::unordered_map<std::string, Entry>::iterator it) {
+        _size -= recordSize(it->first, it->second);
+        _lru.erase(it->second.lru_it);
+        _entries.erase(it);
+    }
+    
+    bool evictIfNeeded() {
+        bool evicted = false;
+        while ( _size > _max_size && !_lru.empty() ) {
+            remove(_entries.find(_lru.back()));
+            evicted = true;
+        }
+        return evicted;
+    }
+    
+    void unmap() {
+        if ( _map_data ) {
+            for ( auto& pair : _entries ) {
+                Entry& entry = pair.second;
+                if ( entry.mapped ) {
+                    entry.owned.assign(reinterpret_cast<const char*>(entry.mapped), entry.info_len);
+                    entry.mapped = nullptr;
+                }
+            }
+            munmap(_map_data, _map_size);
+            _map_data = nullptr;
+            _map_size = 0;
+        }
+    }
+    
+    bool map(const char* file_path) {
+        int fd = ::open(file_path, O_RDONLY);
+        if ( fd < 0 ) return false;
+        struct stat info;
+        if ( fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(ProbeCacheFileHeader)) ) {
+            ::close(fd);
+            return false;
+        }
+        void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if ( data == MAP_FAILED ) return false;
+        _map_data = static_cast<uint8_t*>(data);
+        _map_size = info.st_size;
+        return true;
+    }
+    
+    void loadIfNeeded() {
+        if ( _loaded ) return;
+        _loaded = true;
+        if ( !map(PROBE_CACHE_FILE) ) return;
+        
+        ProbeCacheFileHeader header;
+        memcpy(&header, _map_data, sizeof(header));
+        if ( header.magic != PROBE_CACHE_MAGIC || header.version != PROBE_CACHE_VERSION ) {
+            munmap(_map_data, _map_size);
+            _map_data = nullptr;
+            _map_size = 0;
+            return;
+        }
+        
+        size_t offset = sizeof(header);
+        for ( uint32_t i = 0 ; i < header.nb_entries ; ++ i ) {
+            ProbeCacheRecordHeader record;
+            if ( _map_size - offset < sizeof(record) ) break;
+            memcpy(&record, _map_data + offset, sizeof(record));
+            if ( record.record_size != sizeof(record) + record.path_len + record.info_len || _map_size - offset < record.record_size ) break;
+            
+            std::string path(reinterpret_cast<const char*>(_map_data + offset + sizeof(record)), record.path_len);
+            if ( _entries.find(path) == _entries.end() ) {
+                Entry entry;
+                entry.file_size = record.file_size;
+                entry.mtime_ns = record.mtime_ns;
+                entry.content_hash = record.content_hash;
+                entry.flags = record.flags;
+                entry.info_len = record.info_len;
+                entry.mapped = _map_data + offset + sizeof(record) + record.path_len;
+                _lru.push_back(path);
+                entry.lru_it = std::prev(_lru.end());
+                _size += record.record_size;
+                _entries.emplace(std::move(path), std::move(entry));
+            }
+            offset += record.record_size;
+        }
+        evictIfNeeded();
+    }
+    
+    // 按 LRU 顺序写入临时文件后替换, 再重新映射;
+    void save() {
+        _nb_dirty = 0;
+        struct stat info;
+        if ( stat(PROBE_CACHE_DIR, &info) != 0 && mkdir(PROBE_CACHE_DIR, 0755) != 0 ) {
+            return;
+        }
+        
+        FILE* file = fopen(PROBE_CACHE_TMP_FILE, "wb");
+        if ( !file ) return;
+        
+        ProbeCacheFileHeader header = { PROBE_CACHE_MAGIC, PROBE_CACHE_VERSION, static_cast<uint32_t>(_entries.size()), 0 };
+        bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+        std::vector<std::pair<Entry*, size_t>> offsets;
+        offsets.reserve(_entries.size());
+        size_t offset = sizeof(header);
+        for ( auto it = _lru.begin() ; ok && it != _lru.end() ; ++ it ) {
+            Entry& entry = _entries[*it];
+            ProbeCacheRecordHeader record = {
+                static_cast<uint32_t>(recordSize(*it, entry)), static_cast<uint32_t>(it->size()),
+                entry.file_size, entry.mtime_ns, entry.content_hash, entry.flags, entry.info_len
+            };
+            const void* data = entry.mapped ? static_cast<const void*>(entry.mapped) : static_cast<const void*>(entry.owned.data());
+            ok = fwrite(&record, sizeof(record), 1, file) == 1 &&
+                 fwrite(it->data(), 1, it->size(), file) == it->size() &&
+                 fwrite(data, 1, entry.info_len, file) == entry.info_len;
+            offsets.emplace_back(&entry, offset + sizeof(record) + it->size());
+            offset += record.record_size;
+        }
+        ok = fclose(file) == 0 && ok;
+        if ( !ok || rename(PROBE_CACHE_TMP_FILE, PROBE_CACHE_FILE) != 0 ) {
+            ::unlink(PROBE_CACHE_TMP_FILE);
+            return;
+        }
+        
+        // 记录改为指向新的映射, 释放内存中的副本;
+        unmap();
+        if ( map(PROBE_CACHE_FILE) && _map_size == offset ) {
+            for ( auto& pair : offsets ) {
+                pair.first->mapped = _map_data + pair.second;
+                std::string().swap(pair.first->owned);
+            }
+        }
+    }
+};
+
+} // namespace FFAV
+
+
+namespace FFAV {
+
+// 随进程存在, 不做析构;
+static ProbeCacheImpl& SharedProbeCache() {
+    static ProbeCacheImpl* instance = new ProbeCacheImpl();
+    return *instance;
+}
+
+bool ProbeCache::lookup(const std::string& path, MediaInfo& info, bool complete, bool verify_content) {
+    return SharedProbeCache().lookup(path, info, complete, verify_content);
+}
+
+void ProbeCache::store(const std::string& path, const MediaInfo& info, bool complete, bool verify_content) {
+    SharedProbeCache().store(path, info, complete, verify_content);
+}
+
+void ProbeCache::setMaxSize(uint64_t max_size) {
+    SharedProbeCache().setMaxSize(max_size);
+}
+
+void ProbeCache::clear() {
+    SharedProbeCache().clear();
+}
+
+void ProbeCache::flush() {
+    SharedProbeCache().flush();
+}
+
+ProbeCache::Stats ProbeCache::getStats() {
+    return SharedProbeCache().getStats();
+}
+
+} // namespace FFAV
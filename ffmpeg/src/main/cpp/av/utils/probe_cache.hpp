@@ -0,0 +1,69 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/23.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef FFAV_ProbeCache_hpp
+#define FFAV_ProbeCache_hpp
+
+#include <stdint.h>
+#include <string>
+#include "av/ffwrap/ff_media_probe.hpp"
+
+namespace FFAV {
+
+/**
+ * 本地文件的媒体信息缓存, 持久化在 sj_ff_av 目录中;
+ *
+ * 以 路径 + 文件大小 + 修改时间 (可选文件头部 1KB 的哈希) 作为校验, 文件变化后缓存自动失效;
+ * 缓存文件以 mmap 方式读取, 查找时直接从映射的内存中解析; 超过容量上限时按 LRU 淘汰;
+ */
+class ProbeCache final {
+public:
+    struct Stats {
+        uint32_t entries;
+        uint64_t size;          // 字节;
+        uint64_t max_size;      // 字节;
+        uint64_t hits;
+        uint64_t misses;
+    };
+
+    // verify_content: 同时校验文件头部 1KB 的哈希; 
+    // complete: 仅匹配执行过 avformat_find_stream_info 的结果;
+    static bool lookup(const std::string& path, MediaInfo& info, bool complete = true, bool verify_content = false);
+    static void store(const std::string& path, const MediaInfo& info, bool complete, bool verify_content = false);
+
+    // 缓存文件的大小上限, 默认 8MB;
+    static void setMaxSize(uint64_t max_size);
+    static void clear();
+    // 写入磁盘; 调度器空闲(JobScheduler::setIdleCallback)时也会自动写入, 未写入的记录在进程退出时丢失;
+    static void flush();
+    static Stats getStats();
+
+private:
+    ProbeCache() = delete;
+    ~ProbeCache() = delete;
+    ProbeCache(const ProbeCache&) = delete;
+    ProbeCache& operator=(const ProbeCache&) = delete;
+};
+
+}
+
+#endif //FFAV_ProbeCache_hpp
@@ -21,6 +21,7 @@
 // please include "napi/native_api.h".
 
 #include "task_scheduler.hpp"
+#include "thread_budget.h"
 #include <chrono>
 #include <thread>
 
@@ -30,7 +31,9 @@ std::shared_ptr<TaskScheduler> TaskScheduler::scheduleTask(Task task, int delay_
     std::shared_ptr<TaskScheduler> scheduler = std::make_shared<TaskScheduler>();
     scheduler->task = task;
     scheduler->delay_in_seconds = delay_in_seconds;
-    scheduler->future = std::async(std::launch::async, [scheduler] {
+    uint64_t budget_job = ThreadBudget::currentJob();
+    scheduler->future = std::async(std::launch::async, [scheduler, budget_job] {
+        ThreadBudget::ThreadScope budget_scope(budget_job, NATIVE_THREAD_TASK);
         std::this_thread::sleep_for(std::chrono::seconds(scheduler->delay_in_seconds));
         {
             std::lock_guard<std::mutex> lock(scheduler->mtx);
@@ -0,0 +1,204 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/24.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "thread_budget.h"
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace FFAV {
+
+// 与 libavcodec 自动线程数的上限保持一致;
+static constexpr int MAX_SHARE_THREADS = 16;
+
+static thread_local uint64_t current_job_id = 0;
+
+static bool is_fixed_thread(int type) {
+    return type != NATIVE_THREAD_CODEC && type != NATIVE_THREAD_FILTER;
+}
+
+class ThreadBudgetImpl {
+public:
+    ThreadBudgetImpl() {
+        _max_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+    void setMaxThreads(int count) {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _max_threads = std::max(0, count);
+    }
+
+    int getMaxThreads() {
+        std::lock_guard<std::mutex> lock(_mtx);
+        return _max_threads;
+    }
+
+    uint64_t beginJob(ThreadBudget::JobKind kind) {
+        std::lock_guard<std::mutex> lock(_mtx);
+        uint64_t job_id = ++ _next_job_id;
+        ThreadBudget::JobStats& job = _jobs[job_id];
+        job.id = job_id;
+        job.kind = kind;
+        std::fill(std::begin(job.threads), std::end(job.threads), 0);
+        job.total = 0;
+        return job_id;
+    }
+
+    void endJob(uint64_t job_id) {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _jobs.erase(job_id);
+    }
+
+    void add(uint64_t job_id, NativeThreadType type, int count) {
+        if ( type < 0 || type >= NATIVE_THREAD_TYPE_NB || count == 0 ) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(_mtx);
+        auto it = _jobs.find(job_id);
+        // 不属于任何任务或任务已注销的线程仅计入总数;
+        int* threads = it != _jobs.end() ? it->second.threads : _unattributed;
+        threads[type] = std::max(0, threads[type] + count);
+        if ( it != _jobs.end() ) {
+            it->second.total = 0;
+            for ( int n : it->second.threads ) it->second.total += n;
+        }
+    }
+
+    int share(uint64_t job_id) {
+        std::lock_guard<std::mutex> lock(_mtx);
+        auto it = _jobs.find(job_id);
+        if ( it == _jobs.end() || it->second.kind != ThreadBudget::FFMPEG ) {
+            return 0;
+        }
+        return computeShare();
+    }
+
+    ThreadBudget::Stats getStats() {
+        std::lock_guard<std::mutex> lock(_mtx);
+        ThreadBudget::Stats stats;
+        stats.max_threads = _max_threads;
+        stats.live_threads = 0;
+        for ( int n : _unattributed ) stats.live_threads += n;
+        stats.jobs.reserve(_jobs.size());
+        for ( auto& item : _jobs ) {
+            stats.live_threads += item.second.total;
+            stats.jobs.push_back(item.second);
+        }
+        stats.share = computeShare();
+        return stats;
+    }
+
+private:
+    std::mutex _mtx;
+    int _max_threads;
+    uint64_t _next_job_id { 0 };
+    std::map<uint64_t, ThreadBudget::JobStats> _jobs;
+    int _unattributed[NATIVE_THREAD_TYPE_NB] = { 0 };
+
+    // 扣除所有固定线程后由正在执行的 ffmpeg 命令平分; 需在持有锁时调用;
+    int computeShare() {
+        if ( _max_threads <= 0 ) {
+            return 0;
+        }
+
+        int nb_fixed = 0;
+        int nb_ffmpeg_jobs = 0;
+        for ( int i = 0 ; i < NATIVE_THREAD_TYPE_NB ; ++ i ) {
+            if ( is_fixed_thread(i) ) nb_fixed += _unattributed[i];
+        }
+        for ( auto& item : _jobs ) {
+            for ( int i = 0 ; i < NATIVE_THREAD_TYPE_NB ; ++ i ) {
+                if ( is_fixed_thread(i) ) nb_fixed += item.second.threads[i];
+            }
+            if ( item.second.kind == ThreadBudget::FFMPEG ) nb_ffmpeg_jobs += 1;
+        }
+
+        int available = _max_threads - nb_fixed;
+        return std::min(MAX_SHARE_THREADS, std::max(1, available / std::max(1, nb_ffmpeg_jobs)));
+    }
+};
+
+// 随进程存在, 不做析构;
+static ThreadBudgetImpl& SharedThreadBudget() {
+    static ThreadBudgetImpl* instance = new ThreadBudgetImpl();
+    return *instance;
+}
+
+void ThreadBudget::setMaxThreads(int count) {
+    SharedThreadBudget().setMaxThreads(count);
+}
+
+int ThreadBudget::getMaxThreads() {
+    return SharedThreadBudget().getMaxThreads();
+}
+
+uint64_t ThreadBudget::beginJob(JobKind kind) {
+    return SharedThreadBudget().beginJob(kind);
+}
+
+void ThreadBudget::endJob(uint64_t job_id) {
+    SharedThreadBudget().endJob(job_id);
+}
+
+uint64_t ThreadBudget::currentJob() {
+    return current_job_id;
+}
+
+void ThreadBudget::add(uint64_t job_id, NativeThreadType type, int count) {
+    SharedThreadBudget().add(job_id, type, count);
+}
+
+int ThreadBudget::share(uint64_t job_id) {
+    return SharedThreadBudget().share(job_id);
+}
+
+ThreadBudget::Stats ThreadBudget::getStats() {
+    return SharedThreadBudget().getStats();
+}
+
+ThreadBudget::JobBinding::JobBinding(uint64_t job_id): _previous_job(current_job_id) {
+    current_job_id = job_id;
+}
+
+ThreadBudget::JobBinding::~JobBinding() {
+    current_job_id = _previous_job;
+}
+
+ThreadBudget::ThreadScope::ThreadScope(uint64_t job_id, NativeThreadType type): _binding(job_id), _job_id(job_id), _type(type) {
+    ThreadBudget::add(_job_id, _type, 1);
+}
+
+ThreadBudget::ThreadScope::~ThreadScope() {
+    ThreadBudget::add(_job_id, _type, -1);
+}
+
+} // namespace FFAV
+
+int native_thread_budget_share(void) {
+    return FFAV::ThreadBudget::share(FFAV::current_job_id);
+}
+
+void native_thread_budget_add(NativeThreadType type, int count) {
+    FFAV::ThreadBudget::add(FFAV::current_job_id, type, count);
+}
@@ -0,0 +1,138 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/24.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef FFAV_ThreadBudget_h
+#define FFAV_ThreadBudget_h
+
+#include <stdint.h>
+
+typedef enum NativeThreadType {
+    NATIVE_THREAD_JOB = 0,  // 执行命令的线程;
+    NATIVE_THREAD_DEMUX,    // 每个输入的读取线程;
+    NATIVE_THREAD_MUX,      // 每个输出的写入线程;
+    NATIVE_THREAD_ENCODE,   // 每个输出流的编码线程(-encoder_threads);
+    NATIVE_THREAD_DECODE,   // 每个音频输入流的解码线程(-decoder_threads);
+    NATIVE_THREAD_CODEC,    // 编解码器内部的线程;
+    NATIVE_THREAD_FILTER,   // 滤镜内部的线程;
+    NATIVE_THREAD_READER,   // 播放器读取线程;
+    NATIVE_THREAD_EVENT,    // 播放器事件线程;
+    NATIVE_THREAD_TASK,     // 延时任务线程(TaskScheduler);
+    NATIVE_THREAD_TYPE_NB
+} NativeThreadType;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+    // 当前线程所属的任务可以使用的编解码/滤镜线程数量, 根据当前负载计算;
+    // 未开启线程预算或当前线程不属于任何任务时返回 0, 此时保持 ffmpeg 的默认值(auto);
+    int native_thread_budget_share(void);
+    // 当前线程所属的任务增加(count > 0)或减少(count < 0)了 type 类型的线程;
+    void native_thread_budget_add(NativeThreadType type, int count);
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+#include <vector>
+
+namespace FFAV {
+
+/**
+ * 进程内共享的线程预算;
+ *
+ * 统计各任务(ffmpeg/ffprobe 命令及播放器)当前存活的线程, 并按负载为 ffmpeg 命令分配编解码及滤镜线程数量:
+ * 预算总数扣除所有任务的固定线程(执行/读取/写入/播放器等线程)后, 由正在执行的 ffmpeg 命令平分, 每个命令至少 1 个;
+ * 线程通过 thread_local 关联到任务, 在任务线程中创建的子线程需显式关联(ThreadScope);
+ */
+class ThreadBudget final {
+public:
+    enum JobKind {
+        FFMPEG = 0,
+        FFPROBE = 1,
+        PLAYER = 2,
+    };
+
+    struct JobStats {
+        uint64_t id;
+        JobKind kind;
+        int threads[NATIVE_THREAD_TYPE_NB]; // 各类型存活的线程数量;
+        int total;
+    };
+
+    struct Stats {
+        int max_threads;            // 0 表示未开启;
+        int live_threads;           // 所有任务存活的线程数量;
+        int share;                  // 新开启的编解码器/滤镜当前可以使用的线程数量;
+        std::vector<JobStats> jobs;
+    };
+
+    // 设置线程预算, 默认为 cpu 核心数; 0 表示关闭自动分配, 仅做统计; 仅影响之后打开的编解码器及滤镜;
+    static void setMaxThreads(int count);
+    static int getMaxThreads();
+
+    // 注册任务, 返回任务 id; 不会关联当前线程;
+    static uint64_t beginJob(JobKind kind);
+    // 注销任务, 任务的统计数据一并移除;
+    static void endJob(uint64_t job_id);
+
+    // 当前线程所属的任务, 0 表示不属于任何任务;
+    static uint64_t currentJob();
+    static void add(uint64_t job_id, NativeThreadType type, int count);
+    static int share(uint64_t job_id);
+
+    static Stats getStats();
+
+    // 在作用域内将当前线程关联到任务, 退出作用域时恢复;
+    class JobBinding {
+    public:
+        explicit JobBinding(uint64_t job_id);
+        ~JobBinding();
+        JobBinding(const JobBinding&) = delete;
+        JobBinding& operator=(const JobBinding&) = delete;
+    private:
+        uint64_t _previous_job;
+    };
+
+    // 线程入口处使用; 将当前线程关联到任务并计入 type 类型的线程, 退出作用域时移除;
+    class ThreadScope {
+    public:
+        ThreadScope(uint64_t job_id, NativeThreadType type);
+        ~ThreadScope();
+        ThreadScope(const ThreadScope&) = delete;
+        ThreadScope& operator=(const ThreadScope&) = delete;
+    private:
+        JobBinding _binding;
+        uint64_t _job_id;
+        NativeThreadType _type;
+    };
+
+private:
+    ThreadBudget() = delete;
+    ~ThreadBudget() = delete;
+    ThreadBudget(const ThreadBudget&) = delete;
+    ThreadBudget& operator=(const ThreadBudget&) = delete;
+};
+
+}
+#endif
+
+#endif //FFAV_ThreadBudget_h
@@ -0,0 +1,208 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/31.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "transcode_checkpoint.hpp"
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+extern "C" {
+#include <libavutil/error.h>
+}
+
+namespace FFAV {
+
+static const char* const CHECKPOINT_FILE_NAME = "checkpoint.txt";
+static const char* const CHECKPOINT_TMP_FILE_NAME = "checkpoint.txt.tmp";
+static constexpr int CHECKPOINT_VERSION = 1;
+
+static uint64_t fnv1a(const std::string& str) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for ( unsigned char c : str ) {
+        h ^= c;
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+// 逐级创建目录;
+static int make_dirs(const std::string& path) {
+    for ( size_t pos = 1 ; pos <= path.size() ; ++ pos ) {
+        if ( pos != path.size() && path[pos] != '/' ) continue;
+        std::string sub = path.substr(0, pos);
+        if ( mkdir(sub.c_str(), 0755) != 0 && errno != EEXIST ) {
+            return AVERROR(errno);
+        }
+    }
+    return 0;
+}
+
+static bool file_exists(const std::string& path) {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 && S_ISREG(info.st_mode);
+}
+
+static bool has_suffix(const char* name, const char* suffix) {
+    size_t len = strlen(name);
+    size_t suffix_len = strlen(suffix);
+    return len > suffix_len && strcmp(name + len - suffix_len, suffix) == 0;
+}
+
+// 删除目录中所有的分段输出(<index>.nut 及 <index>.nut.part), 分段数量变化时旧记录中的分段可能超出新的范围;
+static void remove_segments(const std::string& dir) {
+    DIR* d = opendir(dir.c_str());
+    if ( d == nullptr ) {
+        return;
+    }
+    struct dirent* entry;
+    while ( (entry = readdir(d)) != nullptr ) {
+        const char* name = entry->d_name;
+        if ( has_suffix(name, ".nut") || has_suffix(name, ".nut.part") ) unlink((dir + "/" + name).c_str());
+    }
+    closedir(d);
+}
+
+TranscodeCheckpoint::TranscodeCheckpoint(const std::string& dir, const std::string& job_id) {
+    _job_dir = dir.empty() || dir.back() == '/' ? dir + job_id : dir + "/" + job_id;
+}
+
+int TranscodeCheckpoint::open(const std::string& fingerprint, size_t nb_segments) {
+    char hex[17];
+    snprintf(hex, sizeof(hex), "%016" PRIx64, fnv1a(fingerprint));
+    
+    std::lock_guard<std::mutex> lock(_mtx);
+    _fingerprint = hex;
+    _nb_segments = nb_segments;
+    _committed.clear();
+    
+    int ret = make_dirs(_job_dir);
+    if ( ret < 0 ) {
+        return ret;
+    }
+    
+    bool matched = false;
+    FILE* file = fopen((_job_dir + "/" + CHECKPOINT_FILE_NAME).c_str(), "r");
+    if ( file ) {
+        char line[256];
+        int version = 0;
+        size_t saved_segments = 0;
+        std::string saved_fingerprint;
+        std::map<size_t, int64_t> committed;
+        while ( fgets(line, sizeof(line), file) ) {
+            char value[64];
+            unsigned long index;
+            int64_t end_time_us;
+            if ( sscanf(line, "version=%d", &version) == 1 ) continue;
+            if ( sscanf(line, "fingerprint=%63s", value) == 1 ) { saved_fingerprint = value; continue; }
+            if ( sscanf(line, "segments=%lu", &index) == 1 ) { saved_segments = index; continue; }
+            if ( sscanf(line, "segment=%lu %" SCNd64, &index, &end_time_us) == 2 ) committed[index] = end_time_us;
+        }
+        fclose(file);
+        
+        matched = version == CHECKPOINT_VERSION && saved_fingerprint == _fingerprint && saved_segments == nb_segments;
+        if ( matched ) {
+            // 只保留输出仍然存在的分段;
+            for ( auto& pair : committed ) {
+                if ( pair.first < nb_segments && file_exists(segmentPath(pair.first)) ) _committed.insert(pair);
+            }
+        }
+    }
+    
+    if ( !matched ) {
+        remove_segments(_job_dir);
+    }
+    return save();
+}
+
+bool TranscodeCheckpoint::isCommitted(size_t index) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _committed.count(index) > 0;
+}
+
+size_t TranscodeCheckpoint::committedCount() {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _committed.size();
+}
+
+std::string TranscodeCheckpoint::partialPath(size_t index) const {
+    return _job_dir + "/" + std::to_string(index) + ".nut.part";
+}
+
+std::string TranscodeCheckpoint::segmentPath(size_t index) const {
+    return _job_dir + "/" + std::to_string(index) + ".nut";
+}
+
+int TranscodeCheckpoint::commit(size_t index, int64_t end_time_us) {
+    if ( rename(partialPath(index).c_str(), segmentPath(index).c_str()) != 0 ) {
+        return AVERROR(errno);
+    }
+    std::lock_guard<std::mutex> lock(_mtx);
+    _committed[index] = end_time_us;
+    return save();
+}
+
+// 需在持有锁时调用;
+int TranscodeCheckpoint::save() {
+    std::string tmp_path = _job_dir + "/" + CHECKPOINT_TMP_FILE_NAME;
+    FILE* file = fopen(tmp_path.c_str(), "w");
+    if ( file == nullptr ) {
+        return AVERROR(errno);
+    }
+    
+    fprintf(file, "version=%d\n", CHECKPOINT_VERSION);
+    fprintf(file, "fingerprint=%s\n", _fingerprint.c_str());
+    fprintf(file, "segments=%lu\n", static_cast<unsigned long>(_nb_segments));
+    for ( auto& pair : _committed ) {
+        fprintf(file, "segment=%lu %" PRId64 "\n", static_cast<unsigned long>(pair.first), pair.second);
+    }
+    
+    bool ok = fflush(file) == 0 && fsync(fileno(file)) == 0;
+    fclose(file);
+    if ( !ok || rename(tmp_path.c_str(), (_job_dir + "/" + CHECKPOINT_FILE_NAME).c_str()) != 0 ) {
+        int ret = AVERROR(errno);
+        unlink(tmp_path.c_str());
+        return ret;
+    }
+    return 0;
+}
+
+void TranscodeCheckpoint::remove() {
+    std::lock_guard<std::mutex> lock(_mtx);
+    DIR* d = opendir(_job_dir.c_str());
+    if ( d ) {
+        struct dirent* entry;
+        while ( (entry = readdir(d)) != nullptr ) {
+            const char* name = entry->d_name;
+            if ( name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')) ) continue;
+            unlink((_job_dir + "/" + name).c_str());
+        }
+        closedir(d);
+    }
+    rmdir(_job_dir.c_str());
+    _committed.clear();
+}
+
+}
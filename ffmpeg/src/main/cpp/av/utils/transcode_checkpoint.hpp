@@ -0,0 +1,72 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/31.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef FFAV_TranscodeCheckpoint_hpp
+#define FFAV_TranscodeCheckpoint_hpp
+
+#include <stdint.h>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace FFAV {
+
+/**
+ * 分段转码的检查点;
+ *
+ * 每个任务使用 <dir>/<job_id> 目录, 分段输出先写入 <index>.nut.part, 完成后重命名为 <index>.nut 并记录到 checkpoint.txt;
+ * checkpoint.txt 记录任务的指纹、已完成的分段及其在输入中的结束时间; 每次更新先写入临时文件再重命名, 进程被终止时不会损坏;
+ * 指纹或分段数量不一致(输入、参数或分段方式发生变化)时已有的记录及所有分段输出作废;
+ */
+class TranscodeCheckpoint {
+public:
+    TranscodeCheckpoint(const std::string& dir, const std::string& job_id);
+    
+    // 读取已有的记录; 指纹不一致时清除目录中所有的分段输出; 目录不存在时创建;
+    int open(const std::string& fingerprint, size_t nb_segments);
+    
+    bool isCommitted(size_t index);
+    // 已完成的分段数; open 之后即为本次复用的分段数;
+    size_t committedCount();
+    
+    std::string partialPath(size_t index) const;
+    std::string segmentPath(size_t index) const;
+    
+    // 分段输出完成; end_time_us 为分段在输入中的结束时间; 可在多个线程中调用;
+    int commit(size_t index, int64_t end_time_us);
+    
+    // 删除任务目录;
+    void remove();
+    
+private:
+    int save();
+    
+    std::string _job_dir;
+    std::string _fingerprint;
+    size_t _nb_segments { 0 };
+    std::mutex _mtx;
+    std::map<size_t, int64_t> _committed; // 分段索引 -> 分段在输入中的结束时间;
+};
+
+}
+
+#endif //FFAV_TranscodeCheckpoint_hpp
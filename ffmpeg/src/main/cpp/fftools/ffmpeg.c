@@ -25,6 +25,11 @@
 
 #include "config.h"
 #include "interaction/progress_callback.h"
+#include "av/utils/thread_budget.h"
+#include "interaction/job_control.h"
+#include "interaction/job_report.h"
+#include "fftools/objpool.h"
+#include "fftools/thread_queue.h"
 #include "fftools/opt_common.h"
 #include "fftools/thread_variables.h"
 #include <ctype.h>
@@ -138,6 +143,9 @@ static int trigger_fix_sub_duration_heartbeat(OutputStream *ost, const AVPacket
 static BenchmarkTimeStamps get_benchmark_time_stamps(void);
 static int64_t getmaxrss(void);
 static int ifilter_has_all_input_formats(FilterGraph *fg);
+static void report_job_summary(void);
+static int enc_threads_stop(int abort);
+static void dec_threads_stop(void);
 
 static _Thread_local int64_t nb_frames_dup = 0;
 static _Thread_local uint64_t dup_warning = 1000;
@@ -516,10 +524,18 @@ static int decode_interrupt_cb(void *ctx)
 
 _Thread_local AVIOInterruptCB int_cb;
 
+static _Thread_local OptionDef *ffmpeg_options_cache = NULL;
+
 void ffmpeg_cleanup(int ret)
 {
     int i, j;
 
+    /* no-op after a successful transcode, stops encoding on the error paths */
+    enc_threads_stop(1);
+    dec_threads_stop();
+
+    report_job_summary();
+
     if (do_benchmark) {
         int maxrss = getmaxrss() / 1024;
         av_log(NULL, AV_LOG_INFO, "bench: maxrss=%ikB\n", maxrss);
@@ -527,6 +543,7 @@ void ffmpeg_cleanup(int ret)
 
     for (i = 0; i < nb_filtergraphs; i++) {
         FilterGraph *fg = filtergraphs[i];
+        native_thread_budget_add(NATIVE_THREAD_FILTER, -fg->nb_budget_threads);
         avfilter_graph_free(&fg->graph);
         for (j = 0; j < fg->nb_inputs; j++) {
             InputFilter *ifilter = fg->inputs[j];
@@ -572,6 +589,9 @@ void ffmpeg_cleanup(int ret)
     for (i = 0; i < nb_input_files; i++)
         ifile_close(&input_files[i]);
 
+    /* all queues are gone, drop the command's shared packet/frame pools */
+    objpool_job_uninit();
+
     if (vstats_file) {
         if (fclose(vstats_file))
             av_log(NULL, AV_LOG_ERROR,
@@ -587,7 +607,7 @@ void ffmpeg_cleanup(int ret)
     av_freep(&output_files);
     uninit_opts();
 
-    avformat_network_deinit();
+    // 网络模块在 fftools_init 中只初始化一次, 这里不再释放;
 
 //    if (received_sigterm) {
 //        av_log(NULL, AV_LOG_INFO, "Exiting normally, received signal %d.\n",
@@ -598,7 +618,8 @@ void ffmpeg_cleanup(int ret)
     term_exit();
 //     ffmpeg_exited = 1;
     
-    free(options);
+    if (options != ffmpeg_options_cache)
+        free(options);
     options = NULL;
 }
 
@@ -767,6 +788,13 @@ static int init_output_stream_wrapper(OutputStream *ost, AVFrame *frame,
     return ret;
 }
 
+/* of_output_packet() for the main thread, where -xerror makes errors fatal */
+static void output_packet(OutputFile *of, AVPacket *pkt, OutputStream *ost, int eof)
+{
+    if (of_output_packet(of, pkt, ost, eof) < 0 && exit_on_error)
+        exit_program(1);
+}
+
 static double psnr(double d)
 {
     return -10.0 * log10(d);
@@ -780,14 +808,14 @@ static void update_video_stats(OutputStream *ost, const AVPacket *pkt, int write
     int64_t frame_number;
     double ti1, bitrate, avg_bitrate;
 
-    ost->quality   = sd ? AV_RL32(sd) : -1;
-    ost->pict_type = sd ? sd[4] : AV_PICTURE_TYPE_NONE;
+    atomic_store(&ost->quality,   sd ? AV_RL32(sd) : -1);
+    atomic_store(&ost->pict_type, sd ? sd[4] : AV_PICTURE_TYPE_NONE);
 
     for (int i = 0; i<FF_ARRAY_ELEMS(ost->error); i++) {
         if (sd && i < sd[5])
-            ost->error[i] = AV_RL64(sd + 8 + 8*i);
+            atomic_store(&ost->error[i], AV_RL64(sd + 8 + 8*i));
         else
-            ost->error[i] = -1;
+            atomic_store(&ost->error[i], -1);
     }
 
     if (!write_vstats)
@@ -802,17 +830,17 @@ static void update_video_stats(OutputStream *ost, const AVPacket *pkt, int write
         }
     }
 
-    frame_number = ost->packets_encoded;
+    frame_number = atomic_load(&ost->packets_encoded);
     if (vstats_version <= 1) {
         fprintf(vstats_file, "frame= %5" PRId64" q= %2.1f ", frame_number,
-                ost->quality / (float)FF_QP2LAMBDA);
+                atomic_load(&ost->quality) / (float)FF_QP2LAMBDA);
     } else  {
         fprintf(vstats_file, "out= %2d st= %2d frame= %5" PRId64" q= %2.1f ", ost->file_index, ost->index, frame_number,
-                ost->quality / (float)FF_QP2LAMBDA);
+                atomic_load(&ost->quality) / (float)FF_QP2LAMBDA);
     }
 
-    if (ost->error[0]>=0 && (enc->flags & AV_CODEC_FLAG_PSNR))
-        fprintf(vstats_file, "PSNR= %6.2f ", psnr(ost->error[0] / (enc->width * enc->height * 255.0 * 255.0)));
+    if (atomic_load(&ost->error[0]) >= 0 && (enc->flags & AV_CODEC_FLAG_PSNR))
+        fprintf(vstats_file, "PSNR= %6.2f ", psnr(atomic_load(&ost->error[0]) / (enc->width * enc->height * 255.0 * 255.0)));
 
     fprintf(vstats_file,"f_size= %6d ", pkt->size);
     /* compute pts value */
@@ -821,10 +849,10 @@ static void update_video_stats(OutputStream *ost, const AVPacket *pkt, int write
         ti1 = 0.01;
 
     bitrate     = (pkt->size * 8) / av_q2d(enc->time_base) / 1000.0;
-    avg_bitrate = (double)(ost->data_size_enc * 8) / ti1 / 1000.0;
+    avg_bitrate = (double)(atomic_load(&ost->data_size_enc) * 8) / ti1 / 1000.0;
     fprintf(vstats_file, "s_size= %8.0fkB time= %0.3f br= %7.1fkbits/s avg_br= %7.1fkbits/s ",
-           (double)ost->data_size_enc / 1024, ti1, bitrate, avg_bitrate);
-    fprintf(vstats_file, "type= %c\n", av_get_picture_type_char(ost->pict_type));
+           (double)atomic_load(&ost->data_size_enc) / 1024, ti1, bitrate, avg_bitrate);
+    fprintf(vstats_file, "type= %c\n", av_get_picture_type_char(atomic_load(&ost->pict_type)));
 }
 
 void enc_stats_write(OutputStream *ost, EncStats *es,
@@ -866,7 +894,7 @@ void enc_stats_write(OutputStream *ost, EncStats *es,
 
         if (frame) {
             switch (c->type) {
-            case ENC_STATS_SAMPLE_NUM:  avio_printf(io, "%" PRIu64,  ost->samples_encoded);          continue;
+            case ENC_STATS_SAMPLE_NUM:  avio_printf(io, "%" PRIu64,  atomic_load(&ost->samples_encoded));          continue;
             case ENC_STATS_NB_SAMPLES:  avio_printf(io, "%d",       frame->nb_samples);             continue;
             default: av_assert0(0);
             }
@@ -882,7 +910,7 @@ void enc_stats_write(OutputStream *ost, EncStats *es,
             }
             case ENC_STATS_AVG_BITRATE: {
                 double duration = pkt->dts * av_q2d(tb);
-                avio_printf(io, "%g",  duration > 0 ? 8.0 * ost->data_size_enc / duration : -1.);
+                avio_printf(io, "%g",  duration > 0 ? 8.0 * atomic_load(&ost->data_size_enc) / duration : -1.);
                 continue;
             }
             default: av_assert0(0);
@@ -893,7 +921,7 @@ void enc_stats_write(OutputStream *ost, EncStats *es,
     avio_flush(io);
 }
 
-static int encode_frame(OutputFile *of, OutputStream *ost, AVFrame *frame)
+static int encode_frame_internal(OutputFile *of, OutputStream *ost, AVFrame *frame)
 {
     AVCodecContext   *enc = ost->enc_ctx;
     AVPacket         *pkt = ost->pkt;
@@ -904,10 +932,10 @@ static int encode_frame(OutputFile *of, OutputStream *ost, AVFrame *frame)
     if (frame) {
         if (ost->enc_stats_pre.io)
             enc_stats_write(ost, &ost->enc_stats_pre, frame, NULL,
-                            ost->frames_encoded);
+                            atomic_load(&ost->frames_encoded));
 
-        ost->frames_encoded++;
-        ost->samples_encoded += frame->nb_samples;
+        atomic_fetch_add(&ost->frames_encoded, 1);
+        atomic_fetch_add(&ost->samples_encoded, frame->nb_samples);
 
         if (debug_ts) {
             av_log(ost, AV_LOG_INFO, "encoder <- type:%s "
@@ -942,8 +970,8 @@ static int encode_frame(OutputFile *of, OutputStream *ost, AVFrame *frame)
             av_assert0(frame); // should never happen during flushing
             return 0;
         } else if (ret == AVERROR_EOF) {
-            of_output_packet(of, pkt, ost, 1);
-            return ret;
+            int err = of_output_packet(of, pkt, ost, 1);
+            return err < 0 && exit_on_error ? err : ret;
         } else if (ret < 0) {
             av_log(ost, AV_LOG_ERROR, "%s encoding failed\n", type_desc);
             return ret;
@@ -953,7 +981,7 @@ static int encode_frame(OutputFile *of, OutputStream *ost, AVFrame *frame)
             update_video_stats(ost, pkt, !!vstats_filename);
         if (ost->enc_stats_post.io)
             enc_stats_write(ost, &ost->enc_stats_post, NULL, pkt,
-                            ost->packets_encoded);
+                            atomic_load(&ost->packets_encoded));
 
         if (debug_ts) {
             av_log(ost, AV_LOG_INFO, "encoder -> type:%s "
@@ -985,23 +1013,280 @@ static int encode_frame(OutputFile *of, OutputStream *ost, AVFrame *frame)
             exit_program(1);
         }
 
-        ost->data_size_enc += pkt->size;
+        atomic_fetch_add(&ost->data_size_enc, pkt->size);
 
-        ost->packets_encoded++;
+        atomic_fetch_add(&ost->packets_encoded, 1);
 
-        of_output_packet(of, pkt, ost, 0);
+        /* with -xerror the error ends the job; returned rather than exiting
+         * here so that it also works on an encoder thread */
+        ret = of_output_packet(of, pkt, ost, 0);
+        if (ret < 0 && exit_on_error)
+            return ret;
     }
 
     av_assert0(0);
 }
 
+static int encode_frame(OutputFile *of, OutputStream *ost, AVFrame *frame)
+{
+    int stage = native_job_report_stage_enter(NATIVE_JOB_STAGE_ENCODE);
+    int ret = encode_frame_internal(of, ost, frame);
+    native_job_report_stage_leave(stage);
+    return ret;
+}
+
+/*
+ * -encoder_threads: once the muxer of an output is running, the frames of
+ * its audio/video streams are handed over to one encoder thread per stream,
+ * so that several renditions of a job are encoded in parallel. Everything up
+ * to (and including) the frame queue stays on the main thread.
+ */
+typedef struct EncoderThread {
+    OutputFile   *of;
+    OutputStream *ost;
+
+    ThreadQueue  *tq;
+    pthread_t     thread;
+    /* reference of the frame being sent, owned by the main thread */
+    AVFrame      *frame;
+
+    /* first encoding error, written by the encoder thread */
+    atomic_int    ret;
+    /* set by the main thread to drop queued frames instead of encoding them */
+    atomic_int    abort;
+    int           flushed;
+
+    /* thread-local state of the main thread needed by encode_frame() */
+    void         *job_report;
+    int           debug_ts;
+    int           do_benchmark_all;
+    int           exit_on_error;
+} EncoderThread;
+
+static void enc_frame_move(void *dst, void *src)
+{
+    av_frame_move_ref(dst, src);
+}
+
+static void *encoder_thread(void *arg)
+{
+    EncoderThread *et = arg;
+    OutputStream *ost = et->ost;
+    AVFrame    *frame = NULL;
+    char name[16];
+    int ret = 0;
+
+    native_job_report_bind(et->job_report);
+
+    snprintf(name, sizeof(name), "enc%d:%d", ost->file_index, ost->index);
+    ff_thread_setname(name);
+
+    /* options are thread-local, copy the ones the encoding path reads;
+     * errors (including muxing errors under -xerror) are returned through
+     * et->ret and fail the job on the main thread instead of exiting here */
+    debug_ts         = et->debug_ts;
+    do_benchmark_all = et->do_benchmark_all;
+    exit_on_error    = et->exit_on_error;
+    update_benchmark(NULL);
+
+    frame = av_frame_alloc();
+    if (!frame) {
+        ret = AVERROR(ENOMEM);
+        goto finish;
+    }
+
+    while (1) {
+        int stream_idx;
+
+        ret = tq_receive(et->tq, &stream_idx, frame);
+        if (stream_idx < 0) {
+            ret = 0;
+            break;
+        }
+
+        if (atomic_load(&et->abort)) {
+            av_frame_unref(frame);
+            continue;
+        }
+
+        ret = encode_frame(et->of, ost, ret == AVERROR_EOF ? NULL : frame);
+        av_frame_unref(frame);
+        if (ret == AVERROR_EOF) {
+            ret = 0;
+            continue;
+        }
+        if (ret < 0)
+            break;
+    }
+
+finish:
+    if (ret < 0)
+        atomic_store(&et->ret, ret);
+    tq_receive_finish(et->tq, 0);
+
+    av_frame_free(&frame);
+
+    native_job_report_thread_finish();
+
+    return NULL;
+}
+
+static int enc_thread_eligible(OutputFile *of, OutputStream *ost)
+{
+    enum AVMediaType type = ost->enc_ctx->codec_type;
+
+    if (!encoder_threads ||
+        (type != AVMEDIA_TYPE_VIDEO && type != AVMEDIA_TYPE_AUDIO))
+        return 0;
+
+    /* these write to state shared with other streams of the command */
+    if (vstats_filename || ost->fix_sub_duration_heartbeat ||
+        ost->enc_stats_pre.io || ost->enc_stats_post.io)
+        return 0;
+
+    /* packets encoded before the muxer starts are buffered by the caller */
+    return of_muxer_started(of);
+}
+
+static int enc_thread_start(OutputFile *of, OutputStream *ost)
+{
+    EncoderThread *et;
+    ObjPool *op;
+    int ret;
+
+    op = objpool_job_frames();
+    if (!op)
+        return AVERROR(ENOMEM);
+
+    et = av_mallocz(sizeof(*et));
+    if (!et)
+        return AVERROR(ENOMEM);
+
+    et->of               = of;
+    et->ost              = ost;
+    et->job_report       = native_job_report_current();
+    et->debug_ts         = debug_ts;
+    et->do_benchmark_all = do_benchmark_all;
+    et->exit_on_error    = exit_on_error;
+    atomic_init(&et->ret, 0);
+    atomic_init(&et->abort, 0);
+
+    et->frame = av_frame_alloc();
+    if (!et->frame) {
+        ret = AVERROR(ENOMEM);
+        goto fail;
+    }
+
+    op = objpool_ref(op);
+    et->tq = tq_alloc_spsc(1, 8, op, enc_frame_move);
+    if (!et->tq) {
+        objpool_free(&op);
+        ret = AVERROR(ENOMEM);
+        goto fail;
+    }
+
+    ret = pthread_create(&et->thread, NULL, encoder_thread, et);
+    if (ret) {
+        ret = AVERROR(ret);
+        goto fail;
+    }
+    native_thread_budget_add(NATIVE_THREAD_ENCODE, 1);
+
+    ost->enc_thread = et;
+    return 0;
+
+fail:
+    tq_free(&et->tq);
+    av_frame_free(&et->frame);
+    av_freep(&et);
+    return ret;
+}
+
+/* Join the encoder threads; without abort all queued frames are encoded. */
+static int enc_threads_stop(int abort)
+{
+    int err = 0;
+
+    for (OutputStream *ost = ost_iter(NULL); ost; ost = ost_iter(ost)) {
+        EncoderThread *et = ost->enc_thread;
+        int ret;
+
+        if (!et)
+            continue;
+
+        if (abort || !et->flushed)
+            atomic_store(&et->abort, 1);
+        tq_send_finish(et->tq, 0);
+
+        pthread_join(et->thread, NULL);
+        native_thread_budget_add(NATIVE_THREAD_ENCODE, -1);
+
+        ret = atomic_load(&et->ret);
+        if (ret < 0 && !err)
+            err = ret;
+
+        tq_free(&et->tq);
+        av_frame_free(&et->frame);
+        av_freep(&ost->enc_thread);
+    }
+
+    return err;
+}
+
+static int enc_thread_submit(EncoderThread *et, AVFrame *frame)
+{
+    int ret;
+
+    ret = atomic_load(&et->ret);
+    if (ret < 0)
+        return ret;
+
+    if (!frame) {
+        /* the encoder is flushed on its thread, as seen from here it is done */
+        et->flushed = 1;
+        tq_send_finish(et->tq, 0);
+        return AVERROR_EOF;
+    }
+
+    /* the caller may still use the frame (e.g. duplicated video frames) */
+    ret = av_frame_ref(et->frame, frame);
+    if (ret < 0)
+        return ret;
+
+    ret = tq_send(et->tq, 0, et->frame);
+    if (ret < 0) {
+        av_frame_unref(et->frame);
+        /* the encoder thread stopped receiving after an error */
+        if (ret == AVERROR_EOF && atomic_load(&et->ret) < 0)
+            ret = atomic_load(&et->ret);
+    }
+
+    return ret;
+}
+
+static int encode_or_submit_frame(OutputFile *of, OutputStream *ost, AVFrame *frame)
+{
+    if (!ost->enc_thread && enc_thread_eligible(of, ost)) {
+        int ret = enc_thread_start(of, ost);
+        if (ret < 0) {
+            av_log(ost, AV_LOG_ERROR, "Error starting the encoder thread: %s\n",
+                   av_err2str(ret));
+            return ret;
+        }
+    }
+
+    if (ost->enc_thread)
+        return enc_thread_submit(ost->enc_thread, frame);
+    return encode_frame(of, ost, frame);
+}
+
 static int submit_encode_frame(OutputFile *of, OutputStream *ost,
                                AVFrame *frame)
 {
     int ret;
 
     if (ost->sq_idx_encode < 0)
-        return encode_frame(of, ost, frame);
+        return encode_or_submit_frame(of, ost, frame);
 
     if (frame) {
         ret = av_frame_ref(ost->sq_frame, frame);
@@ -1030,7 +1315,7 @@ static int submit_encode_frame(OutputFile *of, OutputStream *ost,
             return (ret == AVERROR(EAGAIN)) ? 0 : ret;
         }
 
-        ret = encode_frame(of, ost, enc_frame);
+        ret = encode_or_submit_frame(of, ost, enc_frame);
         if (enc_frame)
             av_frame_unref(enc_frame);
         if (ret < 0) {
@@ -1116,7 +1401,7 @@ static void do_subtitle_out(OutputFile *of,
         if (i == 1)
             sub->num_rects = 0;
 
-        ost->frames_encoded++;
+        atomic_fetch_add(&ost->frames_encoded, 1);
 
         subtitle_out_size = avcodec_encode_subtitle(enc, pkt->data, pkt->size, sub);
         if (i == 1)
@@ -1140,7 +1425,7 @@ static void do_subtitle_out(OutputFile *of,
         }
         pkt->dts = pkt->pts;
 
-        of_output_packet(of, pkt, ost, 0);
+        output_packet(of, pkt, ost, 0);
     }
 }
 
@@ -1377,7 +1662,7 @@ static void do_video_out(OutputFile *of,
  *
  * @return  0 for success, <0 for severe errors
  */
-static int reap_filters(int flush)
+static int reap_filters_internal(int flush)
 {
     AVFrame *filtered_frame = NULL;
 
@@ -1465,6 +1750,14 @@ static int reap_filters(int flush)
     return 0;
 }
 
+static int reap_filters(int flush)
+{
+    int stage = native_job_report_stage_enter(NATIVE_JOB_STAGE_FILTER);
+    int ret = reap_filters_internal(flush);
+    native_job_report_stage_leave(stage);
+    return ret;
+}
+
 static void print_final_stats(int64_t total_size)
 {
     uint64_t video_size = 0, audio_size = 0, extra_size = 0, other_size = 0;
@@ -1560,9 +1853,9 @@ static void print_final_stats(int64_t total_size)
                    i, j, av_get_media_type_string(type));
             if (ost->enc_ctx) {
                 av_log(NULL, AV_LOG_VERBOSE, "%" PRIu64" frames encoded",
-                       ost->frames_encoded);
+                       atomic_load(&ost->frames_encoded));
                 if (type == AVMEDIA_TYPE_AUDIO)
-                    av_log(NULL, AV_LOG_VERBOSE, " (%" PRIu64" samples)", ost->samples_encoded);
+                    av_log(NULL, AV_LOG_VERBOSE, " (%" PRIu64" samples)", atomic_load(&ost->samples_encoded));
                 av_log(NULL, AV_LOG_VERBOSE, "; ");
             }
 
@@ -1585,6 +1878,62 @@ static void print_final_stats(int64_t total_size)
     }
 }
 
+// 命令结束时将统计写入所属命令的报告; 每次执行都会收集, 与 -benchmark 无关;
+static void report_job_summary(void)
+{
+    NativeJobSummary summary = { 0 };
+    ObjPoolStats packet_pool, frame_pool;
+
+    if (!native_job_report_current())
+        return;
+
+    objpool_job_stats(&packet_pool, &frame_pool);
+    summary.packet_pool.hits       = packet_pool.hits;
+    summary.packet_pool.misses     = packet_pool.misses;
+    summary.packet_pool.discarded  = packet_pool.discarded;
+    summary.packet_pool.high_water = packet_pool.high_water;
+    summary.frame_pool.hits        = frame_pool.hits;
+    summary.frame_pool.misses      = frame_pool.misses;
+    summary.frame_pool.discarded   = frame_pool.discarded;
+    summary.frame_pool.high_water  = frame_pool.high_water;
+
+    summary.frames_decoded = decode_error_stat[0];
+    summary.decode_errors  = decode_error_stat[1];
+    summary.dup_frames     = nb_frames_dup;
+    summary.drop_frames    = nb_frames_drop;
+
+    for (InputStream *ist = ist_iter(NULL); ist && summary.nb_streams < NATIVE_REPORT_MAX_STREAMS; ist = ist_iter(ist)) {
+        NativeStreamReport *sr = &summary.streams[summary.nb_streams++];
+        sr->file_index    = ist->file_index;
+        sr->stream_index  = ist->st->index;
+        sr->media_type    = ist->par->codec_type;
+        sr->is_output     = 0;
+        av_strlcpy(sr->codec_name, ist->decoding_needed && ist->dec ? ist->dec->name : avcodec_get_name(ist->par->codec_id),
+                   sizeof(sr->codec_name));
+        sr->packets       = ist->nb_packets;
+        sr->frames        = ist->frames_decoded;
+        sr->samples       = ist->samples_decoded;
+        sr->bytes         = ist->data_size;
+        sr->decode_errors = ist->decode_errors;
+    }
+
+    for (OutputStream *ost = ost_iter(NULL); ost && summary.nb_streams < NATIVE_REPORT_MAX_STREAMS; ost = ost_iter(ost)) {
+        NativeStreamReport *sr = &summary.streams[summary.nb_streams++];
+        sr->file_index    = ost->file_index;
+        sr->stream_index  = ost->index;
+        sr->media_type    = ost->st->codecpar->codec_type;
+        sr->is_output     = 1;
+        av_strlcpy(sr->codec_name, ost->enc_ctx && ost->enc_ctx->codec ? ost->enc_ctx->codec->name : "copy",
+                   sizeof(sr->codec_name));
+        sr->packets       = atomic_load(&ost->packets_written);
+        sr->frames        = atomic_load(&ost->frames_encoded);
+        sr->samples       = atomic_load(&ost->samples_encoded);
+        sr->bytes         = ost->data_size_mux;
+    }
+
+    native_job_report_set_summary(&summary);
+}
+
 static void print_report(int is_last_report, int64_t timer_start, int64_t cur_time)
 {
     AVBPrint buf, buf_script;
@@ -1597,6 +1946,8 @@ static void print_report(int is_last_report, int64_t timer_start, int64_t cur_ti
     const char *hours_sign;
     int ret;
     float t;
+    NativeProgress progress;
+    int report_progress_stats;
 
     if (!print_stats && !is_last_report && !progress_avio)
         return;
@@ -1616,9 +1967,28 @@ static void print_report(int is_last_report, int64_t timer_start, int64_t cur_ti
     vid = 0;
     av_bprint_init(&buf, 0, AV_BPRINT_SIZE_AUTOMATIC);
     av_bprint_init(&buf_script, 0, AV_BPRINT_SIZE_AUTOMATIC);
+    // 结构化的进度信息, 仅在设置了对应回调时填充;
+    report_progress_stats = native_progress_stats_enabled();
+    if (report_progress_stats) {
+        memset(&progress, 0, offsetof(NativeProgress, outputs));
+        progress.frame = -1;
+        progress.fps = -1;
+    }
     for (OutputStream *ost = ost_iter(NULL); ost; ost = ost_iter(ost)) {
         const AVCodecContext * const enc = ost->enc_ctx;
-        const float q = enc ? ost->quality / (float) FF_QP2LAMBDA : -1;
+        const float q = enc ? atomic_load(&ost->quality) / (float) FF_QP2LAMBDA : -1;
+
+        if (report_progress_stats && progress.nb_outputs < NATIVE_PROGRESS_MAX_OUTPUTS) {
+            NativeOutputProgress *op = &progress.outputs[progress.nb_outputs++];
+            op->file_index      = ost->file_index;
+            op->stream_index    = ost->index;
+            op->media_type      = ost->st->codecpar->codec_type;
+            op->q               = q;
+            op->packets_written = atomic_load(&ost->packets_written);
+            op->frames_encoded  = atomic_load(&ost->frames_encoded);
+            op->data_size       = ost->data_size_mux;
+            op->out_time_us     = ost->last_mux_dts == AV_NOPTS_VALUE ? -1 : ost->last_mux_dts;
+        }
 
         if (vid && ost->st->codecpar->codec_type == AVMEDIA_TYPE_VIDEO) {
             av_bprintf(&buf, "q=%2.1f ", q);
@@ -1634,6 +2004,10 @@ static void print_report(int is_last_report, int64_t timer_start, int64_t cur_ti
                      frame_number, fps < 9.95, fps, q);
             av_bprintf(&buf_script, "frame=%" PRId64"\n", frame_number);
             av_bprintf(&buf_script, "fps=%.2f\n", fps);
+            if (report_progress_stats) {
+                progress.frame = frame_number;
+                progress.fps = fps;
+            }
             av_bprintf(&buf_script, "stream_%d_%d_q=%.1f\n",
                        ost->file_index, ost->index, q);
             if (is_last_report)
@@ -1648,7 +2022,7 @@ static void print_report(int is_last_report, int64_t timer_start, int64_t cur_ti
             }
 
             if (enc && (enc->flags & AV_CODEC_FLAG_PSNR) &&
-                (ost->pict_type != AV_PICTURE_TYPE_NONE || is_last_report)) {
+                (atomic_load(&ost->pict_type) != AV_PICTURE_TYPE_NONE || is_last_report)) {
                 int j;
                 double error, error_sum = 0;
                 double scale, scale_sum = 0;
@@ -1660,7 +2034,7 @@ static void print_report(int is_last_report, int64_t timer_start, int64_t cur_ti
                         error = enc->error[j];
                         scale = enc->width * enc->height * 255.0 * 255.0 * frame_number;
                     } else {
-                        error = ost->error[j];
+                        error = atomic_load(&ost->error[j]);
                         scale = enc->width * enc->height * 255.0 * 255.0;
                     }
                     if (j)
@@ -1763,6 +2137,19 @@ static void print_report(int is_last_report, int64_t timer_start, int64_t cur_ti
     av_bprintf(&buf_script, "progress=%s\n", is_last_report ? "end" : "continue");
     native_report_progress(buf_script.str);
 
+    if (report_progress_stats) {
+        progress.out_time_us = pts == AV_NOPTS_VALUE ? -1 : pts;
+        progress.total_size  = total_size;
+        progress.bitrate     = bitrate < 0 ? -1 : bitrate * 1000;
+        progress.speed       = speed;
+        progress.dup_frames  = nb_frames_dup;
+        progress.drop_frames = nb_frames_drop;
+        progress.is_last     = is_last_report;
+        progress.throttled   = native_job_control_is_throttled(native_job_control_current());
+        progress.throttled_time_us = native_job_control_throttled_time(native_job_control_current());
+        native_report_progress_stats(&progress);
+    }
+
     if (progress_avio) {
         avio_write(progress_avio, (const unsigned char *)buf_script.str, FFMIN(buf_script.len, buf_script.size - 1));
         avio_flush(progress_avio);
@@ -1843,7 +2230,7 @@ static void flush_encoders(void)
                     exit_program(1);
                 }
 
-                of_output_packet(of, ost->pkt, ost, 1);
+                output_packet(of, ost->pkt, ost, 1);
             }
 
             init_output_stream_wrapper(ost, NULL, 1);
@@ -1888,7 +2275,7 @@ static void do_streamcopy(InputStream *ist, OutputStream *ost, const AVPacket *p
     av_packet_unref(opkt);
     // EOF: flush output bitstream filters.
     if (!pkt) {
-        of_output_packet(of, opkt, ost, 1);
+        output_packet(of, opkt, ost, 1);
         return;
     }
 
@@ -1956,7 +2343,7 @@ static void do_streamcopy(InputStream *ist, OutputStream *ost, const AVPacket *p
         }
     }
 
-    of_output_packet(of, opkt, ost, 0);
+    output_packet(of, opkt, ost, 0);
 
     ost->streamcopy_started = 1;
 }
@@ -1966,6 +2353,9 @@ static void check_decode_result(InputStream *ist, int *got_output, int ret)
     if (*got_output || ret<0)
         decode_error_stat[ret<0] ++;
 
+    if (ret < 0 && ist)
+        ist->decode_errors++;
+
     if (ret < 0 && exit_on_error)
         exit_program(1);
 
@@ -2141,11 +2531,337 @@ static int decode(InputStream *ist, AVCodecContext *avctx,
     return 0;
 }
 
+/*
+ * -decoder_threads: every decoded audio input stream gets a thread that runs
+ * decode() on the packets sent by the main thread and hands the frames back
+ * through a bounded queue. Timestamp fixups and filtering stay on the main
+ * thread, so several inputs (e.g. the tracks of an amix) decode in parallel.
+ */
+typedef struct DecoderPacket {
+    /* packet to decode, NULL requests avcodec_flush_buffers() */
+    AVPacket *pkt;
+    /* ist->dts when the packet was submitted, in AV_TIME_BASE */
+    int64_t   dts;
+} DecoderPacket;
+
+typedef struct DecoderThread {
+    InputStream *ist;
+
+    /* DecoderPacket */
+    AVThreadMessageQueue *in_queue;
+    /* DecodedMsg */
+    AVThreadMessageQueue *out_queue;
+    pthread_t             thread;
+
+    ObjPool              *pkt_pool;
+    ObjPool              *frame_pool;
+
+    /* main thread state */
+    AVPacket             *pending;  // packet not accepted by in_queue yet
+    int64_t               pending_dts;
+    int                   draining; // 1: drain packet sent, 2: decoder returned EOF
+    int                   err;      // error to report once pending is sent
+    /* timestamps of the packet the last returned frame started */
+    AVPacket             *src_pkt;
+    int                   has_src_pkt;
+    /* dts fallback for the last returned frame, in AV_TIME_BASE; the
+     * main thread's ist->dts has already moved on to later packets */
+    int64_t               src_dts;
+    /* decoder parameters as of the last returned frame, the decoder
+     * context itself belongs to the thread */
+    int                   bits_per_raw_sample;
+
+    void                 *job_report;
+} DecoderThread;
+
+typedef struct DecodedMsg {
+    /* decoded frame, or NULL once the packet was consumed; ret is then the
+     * decode() status (0, an error or AVERROR_EOF) */
+    AVFrame *frame;
+    int      ret;
+
+    /* frame is the first one output for a packet with these timestamps */
+    int      has_pkt;
+    int64_t  pkt_pts;
+    int64_t  pkt_duration;
+    int64_t  pkt_dts;
+
+    int      bits_per_raw_sample;
+} DecodedMsg;
+
+static int dec_thread_packet(DecoderThread *dt, const DecoderPacket *dp)
+{
+    InputStream *ist = dt->ist;
+    AVPacket    *pkt = dp->pkt;
+    DecodedMsg   msg = { .has_pkt      = 1,
+                         .pkt_pts      = pkt->pts,
+                         .pkt_duration = pkt->duration,
+                         .pkt_dts      = dp->dts };
+    int ret;
+
+    while (1) {
+        int got_frame = 0, stage;
+
+        ret = objpool_get(dt->frame_pool, (void**)&msg.frame);
+        if (ret < 0)
+            break;
+
+        stage = native_job_report_stage_enter(NATIVE_JOB_STAGE_DECODE);
+        ret = decode(ist, ist->dec_ctx, msg.frame, &got_frame, pkt);
+        native_job_report_stage_leave(stage);
+        pkt = NULL;
+
+        if (!got_frame) {
+            objpool_release(dt->frame_pool, (void**)&msg.frame);
+            break;
+        }
+
+        msg.ret                 = 0;
+        msg.bits_per_raw_sample = ist->dec_ctx->bits_per_raw_sample;
+        ret = av_thread_message_queue_send(dt->out_queue, &msg, 0);
+        if (ret < 0) {
+            objpool_release(dt->frame_pool, (void**)&msg.frame);
+            return ret;
+        }
+        msg.has_pkt = 0;
+    }
+
+    /* always report the consumed packet, the main thread may be waiting for
+     * room in in_queue */
+    msg.frame = NULL;
+    msg.ret   = ret;
+    return av_thread_message_queue_send(dt->out_queue, &msg, 0);
+}
+
+static void *decoder_thread(void *arg)
+{
+    DecoderThread *dt = arg;
+    InputStream  *ist = dt->ist;
+    char name[16];
+
+    native_job_report_bind(dt->job_report);
+
+    snprintf(name, sizeof(name), "dec%d:%d", ist->file_index, ist->st->index);
+    ff_thread_setname(name);
+
+    while (1) {
+        DecoderPacket dp;
+        int ret;
+
+        ret = av_thread_message_queue_recv(dt->in_queue, &dp, 0);
+        if (ret < 0)
+            break;
+
+        /* the input is looped, start over */
+        if (!dp.pkt) {
+            avcodec_flush_buffers(ist->dec_ctx);
+            continue;
+        }
+
+        ret = dec_thread_packet(dt, &dp);
+        objpool_release(dt->pkt_pool, (void**)&dp.pkt);
+        if (ret < 0)
+            break;
+    }
+
+    native_job_report_thread_finish();
+
+    return NULL;
+}
+
+static int dec_thread_start(InputStream *ist)
+{
+    DecoderThread *dt;
+    int ret;
+
+    dt = av_mallocz(sizeof(*dt));
+    if (!dt)
+        return AVERROR(ENOMEM);
+    dt->ist        = ist;
+    dt->job_report = native_job_report_current();
+    dt->src_dts    = AV_NOPTS_VALUE;
+
+    dt->pkt_pool   = objpool_job_packets();
+    dt->frame_pool = objpool_job_frames();
+    if (!dt->pkt_pool || !dt->frame_pool) {
+        dt->pkt_pool = dt->frame_pool = NULL;
+        ret = AVERROR(ENOMEM);
+        goto fail;
+    }
+    dt->pkt_pool   = objpool_ref(dt->pkt_pool);
+    dt->frame_pool = objpool_ref(dt->frame_pool);
+
+    dt->src_pkt = av_packet_alloc();
+    if (!dt->src_pkt) {
+        ret = AVERROR(ENOMEM);
+        goto fail;
+    }
+
+    ret = av_thread_message_queue_alloc(&dt->in_queue, 8, sizeof(DecoderPacket));
+    if (ret < 0)
+        goto fail;
+    ret = av_thread_message_queue_alloc(&dt->out_queue, 8, sizeof(DecodedMsg));
+    if (ret < 0)
+        goto fail;
+
+    ret = pthread_create(&dt->thread, NULL, decoder_thread, dt);
+    if (ret) {
+        ret = AVERROR(ret);
+        goto fail;
+    }
+    native_thread_budget_add(NATIVE_THREAD_DECODE, 1);
+
+    ist->dec_thread = dt;
+    return 0;
+
+fail:
+    av_thread_message_queue_free(&dt->in_queue);
+    av_thread_message_queue_free(&dt->out_queue);
+    av_packet_free(&dt->src_pkt);
+    objpool_free(&dt->pkt_pool);
+    objpool_free(&dt->frame_pool);
+    av_freep(&dt);
+    return ret;
+}
+
+static void dec_threads_stop(void)
+{
+    for (InputStream *ist = ist_iter(NULL); ist; ist = ist_iter(ist)) {
+        DecoderThread *dt = ist->dec_thread;
+        DecoderPacket dp;
+        DecodedMsg msg;
+
+        if (!dt)
+            continue;
+
+        av_thread_message_queue_set_err_recv(dt->in_queue, AVERROR_EOF);
+        av_thread_message_queue_set_err_send(dt->out_queue, AVERROR_EOF);
+        pthread_join(dt->thread, NULL);
+        native_thread_budget_add(NATIVE_THREAD_DECODE, -1);
+
+        while (av_thread_message_queue_recv(dt->in_queue, &dp,
+                                            AV_THREAD_MESSAGE_NONBLOCK) >= 0)
+            objpool_release(dt->pkt_pool, (void**)&dp.pkt);
+        while (av_thread_message_queue_recv(dt->out_queue, &msg,
+                                            AV_THREAD_MESSAGE_NONBLOCK) >= 0)
+            objpool_release(dt->frame_pool, (void**)&msg.frame);
+        objpool_release(dt->pkt_pool, (void**)&dt->pending);
+
+        av_thread_message_queue_free(&dt->in_queue);
+        av_thread_message_queue_free(&dt->out_queue);
+        av_packet_free(&dt->src_pkt);
+        objpool_free(&dt->pkt_pool);
+        objpool_free(&dt->frame_pool);
+        av_freep(&ist->dec_thread);
+    }
+}
+
+/* Receive one message from the decoder thread, see dec_thread_decode(). */
+static int dec_thread_receive(DecoderThread *dt, AVFrame *frame, int *got_frame,
+                              int flags)
+{
+    DecodedMsg msg;
+    int ret;
+
+    ret = av_thread_message_queue_recv(dt->out_queue, &msg, flags);
+    if (ret < 0)
+        return ret;
+
+    if (!msg.frame) {
+        if (msg.ret == AVERROR_EOF)
+            dt->draining = 2;
+        return msg.ret;
+    }
+
+    av_frame_move_ref(frame, msg.frame);
+    objpool_release(dt->frame_pool, (void**)&msg.frame);
+
+    dt->has_src_pkt         = msg.has_pkt;
+    dt->bits_per_raw_sample = msg.bits_per_raw_sample;
+    if (msg.has_pkt) {
+        dt->src_pkt->pts      = msg.pkt_pts;
+        dt->src_pkt->duration = msg.pkt_duration;
+        dt->src_dts           = msg.pkt_dts;
+    }
+
+    *got_frame = 1;
+    return 0;
+}
+
+/*
+ * Same contract as decode(), but the packet is queued to the decoder thread
+ * and a frame is returned as soon as one is available. Blocks only while the
+ * packet does not fit into the queue or while draining the decoder.
+ */
+static int dec_thread_decode(InputStream *ist, AVFrame *frame, int *got_frame,
+                             AVPacket *pkt)
+{
+    DecoderThread *dt = ist->dec_thread;
+    int ret;
+
+    *got_frame = 0;
+    dt->has_src_pkt = 0;
+
+    if (dt->draining == 2)
+        return AVERROR_EOF;
+
+    if (pkt && !dt->draining) {
+        av_assert0(!dt->pending);
+
+        /* an empty packet starts draining the decoder */
+        if (!pkt->data && !pkt->side_data_elems)
+            dt->draining = 1;
+
+        ret = objpool_get(dt->pkt_pool, (void**)&dt->pending);
+        if (ret < 0)
+            return ret;
+        av_packet_move_ref(dt->pending, pkt);
+        dt->pending_dts = ist->dts;
+    }
+
+    while (1) {
+        int flags;
+
+        if (dt->pending) {
+            DecoderPacket dp = { .pkt = dt->pending, .dts = dt->pending_dts };
+
+            ret = av_thread_message_queue_send(dt->in_queue, &dp,
+                                               AV_THREAD_MESSAGE_NONBLOCK);
+            if (ret >= 0)
+                dt->pending = NULL;
+            else if (ret != AVERROR(EAGAIN))
+                return ret;
+        }
+
+        flags = (dt->pending || dt->draining) ? 0 : AV_THREAD_MESSAGE_NONBLOCK;
+        ret = dec_thread_receive(dt, frame, got_frame, flags);
+        if (*got_frame)
+            return 0;
+        if (ret == AVERROR(EAGAIN)) {
+            /* nothing decoded yet, continue with the next packet */
+            ret = dt->err;
+            dt->err = 0;
+            return ret;
+        }
+        if (ret < 0 && ret != AVERROR_EOF) {
+            /* the packet must be queued before reporting the error */
+            if (dt->pending) {
+                dt->err = ret;
+                continue;
+            }
+            return ret;
+        }
+        if (ret == AVERROR_EOF)
+            return ret;
+    }
+}
+
 static int send_frame_to_filters(InputStream *ist, AVFrame *decoded_frame)
 {
-    int i, ret;
+    int i, ret, stage;
 
     av_assert1(ist->nb_filters > 0); /* ensure ret is initialized */
+    stage = native_job_report_stage_enter(NATIVE_JOB_STAGE_FILTER);
     for (i = 0; i < ist->nb_filters; i++) {
         ret = ifilter_send_frame(ist->filters[i], decoded_frame, i < ist->nb_filters - 1);
         if (ret == AVERROR_EOF)
@@ -2156,6 +2872,7 @@ static int send_frame_to_filters(InputStream *ist, AVFrame *decoded_frame)
             break;
         }
     }
+    native_job_report_stage_leave(stage);
     return ret;
 }
 
@@ -2164,11 +2881,29 @@ static int decode_audio(InputStream *ist, AVPacket *pkt, int *got_output,
 {
     AVFrame *decoded_frame = ist->decoded_frame;
     AVCodecContext *avctx = ist->dec_ctx;
-    int ret, err = 0;
+    int ret, err = 0, stage;
     AVRational decoded_frame_tb;
 
+    if (decoder_threads && !ist->dec_thread) {
+        ret = dec_thread_start(ist);
+        if (ret < 0) {
+            av_log(NULL, AV_LOG_ERROR, "Error starting the decoder thread for "
+                   "stream #%d:%d: %s\n", ist->file_index, ist->st->index,
+                   av_err2str(ret));
+            return ret;
+        }
+    }
+
     update_benchmark(NULL);
-    ret = decode(ist, avctx, decoded_frame, got_output, pkt);
+    if (ist->dec_thread) {
+        ret = dec_thread_decode(ist, decoded_frame, got_output, pkt);
+        /* the timestamps below refer to the packet the frame came from */
+        pkt = ist->dec_thread->has_src_pkt ? ist->dec_thread->src_pkt : NULL;
+    } else {
+        stage = native_job_report_stage_enter(NATIVE_JOB_STAGE_DECODE);
+        ret = decode(ist, avctx, decoded_frame, got_output, pkt);
+        native_job_report_stage_leave(stage);
+    }
     update_benchmark("decode_audio %d.%d", ist->file_index, ist->st->index);
     if (ret < 0)
         *decode_failed = 1;
@@ -2195,9 +2930,12 @@ static int decode_audio(InputStream *ist, AVPacket *pkt, int *got_output,
         decoded_frame->pts = pkt->pts;
         decoded_frame_tb   = ist->st->time_base;
     }else {
-        decoded_frame->pts = ist->dts;
+        decoded_frame->pts = ist->dec_thread ? ist->dec_thread->src_dts : ist->dts;
         decoded_frame_tb   = AV_TIME_BASE_Q;
     }
+    if (ist->dec_thread && ist->dec_thread->src_dts != AV_NOPTS_VALUE)
+        ist->dec_thread->src_dts += ((int64_t)AV_TIME_BASE * decoded_frame->nb_samples) /
+                                    decoded_frame->sample_rate;
     if (pkt && pkt->duration && ist->prev_pkt_pts != AV_NOPTS_VALUE &&
         pkt->pts != AV_NOPTS_VALUE && pkt->pts - ist->prev_pkt_pts > pkt->duration)
         ist->filter_in_rescale_delta_last = AV_NOPTS_VALUE;
@@ -2220,7 +2958,7 @@ static int decode_video(InputStream *ist, AVPacket *pkt, int *got_output, int64_
                         int *decode_failed)
 {
     AVFrame *decoded_frame = ist->decoded_frame;
-    int i, ret = 0, err = 0;
+    int i, ret = 0, err = 0, stage;
     int64_t best_effort_timestamp;
     int64_t dts = AV_NOPTS_VALUE;
 
@@ -2247,7 +2985,9 @@ static int decode_video(InputStream *ist, AVPacket *pkt, int *got_output, int64_
     }
 
     update_benchmark(NULL);
+    stage = native_job_report_stage_enter(NATIVE_JOB_STAGE_DECODE);
     ret = decode(ist, ist->dec_ctx, decoded_frame, got_output, pkt);
+    native_job_report_stage_leave(stage);
     update_benchmark("decode_video %d.%d", ist->file_index, ist->st->index);
     if (ret < 0)
         *decode_failed = 1;
@@ -2533,10 +3273,14 @@ static int transcode_subtitles(InputStream *ist, const AVPacket *pkt,
                                int *got_output, int *decode_failed)
 {
     AVSubtitle subtitle;
+    int stage = native_job_report_stage_enter(NATIVE_JOB_STAGE_DECODE);
     int ret = avcodec_decode_subtitle2(ist->dec_ctx,
                                        &subtitle, got_output, pkt);
+    native_job_report_stage_leave(stage);
 
     check_decode_result(NULL, got_output, ret);
+    if (ret < 0)
+        ist->decode_errors++;
 
     if (ret < 0 || !*got_output) {
         *decode_failed = 1;
@@ -2807,6 +3551,28 @@ static enum AVPixelFormat get_format(AVCodecContext *s, const enum AVPixelFormat
     return *p;
 }
 
+// 未指定 threads 时按线程预算分配, 未开启线程预算时使用 auto;
+static void set_default_codec_threads(AVDictionary **opts)
+{
+    int nb_threads;
+
+    if (av_dict_get(*opts, "threads", NULL, 0))
+        return;
+    nb_threads = native_thread_budget_share();
+    if (nb_threads > 0)
+        av_dict_set_int(opts, "threads", nb_threads, 0);
+    else
+        av_dict_set(opts, "threads", "auto", 0);
+}
+
+// 编解码器打开后实际使用的线程数量, 单线程时在调用线程中执行, 不计入;
+// 计入的数量记录在 nb_budget_threads 中, 关闭编解码器时释放;
+static void report_codec_threads(const AVCodecContext *avctx, int *nb_budget_threads)
+{
+    *nb_budget_threads = avctx->thread_count > 1 ? avctx->thread_count : 0;
+    native_thread_budget_add(NATIVE_THREAD_CODEC, *nb_budget_threads);
+}
+
 static int init_input_stream(InputStream *ist, char *error, int error_len)
 {
     int ret;
@@ -2833,8 +3599,7 @@ static int init_input_stream(InputStream *ist, char *error, int error_len)
          * audio, and video decoders such as cuvid or mediacodec */
         ist->dec_ctx->pkt_timebase = ist->st->time_base;
 
-        if (!av_dict_get(ist->decoder_opts, "threads", NULL, 0))
-            av_dict_set(&ist->decoder_opts, "threads", "auto", 0);
+        set_default_codec_threads(&ist->decoder_opts);
         /* Attached pics are sparse, therefore we would not want to delay their decoding till EOF. */
         if (ist->st->disposition & AV_DISPOSITION_ATTACHED_PIC)
             av_dict_set(&ist->decoder_opts, "threads", "1", 0);
@@ -2857,6 +3622,7 @@ static int init_input_stream(InputStream *ist, char *error, int error_len)
                      ist->file_index, ist->st->index, av_err2str(ret));
             return ret;
         }
+        report_codec_threads(ist->dec_ctx, &ist->nb_budget_threads);
         assert_avoptions(ist->decoder_opts);
     }
 
@@ -3095,7 +3861,11 @@ static int init_output_stream_encode(OutputStream *ost, AVFrame *frame)
         if (ost->bits_per_raw_sample)
             enc_ctx->bits_per_raw_sample = ost->bits_per_raw_sample;
         else if (dec_ctx && ost->filter->graph->is_meta)
-            enc_ctx->bits_per_raw_sample = FFMIN(dec_ctx->bits_per_raw_sample,
+            /* a decoder thread owns dec_ctx, use what it reported with the
+             * decoded frames */
+            enc_ctx->bits_per_raw_sample = FFMIN(ist->dec_thread ?
+                                                 ist->dec_thread->bits_per_raw_sample :
+                                                 dec_ctx->bits_per_raw_sample,
                                                  av_get_bytes_per_sample(enc_ctx->sample_fmt) << 3);
 
         init_encoder_time_base(ost, av_make_q(1, enc_ctx->sample_rate));
@@ -3230,8 +4000,7 @@ static int init_output_stream(OutputStream *ost, AVFrame *frame,
         if (ret < 0)
             return ret;
 
-        if (!av_dict_get(ost->encoder_opts, "threads", NULL, 0))
-            av_dict_set(&ost->encoder_opts, "threads", "auto", 0);
+        set_default_codec_threads(&ost->encoder_opts);
 
         if (codec->capabilities & AV_CODEC_CAP_ENCODER_REORDERED_OPAQUE) {
             ret = av_dict_set(&ost->encoder_opts, "flags", "+copy_opaque", AV_DICT_MULTIKEY);
@@ -3256,6 +4025,7 @@ static int init_output_stream(OutputStream *ost, AVFrame *frame,
                     ost->file_index, ost->index);
             return ret;
         }
+        report_codec_threads(ost->enc_ctx, &ost->nb_budget_threads);
         if (codec->type == AVMEDIA_TYPE_AUDIO &&
             !(codec->capabilities & AV_CODEC_CAP_VARIABLE_FRAME_SIZE))
             av_buffersink_set_frame_size(ost->filter->filter,
@@ -3680,7 +4450,13 @@ static void decode_flush(InputFile *ifile)
                 av_thread_message_queue_send(ifile->audio_duration_queue, &dur, 0);
             }
 
-            avcodec_flush_buffers(ist->dec_ctx);
+            if (ist->dec_thread) {
+                /* the decoder is owned by its thread, which is idle after EOF */
+                DecoderPacket flush = { .pkt = NULL };
+                av_thread_message_queue_send(ist->dec_thread->in_queue, &flush, 0);
+                ist->dec_thread->draining = 0;
+            } else
+                avcodec_flush_buffers(ist->dec_ctx);
         }
     }
 }
@@ -3816,7 +4592,7 @@ static int process_input(int file_index)
                 if (ost->ist == ist &&
                     (!ost->enc_ctx || ost->enc_ctx->codec_type == AVMEDIA_TYPE_SUBTITLE)) {
                     OutputFile *of = output_files[ost->file_index];
-                    of_output_packet(of, ost->pkt, ost, 1);
+                    output_packet(of, ost->pkt, ost, 1);
                 }
             }
         }
@@ -4028,6 +4804,8 @@ static int transcode(void)
     InputStream *ist;
     int64_t timer_start;
     int64_t total_packets_written = 0;
+    void *job_control = native_job_control_current();
+    NativeJobPacer cpu_pacer = { 0 };
 
     ret = transcode_init();
     if (ret < 0)
@@ -4053,12 +4831,27 @@ static int transcode(void)
             break;
         }
 
+        // 暂停时在 packet 之间等待; 暂停的时长不计入处理速度;
+        if (job_control) {
+            int64_t paused_time = native_job_control_wait(job_control, &int_cb);
+            if (paused_time > 0) {
+                timer_start += paused_time;
+                cpu_pacer.slice_start_us = 0;
+                cur_time = av_gettime_relative();
+                if (int_cb.callback(int_cb.opaque))
+                    break;
+            }
+        }
+
         ret = transcode_step();
         if (ret < 0 && ret != AVERROR_EOF) {
             av_log(NULL, AV_LOG_ERROR, "Error while filtering: %s\n", av_err2str(ret));
             break;
         }
 
+        // 限制 cpu 占比; 限速等待的时长计入处理速度;
+        native_job_control_pace_cpu(job_control, &cpu_pacer, &int_cb);
+
         /* dump report by using the output first video and audio streams */
         print_report(0, timer_start, cur_time);
     }
@@ -4071,6 +4864,13 @@ static int transcode(void)
     }
     flush_encoders();
 
+    /* wait for the encoder threads to drain before the muxers are stopped */
+    ret = enc_threads_stop(0);
+    if (ret < 0) {
+        av_log(NULL, AV_LOG_ERROR, "Error while encoding: %s\n", av_err2str(ret));
+        exit_program(1);
+    }
+
     term_exit();
 
     /* write the trailer if needed */
@@ -4154,6 +4954,15 @@ static int64_t getmaxrss(void)
 
 OptionDef *opt_get_ffmpeg_options(void);
 
+// 常驻线程缓存选项表; 选项中引用了线程局部变量的地址, 因此每个线程各自创建;
+static OptionDef *ffmpeg_acquire_options(void) {
+    if (!fftools_thread_is_warm())
+        return opt_get_ffmpeg_options();
+    if (!ffmpeg_options_cache)
+        ffmpeg_options_cache = opt_get_ffmpeg_options();
+    return ffmpeg_options_cache;
+}
+
 static void ffmpeg_reset_thread_variables(void) {
     main_return_code = 0;
     exit_value = 0;
@@ -4176,6 +4985,8 @@ static void ffmpeg_reset_thread_variables(void) {
     nb_output_files = 0;
     nb_filtergraphs = 0;
     restore_tty = 0;
+    encoder_threads = 0;
+    decoder_threads = 0;
     
     progress_avio = NULL;
     
@@ -4207,7 +5018,7 @@ int ffmpeg_main(_Atomic bool *is_running, int argc, char **argv)
     
     int ret;
     BenchmarkTimeStamps ti;
-    options = opt_get_ffmpeg_options();
+    options = ffmpeg_acquire_options();
     if ( setjmp(exit_jump_buffer) == 0 ) {
         parse_loglevel(argc, argv, options);
         show_banner(argc, argv, options);
@@ -325,6 +325,8 @@ typedef struct FilterGraph {
     // true when the filtergraph contains only meta filters
     // that do not modify the frame data
     int is_meta;
+    // 已计入线程预算的滤镜线程数量;
+    int nb_budget_threads;
 
     InputFilter   **inputs;
     int          nb_inputs;
@@ -351,6 +353,8 @@ typedef struct InputStream {
      */
     AVCodecParameters *par;
     AVCodecContext *dec_ctx;
+    // 已计入线程预算的解码器线程数量;
+    int nb_budget_threads;
     const AVCodec *dec;
     AVFrame *decoded_frame;
     AVPacket *pkt;
@@ -435,11 +439,17 @@ typedef struct InputStream {
     // number of frames/samples retrieved from the decoder
     uint64_t frames_decoded;
     uint64_t samples_decoded;
+    // number of failed decode calls
+    uint64_t decode_errors;
 
     int64_t *dts_buffer;
     int nb_dts_buffer;
 
     int got_output;
+
+    /* -decoder_threads: audio is decoded on this thread, frames are
+     * handed back to the main thread for filtering */
+    struct DecoderThread *dec_thread;
 } InputStream;
 
 typedef struct LastFrameDuration {
@@ -591,6 +601,8 @@ typedef struct OutputStream {
     AVRational enc_timebase;
 
     AVCodecContext *enc_ctx;
+    // 已计入线程预算的编码器线程数量;
+    int nb_budget_threads;
     AVFrame *filtered_frame;
     AVFrame *last_frame;
     AVFrame *sq_frame;
@@ -637,7 +649,9 @@ typedef struct OutputStream {
     AVDictionary *sws_dict;
     AVDictionary *swr_opts;
     char *apad;
-    OSTFinished finished;        /* no more packets should be written for this stream */
+    /* no more packets should be written for this stream (OSTFinished flags);
+     * atomic since MUXER_FINISHED may be set from an encoder thread */
+    atomic_int finished;
     int unavailable;                     /* true if the steram is unavailable (possibly temporarily) */
 
     // init_output_stream() has been called for this stream
@@ -658,23 +672,24 @@ typedef struct OutputStream {
     // combined size of all the packets sent to the muxer
     uint64_t data_size_mux;
     // combined size of all the packets received from the encoder
-    uint64_t data_size_enc;
+    atomic_uint_least64_t data_size_enc;
     // number of packets send to the muxer
     atomic_uint_least64_t packets_written;
     // number of frames/samples sent to the encoder
-    uint64_t frames_encoded;
-    uint64_t samples_encoded;
+    // (the encoder stats are updated by the encoder thread with -encoder_threads)
+    atomic_uint_least64_t frames_encoded;
+    atomic_uint_least64_t samples_encoded;
     // number of packets received from the encoder
-    uint64_t packets_encoded;
+    atomic_uint_least64_t packets_encoded;
 
     /* packet quality factor */
-    int quality;
+    atomic_int quality;
 
     /* packet picture type */
-    int pict_type;
+    atomic_int pict_type;
 
     /* frame encode sum of squared error values */
-    int64_t error[4];
+    atomic_int_least64_t error[4];
 
     int sq_idx_encode;
     int sq_idx_mux;
@@ -687,6 +702,9 @@ typedef struct OutputStream {
      * subtitles utilizing fix_sub_duration at random access points.
      */
     unsigned int fix_sub_duration_heartbeat;
+
+    /* -encoder_threads: the encoder runs on this thread once the muxer started */
+    struct EncoderThread *enc_thread;
 } OutputStream;
 
 typedef struct OutputFile {
@@ -736,6 +754,8 @@ extern _Thread_local int start_at_zero;
 extern _Thread_local int copy_tb;
 extern _Thread_local int debug_ts;
 extern _Thread_local int exit_on_error;
+extern _Thread_local int encoder_threads;
+extern _Thread_local int decoder_threads;
 extern _Thread_local int abort_on_flags;
 extern _Thread_local int print_stats;
 extern _Thread_local int64_t stats_period;
@@ -822,6 +842,12 @@ void of_close(OutputFile **pof);
 
 void of_enc_stats_close(void);
 
+/*
+ * Whether the muxer thread of the output is running, i.e. packets passed
+ * to of_output_packet() no longer get buffered on the calling thread.
+ */
+int of_muxer_started(OutputFile *of);
+
 /*
  * Send a single packet to the output, applying any bitstream filters
  * associated with the output stream.  This may result in any number
@@ -832,8 +858,11 @@ void of_enc_stats_close(void);
  * If eof is set, instead indicate EOF to all bitstream filters and
  * therefore flush any delayed packets to the output.  A blank packet
  * must be supplied in this case.
+ *
+ * Errors are logged and returned; whether they are fatal (-xerror) is up to
+ * the caller, since this may run on an encoder thread.
  */
-void of_output_packet(OutputFile *of, AVPacket *pkt, OutputStream *ost, int eof);
+int of_output_packet(OutputFile *of, AVPacket *pkt, OutputStream *ost, int eof);
 int64_t of_filesize(OutputFile *of);
 
 int ifile_open(const OptionsContext *o, const char *filename);
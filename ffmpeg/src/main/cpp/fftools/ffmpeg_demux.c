@@ -38,6 +38,11 @@
 
 #include "libavformat/avformat.h"
 
+#include "interaction/mem_io.h"
+#include "av/utils/thread_budget.h"
+#include "interaction/job_control.h"
+#include "interaction/job_report.h"
+
 static const char *const opt_name_discard[]                   = {"discard", NULL};
 static const char *const opt_name_reinit_filters[]            = {"reinit_filter", NULL};
 static const char *const opt_name_fix_sub_duration[]          = {"fix_sub_duration", NULL};
@@ -70,6 +75,13 @@ typedef struct Demuxer {
     int                   thread_queue_size;
     pthread_t             thread;
     int                   non_blocking;
+
+    // 所属命令的控制器, 暂停时读取线程停止读取;
+    void                 *job_control;
+    // 按限速倍率控制取出 packet 的速度;
+    NativeJobPacer        pacer;
+    // 所属命令的报告, 读取线程中统计读取耗时及字节数;
+    void                 *job_report;
 } Demuxer;
 
 typedef struct DemuxMsg {
@@ -240,7 +252,9 @@ static void *input_thread(void *arg)
     InputFile *f = &d->f;
     AVPacket *pkt;
     unsigned flags = d->non_blocking ? AV_THREAD_MESSAGE_NONBLOCK : 0;
-    int ret = 0;
+    int ret = 0, stage;
+
+    native_job_report_bind(d->job_report);
 
     pkt = av_packet_alloc();
     if (!pkt) {
@@ -253,7 +267,10 @@ static void *input_thread(void *arg)
     while (1) {
         DemuxMsg msg = { NULL };
 
+        native_job_control_wait(d->job_control, &f->ctx->interrupt_callback);
+        stage = native_job_report_stage_enter(NATIVE_JOB_STAGE_DEMUX);
         ret = av_read_frame(f->ctx, pkt);
+        native_job_report_stage_leave(stage);
 
         if (ret == AVERROR(EAGAIN)) {
             av_usleep(10000);
@@ -341,6 +358,10 @@ finish:
 
     av_log(NULL, AV_LOG_VERBOSE, "Terminating demuxer thread %d\n", f->index);
 
+    if (f->ctx->pb)
+        native_job_report_add_io(f->ctx->pb->bytes_read, 0);
+    native_job_report_thread_finish();
+
     return NULL;
 }
 
@@ -356,6 +377,7 @@ static void thread_stop(Demuxer *d)
         av_packet_free(&msg.pkt);
 
     pthread_join(d->thread, NULL);
+    native_thread_budget_add(NATIVE_THREAD_DEMUX, -1);
     av_thread_message_queue_free(&d->in_thread_queue);
     av_thread_message_queue_free(&f->audio_duration_queue);
 }
@@ -395,11 +417,14 @@ static int thread_start(Demuxer *d)
         }
     }
 
+    d->job_control = native_job_control_current();
+    d->job_report  = native_job_report_current();
     if ((ret = pthread_create(&d->thread, NULL, input_thread, d))) {
         av_log(NULL, AV_LOG_ERROR, "pthread_create failed: %s. Try to increase `ulimit -v` or decrease `ulimit -s`.\n", strerror(ret));
         ret = AVERROR(ret);
         goto fail;
     }
+    native_thread_budget_add(NATIVE_THREAD_DEMUX, 1);
 
     return 0;
 fail:
@@ -450,6 +475,11 @@ int ifile_get_packet(InputFile *f, AVPacket **pkt)
     ist = f->streams[msg.pkt->stream_index];
     ist->last_pkt_repeat_pict = msg.repeat_pict;
 
+    if (d->job_control && msg.pkt->dts != AV_NOPTS_VALUE)
+        native_job_control_pace_media(d->job_control, &d->pacer,
+                                      av_rescale_q(msg.pkt->dts, ist->st->time_base, AV_TIME_BASE_Q),
+                                      &f->ctx->interrupt_callback);
+
     *pkt = msg.pkt;
     return 0;
 }
@@ -470,6 +500,8 @@ static void ist_free(InputStream **pist)
     av_freep(&ist->hwaccel_device);
     av_freep(&ist->dts_buffer);
 
+    native_thread_budget_add(NATIVE_THREAD_CODEC, -ist->nb_budget_threads);
+    ist->nb_budget_threads = 0;
     avcodec_free_context(&ist->dec_ctx);
     avcodec_parameters_free(&ist->par);
 
@@ -480,6 +512,7 @@ void ifile_close(InputFile **pf)
 {
     InputFile *f = *pf;
     Demuxer   *d = demuxer_from_ifile(f);
+    AVIOContext *mem_pb;
 
     if (!f)
         return;
@@ -490,7 +523,9 @@ void ifile_close(InputFile **pf)
         ist_free(&f->streams[i]);
     av_freep(&f->streams);
 
+    mem_pb = f->ctx && (f->ctx->flags & AVFMT_FLAG_CUSTOM_IO) ? f->ctx->pb : NULL;
     avformat_close_input(&f->ctx);
+    native_mem_io_closep(&mem_pb);
 
     av_freep(pf);
 }
@@ -844,6 +879,7 @@ int ifile_open(const OptionsContext *o, const char *filename)
     Demuxer   *d;
     InputFile *f;
     AVFormatContext *ic;
+    AVIOContext *mem_pb = NULL;
     const AVInputFormat *file_iformat = NULL;
     int err, i, ret;
     int64_t timestamp;
@@ -959,9 +995,21 @@ int ifile_open(const OptionsContext *o, const char *filename)
         av_dict_set(&o->g->format_opts, "scan_all_pmts", "1", AV_DICT_DONT_OVERWRITE);
         scan_all_pmts_set = 1;
     }
+    /* mem://<id> reads from a registered in-memory buffer */
+    if (native_mem_io_is_url(filename)) {
+        err = native_mem_io_open(&ic->pb, filename, AVIO_FLAG_READ, &ic->interrupt_callback);
+        if (err < 0) {
+            print_error(filename, err);
+            exit_program(1);
+        }
+        ic->flags |= AVFMT_FLAG_CUSTOM_IO;
+        mem_pb = ic->pb;
+    }
+
     /* open the input file with generic avformat function */
     err = avformat_open_input(&ic, filename, file_iformat, &o->g->format_opts);
     if (err < 0) {
+        native_mem_io_closep(&mem_pb);
         print_error(filename, err);
         if (err == AVERROR_PROTOCOL_NOT_FOUND)
             av_log(NULL, AV_LOG_ERROR, "Did you mean file:%s?\n", filename);
@@ -992,6 +1040,7 @@ int ifile_open(const OptionsContext *o, const char *filename)
             av_log(NULL, AV_LOG_FATAL, "%s: could not find codec parameters\n", filename);
             if (ic->nb_streams == 0) {
                 avformat_close_input(&ic);
+                native_mem_io_closep(&mem_pb);
                 exit_program(1);
             }
         }
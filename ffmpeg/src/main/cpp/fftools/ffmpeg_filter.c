@@ -30,6 +30,7 @@
 #include "libavutil/avstring.h"
 #include "libavutil/bprint.h"
 #include "libavutil/channel_layout.h"
+#include "libavutil/cpu.h"
 #include "libavutil/display.h"
 #include "libavutil/opt.h"
 #include "libavutil/pixdesc.h"
@@ -37,6 +38,8 @@
 #include "libavutil/imgutils.h"
 #include "libavutil/samplefmt.h"
 
+#include "av/utils/thread_budget.h"
+
 // FIXME: YUV420P etc. are actually supported with full color range,
 // yet the latter information isn't available here.
 static const enum AVPixelFormat *get_compliance_normal_pix_fmts(const AVCodec *codec, const enum AVPixelFormat default_formats[])
@@ -1082,6 +1085,8 @@ static void cleanup_filtergraph(FilterGraph *fg)
         fg->outputs[i]->filter = (AVFilterContext *)NULL;
     for (i = 0; i < fg->nb_inputs; i++)
         fg->inputs[i]->filter = (AVFilterContext *)NULL;
+    native_thread_budget_add(NATIVE_THREAD_FILTER, -fg->nb_budget_threads);
+    fg->nb_budget_threads = 0;
     avfilter_graph_free(&fg->graph);
 }
 
@@ -1132,6 +1137,8 @@ int configure_filtergraph(FilterGraph *fg)
             e = av_dict_get(ost->encoder_opts, "threads", NULL, 0);
             if (e)
                 av_opt_set(fg->graph, "threads", e->value, 0);
+            else
+                fg->graph->nb_threads = native_thread_budget_share();
         }
 
         if (av_dict_count(ost->sws_dict)) {
@@ -1151,7 +1158,8 @@ int configure_filtergraph(FilterGraph *fg)
             av_free(args);
         }
     } else {
-        fg->graph->nb_threads = filter_complex_nbthreads;
+        fg->graph->nb_threads = filter_complex_nbthreads ? filter_complex_nbthreads :
+                                native_thread_budget_share();
     }
 
     if ((ret = graph_parse(fg->graph, graph_desc, &inputs, &outputs)) < 0)
@@ -1204,6 +1212,12 @@ int configure_filtergraph(FilterGraph *fg)
     if ((ret = avfilter_graph_config(fg->graph, NULL)) < 0)
         goto fail;
 
+    // nb_threads 为 0 时 libavfilter 按 cpu 核心数创建线程;
+    fg->nb_budget_threads = fg->graph->nb_threads > 0 ? fg->graph->nb_threads : av_cpu_count();
+    if (fg->nb_budget_threads <= 1)
+        fg->nb_budget_threads = 0;
+    native_thread_budget_add(NATIVE_THREAD_FILTER, fg->nb_budget_threads);
+
     fg->is_meta = graph_is_meta(fg->graph);
 
     /* limit the lists of allowed formats to the ones selected, to
@@ -38,6 +38,10 @@
 #include "libavformat/avformat.h"
 #include "libavformat/avio.h"
 
+#include "interaction/mem_io.h"
+#include "av/utils/thread_budget.h"
+#include "interaction/job_report.h"
+
 _Thread_local int want_sdp = 1;
 
 static Muxer *mux_from_of(OutputFile *of)
@@ -200,7 +204,9 @@ static void *muxer_thread(void *arg)
     Muxer     *mux = arg;
     OutputFile *of = &mux->of;
     AVPacket  *pkt = NULL;
-    int        ret = 0;
+    int        ret = 0, stage;
+
+    native_job_report_bind(mux->job_report);
 
     pkt = av_packet_alloc();
     if (!pkt) {
@@ -222,7 +228,9 @@ static void *muxer_thread(void *arg)
         }
 
         ost = of->streams[stream_idx];
+        stage = native_job_report_stage_enter(NATIVE_JOB_STAGE_MUX);
         ret = sync_queue_process(mux, ost, ret < 0 ? NULL : pkt, &stream_eof);
+        native_job_report_stage_leave(stage);
         av_packet_unref(pkt);
         if (ret == AVERROR_EOF && stream_eof)
             tq_receive_finish(mux->tq, stream_idx);
@@ -240,6 +248,8 @@ finish:
 
     av_log(mux, AV_LOG_VERBOSE, "Terminating muxer thread\n");
 
+    native_job_report_thread_finish();
+
     return (void*)(intptr_t)ret;
 }
 
@@ -268,6 +278,7 @@ finish:
 static int queue_packet(Muxer *mux, OutputStream *ost, AVPacket *pkt)
 {
     MuxStream *ms = ms_from_ost(ost);
+    ObjPool   *op = objpool_job_packets();
     AVPacket *tmp_pkt = NULL;
     int ret;
 
@@ -295,9 +306,9 @@ static int queue_packet(Muxer *mux, OutputStream *ost, AVPacket *pkt)
         if (ret < 0)
             return ret;
 
-        tmp_pkt = av_packet_alloc();
-        if (!tmp_pkt)
-            return AVERROR(ENOMEM);
+        ret = op ? objpool_get(op, (void**)&tmp_pkt) : AVERROR(ENOMEM);
+        if (ret < 0)
+            return ret;
 
         av_packet_move_ref(tmp_pkt, pkt);
         ms->muxing_queue_data_size += tmp_pkt->size;
@@ -326,7 +337,7 @@ static int submit_packet(Muxer *mux, AVPacket *pkt, OutputStream *ost)
     return 0;
 }
 
-void of_output_packet(OutputFile *of, AVPacket *pkt, OutputStream *ost, int eof)
+int of_output_packet(OutputFile *of, AVPacket *pkt, OutputStream *ost, int eof)
 {
     Muxer *mux = mux_from_of(of);
     MuxStream *ms = ms_from_ost(ost);
@@ -349,7 +360,7 @@ void of_output_packet(OutputFile *of, AVPacket *pkt, OutputStream *ost, int eof)
         while (!bsf_eof) {
             ret = av_bsf_receive_packet(ms->bsf_ctx, pkt);
             if (ret == AVERROR(EAGAIN))
-                return;
+                return 0;
             else if (ret == AVERROR_EOF)
                 bsf_eof = 1;
             else if (ret < 0) {
@@ -367,16 +378,14 @@ void of_output_packet(OutputFile *of, AVPacket *pkt, OutputStream *ost, int eof)
             goto mux_fail;
     }
 
-    return;
+    return 0;
 
 mux_fail:
     err_msg = "submitting a packet to the muxer";
 
 fail:
     av_log(ost, AV_LOG_ERROR, "Error %s\n", err_msg);
-    if (exit_on_error)
-        exit_program(1);
-
+    return ret;
 }
 
 static int thread_stop(Muxer *mux)
@@ -390,12 +399,18 @@ static int thread_stop(Muxer *mux)
         tq_send_finish(mux->tq, i);
 
     pthread_join(mux->thread, &ret);
+    native_thread_budget_add(NATIVE_THREAD_MUX, -1);
 
     tq_free(&mux->tq);
 
     return (int)(intptr_t)ret;
 }
 
+int of_muxer_started(OutputFile *of)
+{
+    return !!mux_from_of(of)->tq;
+}
+
 static void pkt_move(void *dst, void *src)
 {
     av_packet_move_ref(dst, src);
@@ -407,21 +422,28 @@ static int thread_start(Muxer *mux)
     ObjPool *op;
     int ret;
 
-    op = objpool_alloc_packets();
+    op = objpool_job_packets();
     if (!op)
         return AVERROR(ENOMEM);
+    op = objpool_ref(op);
 
-    mux->tq = tq_alloc(fc->nb_streams, mux->thread_queue_size, op, pkt_move);
+    // 只有主线程发送, 封装线程接收, 使用无锁的单生产者/单消费者队列;
+    // 开启 -encoder_threads 后各编码线程也会发送, 需要使用加锁的队列;
+    mux->tq = encoder_threads ?
+              tq_alloc(fc->nb_streams, mux->thread_queue_size, op, pkt_move) :
+              tq_alloc_spsc(fc->nb_streams, mux->thread_queue_size, op, pkt_move);
     if (!mux->tq) {
         objpool_free(&op);
         return AVERROR(ENOMEM);
     }
 
+    mux->job_report = native_job_report_current();
     ret = pthread_create(&mux->thread, NULL, muxer_thread, (void*)mux);
     if (ret) {
         tq_free(&mux->tq);
         return AVERROR(ret);
     }
+    native_thread_budget_add(NATIVE_THREAD_MUX, 1);
 
     /* flush the muxing queues */
     for (int i = 0; i < fc->nb_streams; i++) {
@@ -437,7 +459,7 @@ static int thread_start(Muxer *mux)
             ret = thread_submit_packet(mux, ost, pkt);
             if (pkt) {
                 ms->muxing_queue_data_size -= pkt->size;
-                av_packet_free(&pkt);
+                objpool_release(objpool_job_packets(), (void**)&pkt);
             }
             if (ret < 0)
                 return ret;
@@ -601,11 +623,18 @@ int of_stream_init(OutputFile *of, OutputStream *ost)
     return mux_check_init(mux);
 }
 
+static int fc_closep_pb(AVFormatContext *fc)
+{
+    if (native_mem_io_is_url(fc->url))
+        return native_mem_io_closep(&fc->pb);
+    return avio_closep(&fc->pb);
+}
+
 int of_write_trailer(OutputFile *of)
 {
     Muxer *mux = mux_from_of(of);
     AVFormatContext *fc = mux->fc;
-    int ret;
+    int ret, stage;
 
     if (!mux->tq) {
         av_log(mux, AV_LOG_ERROR,
@@ -618,16 +647,20 @@ int of_write_trailer(OutputFile *of)
     if (ret < 0)
         main_return_code = ret;
 
+    stage = native_job_report_stage_enter(NATIVE_JOB_STAGE_MUX);
     ret = av_write_trailer(fc);
+    native_job_report_stage_leave(stage);
     if (ret < 0) {
         av_log(mux, AV_LOG_ERROR, "Error writing trailer: %s\n", av_err2str(ret));
         return ret;
     }
 
     mux->last_filesize = filesize(fc->pb);
+    if (fc->pb)
+        native_job_report_add_io(0, fc->pb->bytes_written);
 
     if (!(of->format->flags & AVFMT_NOFILE)) {
-        ret = avio_closep(&fc->pb);
+        ret = fc_closep_pb(fc);
         if (ret < 0) {
             av_log(mux, AV_LOG_ERROR, "Error closing file: %s\n", av_err2str(ret));
             return ret;
@@ -656,8 +689,11 @@ static void ost_free(OutputStream **post)
 
     if (ms->muxing_queue) {
         AVPacket *pkt;
-        while (av_fifo_read(ms->muxing_queue, &pkt, 1) >= 0)
-            av_packet_free(&pkt);
+        while (av_fifo_read(ms->muxing_queue, &pkt, 1) >= 0) {
+            /* queued packets come from the command's packet pool */
+            if (pkt)
+                objpool_release(objpool_job_packets(), (void**)&pkt);
+        }
         av_fifo_freep2(&ms->muxing_queue);
     }
 
@@ -686,6 +722,8 @@ static void ost_free(OutputStream **post)
 
     if (ost->enc_ctx)
         av_freep(&ost->enc_ctx->stats_in);
+    native_thread_budget_add(NATIVE_THREAD_CODEC, -ost->nb_budget_threads);
+    ost->nb_budget_threads = 0;
     avcodec_free_context(&ost->enc_ctx);
 
     for (int i = 0; i < ost->enc_stats_pre.nb_components; i++)
@@ -711,7 +749,7 @@ static void fc_close(AVFormatContext **pfc)
         return;
 
     if (!(fc->oformat->flags & AVFMT_NOFILE))
-        avio_closep(&fc->pb);
+        fc_closep_pb(fc);
     avformat_free_context(fc);
 
     *pfc = NULL;
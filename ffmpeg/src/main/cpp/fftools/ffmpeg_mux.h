@@ -76,6 +76,8 @@ typedef struct Muxer {
 
     pthread_t    thread;
     ThreadQueue *tq;
+    // 所属命令的报告, 封装线程中统计封装耗时;
+    void        *job_report;
 
     AVDictionary *opts;
 
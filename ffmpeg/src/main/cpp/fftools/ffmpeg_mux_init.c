@@ -28,6 +28,8 @@
 #include "libavformat/avformat.h"
 #include "libavformat/avio.h"
 
+#include "interaction/mem_io.h"
+
 #include "libavcodec/avcodec.h"
 
 #include "libavfilter/avfilter.h"
@@ -2346,10 +2348,14 @@ int of_open(const OptionsContext *o, const char *filename)
         /* test if it already exists to avoid losing precious files */
         assert_file_overwrite(filename);
 
-        /* open the file */
-        if ((err = avio_open2(&oc->pb, filename, AVIO_FLAG_WRITE,
-                              &oc->interrupt_callback,
-                              &mux->opts)) < 0) {
+        /* open the file; mem://<id> and sink://<id> write into registered native outputs */
+        if (native_mem_io_is_url(filename))
+            err = native_mem_io_open(&oc->pb, filename, AVIO_FLAG_WRITE, &oc->interrupt_callback);
+        else
+            err = avio_open2(&oc->pb, filename, AVIO_FLAG_WRITE,
+                             &oc->interrupt_callback,
+                             &mux->opts);
+        if (err < 0) {
             print_error(filename, err);
             exit_program(1);
         }
@@ -86,6 +86,8 @@ _Thread_local int stdin_interaction = 1;
 _Thread_local float max_error_rate  = 2.0/3;
 _Thread_local char *filter_nbthreads;
 _Thread_local int filter_complex_nbthreads = 0;
+_Thread_local int encoder_threads = 0;
+_Thread_local int decoder_threads = 0;
 _Thread_local int vstats_version = 2;
 _Thread_local int auto_conversion_filters = 1;
 _Thread_local int64_t stats_period = 500000;
@@ -1510,6 +1512,10 @@ OptionDef *opt_get_ffmpeg_options(void) {
             "create a complex filtergraph", "graph_description" },
         { "filter_complex_threads", HAS_ARG | OPT_INT,                   { &filter_complex_nbthreads },
             "number of threads for -filter_complex" },
+        { "encoder_threads", OPT_BOOL | OPT_EXPERT,                      { &encoder_threads },
+            "run the encoder of each audio/video output stream on its own thread" },
+        { "decoder_threads", OPT_BOOL | OPT_EXPERT,                      { &decoder_threads },
+            "run the decoder of each audio input stream on its own thread" },
         { "lavfi",          HAS_ARG | OPT_EXPERT,                        { .func_arg = opt_filter_complex },
             "create a complex filtergraph", "graph_description" },
         { "filter_complex_script", HAS_ARG | OPT_EXPERT,                 { .func_arg = opt_filter_complex_script },
@@ -26,6 +26,7 @@
 #include "av/utils/str_utils.h"
 #include "config.h"
 #include "interaction/output_callback.h"
+#include "interaction/mem_io.h"
 #include "fftools/fftools_common.h"
 #include "libavutil/ffversion.h"
 
@@ -595,13 +596,35 @@ static void bprint_bytes(AVBPrint *bp, const uint8_t *ubuf, size_t ubuf_size)
         av_bprintf(bp, "%02X", ubuf[i]);
 }
 
+// 多数片段较短, 优先格式化到栈上, 避免每次分配内存;
+static void native_report_output_vprintf(const char *fmt, va_list ap)
+{
+    char buf[256];
+    va_list ap_copy;
+    int len;
+
+    va_copy(ap_copy, ap);
+    len = vsnprintf(buf, sizeof(buf), fmt, ap_copy);
+    va_end(ap_copy);
+    if (len < 0)
+        return;
+    if (len < sizeof(buf)) {
+        native_report_output_len(buf, len);
+    } else {
+        char *str = ff_cstr_create(fmt, ap);
+        if ( str ) {
+            native_report_output_len(str, len);
+            ff_cstr_free(&str);
+        }
+    }
+}
+
 static inline void writer_w8_avio(WriterContext *wctx, int b)
 {
     avio_w8(wctx->avio, b);
 
-    char str[2];  
-    snprintf(str, sizeof(str), "%c", b);  
-    native_report_output(str);
+    char c = b;
+    native_report_output_len(&c, 1);
 }
 
 static inline void writer_put_str_avio(WriterContext *wctx, const char *str)
@@ -620,11 +643,7 @@ static inline void writer_printf_avio(WriterContext *wctx, const char *fmt, ...)
     va_copy(ap_copy, ap);
     avio_vprintf(wctx->avio, fmt, ap);
 
-    char *str = ff_cstr_create(fmt, ap_copy);
-    if ( str ) {
-        native_report_output(str); 
-        ff_cstr_free(&str);
-    } 
+    native_report_output_vprintf(fmt, ap_copy);
     va_end(ap_copy);
     va_end(ap);
 }
@@ -633,9 +652,8 @@ static inline void writer_w8_printf(WriterContext *wctx, int b)
 {
     av_log(NULL, AV_LOG_INFO, "%c", b);
 
-    char str[2];  
-    snprintf(str, sizeof(str), "%c", b);  
-    native_report_output(str);
+    char c = b;
+    native_report_output_len(&c, 1);
 }
 
 static inline void writer_put_str_printf(WriterContext *wctx, const char *str)
@@ -654,11 +672,7 @@ static inline void writer_printf_printf(WriterContext *wctx, const char *fmt, ..
     va_copy(ap_copy, ap);
     av_vlog(NULL, AV_LOG_INFO, fmt, ap);
 
-    char *str = ff_cstr_create(fmt, ap_copy);
-    if ( str ) {
-        native_report_output(str); 
-        ff_cstr_free(&str);
-    } 
+    native_report_output_vprintf(fmt, ap_copy);
     va_end(ap_copy);
     va_end(ap);
 }
@@ -3360,6 +3374,7 @@ static int open_input_file(InputFile *ifile, const char *filename,
 {
     int err, i;
     AVFormatContext *fmt_ctx = NULL;
+    AVIOContext *mem_pb = NULL;
     const AVDictionaryEntry *t = NULL;
     int scan_all_pmts_set = 0;
 
@@ -3373,8 +3388,20 @@ static int open_input_file(InputFile *ifile, const char *filename,
     }
     fmt_ctx->interrupt_callback = int_cb;
     
+    /* mem://<id> reads from a registered in-memory buffer */
+    if (native_mem_io_is_url(filename)) {
+        if ((err = native_mem_io_open(&mem_pb, filename, AVIO_FLAG_READ, &fmt_ctx->interrupt_callback)) < 0) {
+            avformat_free_context(fmt_ctx);
+            print_error(filename, err);
+            return err;
+        }
+        fmt_ctx->pb = mem_pb;
+        fmt_ctx->flags |= AVFMT_FLAG_CUSTOM_IO;
+    }
+    
     if ((err = avformat_open_input(&fmt_ctx, filename,
                                    iformat, &format_opts)) < 0) {
+        native_mem_io_closep(&mem_pb);
         print_error(filename, err);
         return err;
     }
@@ -3477,6 +3504,7 @@ static int open_input_file(InputFile *ifile, const char *filename,
 static void close_input_file(InputFile *ifile)
 {
     int i;
+    AVIOContext *mem_pb;
 
     /* close decoder for each stream */
     for (i = 0; i < ifile->nb_streams; i++)
@@ -3485,7 +3513,9 @@ static void close_input_file(InputFile *ifile)
     av_freep(&ifile->streams);
     ifile->nb_streams = 0;
 
+    mem_pb = ifile->fmt_ctx->flags & AVFMT_FLAG_CUSTOM_IO ? ifile->fmt_ctx->pb : NULL;
     avformat_close_input(&ifile->fmt_ctx);
+    native_mem_io_closep(&mem_pb);
 }
 
 static int probe_file(WriterContext *wctx, const char *filename,
@@ -4093,6 +4123,16 @@ static OptionDef *opt_get_ffprobe_options(void) {
     return ptr;
 }
 
+// 常驻线程缓存选项表; 选项中引用了线程局部变量的地址, 因此每个线程各自创建;
+static _Thread_local OptionDef *ffprobe_options_cache = NULL;
+static OptionDef *ffprobe_acquire_options(void) {
+    if (!fftools_thread_is_warm())
+        return opt_get_ffprobe_options();
+    if (!ffprobe_options_cache)
+        ffprobe_options_cache = opt_get_ffprobe_options();
+    return ffprobe_options_cache;
+}
+
 static inline int check_section_show_entries(int section_id)
 {
     int *id;
@@ -4205,7 +4245,7 @@ int ffprobe_main(_Atomic bool *is_running, int argc, char **argv)
 #endif
 
     if ( setjmp(exit_jump_buffer) == 0 ) {
-        options = opt_get_ffprobe_options();
+        options = ffprobe_acquire_options();
         parse_loglevel(argc, argv, options);
     
         show_banner(argc, argv, options);
@@ -4333,9 +4373,9 @@ int ffprobe_main(_Atomic bool *is_running, int argc, char **argv)
         for (i = 0; i < FF_ARRAY_ELEMS(sections); i++)
             av_dict_free(&(sections[i].entries_to_show));
     
-        avformat_network_deinit();
-    
-        free(options);
+        // 网络模块在 fftools_init 中只初始化一次, 这里不再释放;
+        if (options != ffprobe_options_cache)
+            free(options);
         options = NULL;
     }
     return ret < 0;
@@ -37,6 +37,10 @@ void _fftools_init(void) {
 #endif
     avformat_network_init();
     
+    // 触发编解码器的静态初始化(部分编解码器会在此时生成查找表), 避免计入首个命令的耗时;
+    void *opaque = NULL;
+    while (av_codec_iterate(&opaque));
+    
     log_set_callback();
     
     register_ffmpeg_exit(ffmpeg_cleanup);
@@ -45,4 +49,14 @@ void _fftools_init(void) {
 
 void fftools_init(void) {
     strict_pthread_once(&fftools_init_once, _fftools_init);
+}
+
+static _Thread_local int fftools_thread_warm = 0;
+void fftools_thread_init(void) {
+    fftools_init();
+    fftools_thread_warm = 1;
+}
+
+int fftools_thread_is_warm(void) {
+    return fftools_thread_warm;
 }
\ No newline at end of file
@@ -25,4 +25,9 @@
 
 void fftools_init(void);
 
+// 将当前线程标记为常驻线程并完成初始化; 常驻线程会缓存每个命令都需要的数据(如选项表), 避免每次执行时重新创建;
+void fftools_thread_init(void);
+// 当前线程是否为常驻线程;
+int fftools_thread_is_warm(void);
+
 #endif //UTILITIES_FFTOOLS_COMMON_H
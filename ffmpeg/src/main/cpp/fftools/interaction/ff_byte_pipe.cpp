@@ -0,0 +1,109 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/25.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "ff_byte_pipe.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+extern "C" {
+#include "libavformat/avio.h"
+#include "libavutil/error.h"
+}
+
+static constexpr int64_t PIPE_WAIT_TICK_MS = 20;
+static constexpr size_t PIPE_MIN_CAPACITY = 64 * 1024;
+
+static bool pipe_interrupted(const AVIOInterruptCB* int_cb) {
+    return int_cb && int_cb->callback && int_cb->callback(int_cb->opaque);
+}
+
+FFBytePipe::FFBytePipe(size_t capacity) {
+    _capacity = std::max(capacity, PIPE_MIN_CAPACITY);
+    _buffer = reinterpret_cast<uint8_t*>(malloc(_capacity));
+}
+
+FFBytePipe::~FFBytePipe() {
+    free(_buffer);
+}
+
+int FFBytePipe::write(const uint8_t* data, size_t len, const AVIOInterruptCB* int_cb) {
+    if ( _buffer == nullptr ) return AVERROR(ENOMEM);
+    
+    std::unique_lock<std::mutex> lock(_mtx);
+    while ( len > 0 ) {
+        while ( !_reader_closed && _size == _capacity ) {
+            if ( pipe_interrupted(int_cb) ) return AVERROR_EXIT;
+            _cv.wait_for(lock, std::chrono::milliseconds(PIPE_WAIT_TICK_MS));
+        }
+        if ( _reader_closed ) {
+            _broken = true;
+            return AVERROR(EPIPE);
+        }
+        
+        // 环形缓冲区的空闲部分最多分两段;
+        size_t tail = (_head + _size) % _capacity;
+        size_t n = std::min(len, std::min(_capacity - _size, _capacity - tail));
+        memcpy(_buffer + tail, data, n);
+        _size += n;
+        data += n;
+        len -= n;
+        _cv.notify_all();
+    }
+    return 0;
+}
+
+int FFBytePipe::read(uint8_t* buf, size_t len, const AVIOInterruptCB* int_cb) {
+    if ( _buffer == nullptr ) return AVERROR(ENOMEM);
+    
+    std::unique_lock<std::mutex> lock(_mtx);
+    while ( !_writer_closed && _size == 0 ) {
+        if ( pipe_interrupted(int_cb) ) return AVERROR_EXIT;
+        _cv.wait_for(lock, std::chrono::milliseconds(PIPE_WAIT_TICK_MS));
+    }
+    if ( _size == 0 ) return AVERROR_EOF;
+    
+    size_t n = std::min(len, std::min(_size, _capacity - _head));
+    memcpy(buf, _buffer + _head, n);
+    _head = (_head + n) % _capacity;
+    _size -= n;
+    _cv.notify_all();
+    return static_cast<int>(n);
+}
+
+void FFBytePipe::closeWriter() {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _writer_closed = true;
+    _cv.notify_all();
+}
+
+void FFBytePipe::closeReader() {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _reader_closed = true;
+    _cv.notify_all();
+}
+
+bool FFBytePipe::isBroken() {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _broken;
+}
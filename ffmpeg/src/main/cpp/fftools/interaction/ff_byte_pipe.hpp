@@ -0,0 +1,71 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/25.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef FFMPEGPROJ_FF_BYTE_PIPE_H
+#define FFMPEGPROJ_FF_BYTE_PIPE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+struct AVIOInterruptCB;
+
+/**
+ * 进程内有界字节管道, 连接同时执行的两个命令(fifo://<id>);
+ *
+ * 一个写入端一个读取端; 缓冲区已满时写入等待, 为空时读取等待; 等待期间通过 int_cb 响应取消;
+ * 写入端关闭后读取端读完剩余数据返回 AVERROR_EOF; 读取端关闭后写入返回 AVERROR(EPIPE);
+ */
+class FFBytePipe {
+public:
+    explicit FFBytePipe(size_t capacity);
+    ~FFBytePipe();
+    
+    FFBytePipe(const FFBytePipe&) = delete;
+    FFBytePipe& operator=(const FFBytePipe&) = delete;
+    
+    // 全部写入后返回 0;
+    int write(const uint8_t* data, size_t len, const AVIOInterruptCB* int_cb);
+    // 返回读取的字节数, 至少 1 字节;
+    int read(uint8_t* buf, size_t len, const AVIOInterruptCB* int_cb);
+    
+    void closeWriter();
+    void closeReader();
+    
+    // 读取端提前关闭, 有写入因此返回了 AVERROR(EPIPE);
+    bool isBroken();
+    
+private:
+    uint8_t* _buffer;
+    size_t _capacity;
+    size_t _head { 0 }; // 读取位置;
+    size_t _size { 0 };
+    bool _writer_closed { false };
+    bool _reader_closed { false };
+    bool _broken { false };
+    
+    std::mutex _mtx;
+    std::condition_variable _cv;
+};
+
+#endif //FFMPEGPROJ_FF_BYTE_PIPE_H
@@ -0,0 +1,266 @@
+/**
+    This file is part of @sj/ffmpeg.
+
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/21.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "ff_callback_channel.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <thread>
+
+static constexpr size_t RECORD_ALIGN = 4;
+static constexpr int64_t FLUSH_TIMER_TICK_MS = 20;
+
+static int64_t channel_now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static size_t channel_align(size_t size) {
+    return (size + RECORD_ALIGN - 1) & ~(RECORD_ALIGN - 1);
+}
+
+/**
+ * 负责投递长时间未达到阈值的消息, 所有 channel 共用一个线程; 没有 channel 时线程处于等待状态;
+ */
+class FFCallbackFlushTimer {
+public:
+    static void add(FFCallbackChannel* channel) {
+        FFCallbackFlushTimer& timer = shared();
+        std::lock_guard<std::mutex> lock(timer._mtx);
+        timer._channels.insert(channel);
+        if ( !timer._started ) {
+            timer._started = true;
+            std::thread(&FFCallbackFlushTimer::run, &timer).detach();
+        }
+        timer._cv.notify_one();
+    }
+
+    static void remove(FFCallbackChannel* channel) {
+        FFCallbackFlushTimer& timer = shared();
+        std::lock_guard<std::mutex> lock(timer._mtx);
+        timer._channels.erase(channel);
+    }
+
+private:
+    // 线程常驻, 不做析构;
+    static FFCallbackFlushTimer& shared() {
+        static FFCallbackFlushTimer* instance = new FFCallbackFlushTimer();
+        return *instance;
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(_mtx);
+        while ( true ) {
+            if ( _channels.empty() ) {
+                _cv.wait(lock, [this] { return !_channels.empty(); });
+            }
+            _cv.wait_for(lock, std::chrono::milliseconds(FLUSH_TIMER_TICK_MS));
+            int64_t now_us = channel_now_us();
+            for ( auto channel : _channels ) {
+                channel->flushIfIdle(now_us);
+            }
+        }
+    }
+
+    std::mutex _mtx;
+    std::condition_variable _cv;
+    std::set<FFCallbackChannel*> _channels;
+    bool _started { false };
+};
+
+FFCallbackChannel::FFCallbackChannel(napi_threadsafe_function flush_ref, const Options& options): _flush_ref(flush_ref), _options(options) {
+    _capacity = channel_align(std::max<size_t>(options.buffer_size, 16 * 1024));
+    _buffer = reinterpret_cast<uint8_t*>(malloc(_capacity));
+    _last_flush_time_us.store(channel_now_us());
+    FFCallbackFlushTimer::add(this);
+}
+
+FFCallbackChannel::~FFCallbackChannel() {
+    FFCallbackFlushTimer::remove(this);
+    free(_buffer);
+}
+
+bool FFCallbackChannel::isEnabled(RecordType type) const {
+    return _options.enabled_types & (1 << type);
+}
+
+void FFCallbackChannel::push(RecordType type, int level, const char* msg, size_t len) {
+    if ( !isEnabled(type) || _buffer == nullptr ) {
+        return;
+    }
+
+    // 单条消息最多占用缓冲区的 1/4, 超出部分截断; 二进制数据无法截断, 直接忽略;
+    size_t max_len = _capacity / 4 - sizeof(RecordHeader);
+    if ( len > max_len ) {
+        if ( type == PROGRESS_STATS ) return;
+        len = max_len;
+    }
+
+    if ( !tryWrite(type, level, msg, len) ) {
+        if ( type == LOG && _options.log_overflow_policy == DROP ) {
+            _dropped_logs.fetch_add(1, std::memory_order_relaxed);
+            scheduleFlush();
+            return;
+        }
+
+        _blocked_writes.fetch_add(1, std::memory_order_relaxed);
+        std::unique_lock<std::mutex> lock(_mtx);
+        while ( !tryWrite(type, level, msg, len) ) {
+            if ( _closed.load() ) {
+                if ( type == LOG ) _dropped_logs.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            lock.unlock();
+            scheduleFlush();
+            lock.lock();
+            _cv.wait_for(lock, std::chrono::milliseconds(FLUSH_TIMER_TICK_MS));
+        }
+    }
+
+    if ( type == PROGRESS || type == PROGRESS_STATS ) {
+        scheduleFlush();
+        return;
+    }
+
+    uint64_t pending = _head.load(std::memory_order_relaxed) - _tail.load(std::memory_order_acquire);
+    if ( pending >= _options.flush_threshold ||
+         channel_now_us() - _last_flush_time_us.load(std::memory_order_relaxed) >= _options.flush_interval_ms * 1000LL ) {
+        scheduleFlush();
+    }
+}
+
+bool FFCallbackChannel::tryWrite(RecordType type, int level, const char* msg, size_t len) {
+    size_t record_size = channel_align(sizeof(RecordHeader) + len);
+    uint64_t head = _head.load(std::memory_order_relaxed);
+    uint64_t tail = _tail.load(std::memory_order_acquire);
+    size_t offset = head % _capacity;
+
+    // 尾部空间不足以容纳整条消息时跳到缓冲区起始位置;
+    size_t skip = offset + record_size > _capacity ? _capacity - offset : 0;
+    if ( _capacity - (head - tail) < skip + record_size ) {
+        return false;
+    }
+
+    if ( skip >= sizeof(RecordHeader) ) {
+        RecordHeader pad = { 0, 0, static_cast<uint32_t>(skip - sizeof(RecordHeader)) };
+        memcpy(_buffer + offset, &pad, sizeof(pad));
+    }
+    head += skip;
+    offset = head % _capacity;
+
+    RecordHeader header = { type, level, static_cast<uint32_t>(len) };
+    memcpy(_buffer + offset, &header, sizeof(header));
+    if ( len > 0 ) memcpy(_buffer + offset + sizeof(header), msg, len);
+    _head.store(head + record_size, std::memory_order_release);
+    return true;
+}
+
+void FFCallbackChannel::flush() {
+    if ( _head.load(std::memory_order_acquire) != _tail.load(std::memory_order_acquire) ) {
+        scheduleFlush();
+    }
+}
+
+void FFCallbackChannel::scheduleFlush() {
+    if ( _closed.load() || _flush_scheduled.exchange(true) ) {
+        return;
+    }
+
+    _pending_flushes.fetch_add(1);
+    napi_status status = napi_call_threadsafe_function(_flush_ref, this, napi_tsfn_nonblocking);
+    if ( status != napi_ok ) {
+        _pending_flushes.fetch_sub(1);
+        _flush_scheduled.store(false);
+        if ( status == napi_closing ) {
+            _closed.store(true);
+            std::lock_guard<std::mutex> lock(_mtx);
+            _cv.notify_all();
+        }
+    }
+}
+
+bool FFCallbackChannel::flushIfIdle(int64_t now_us) {
+    if ( _flush_scheduled.load() || _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire) ) {
+        return false;
+    }
+    if ( now_us - _last_flush_time_us.load(std::memory_order_relaxed) < _options.flush_interval_ms * 1000LL ) {
+        return false;
+    }
+    scheduleFlush();
+    return true;
+}
+
+void FFCallbackChannel::drain(const Visitor& visitor) {
+    // 先清除标记, 消费期间写入的消息会再次触发投递;
+    _flush_scheduled.store(false);
+    _last_flush_time_us.store(channel_now_us(), std::memory_order_relaxed);
+
+    uint64_t head = _head.load(std::memory_order_acquire);
+    uint64_t tail = _tail.load(std::memory_order_relaxed);
+    uint32_t nb_records = 0;
+    while ( tail < head ) {
+        size_t offset = tail % _capacity;
+        if ( _capacity - offset < sizeof(RecordHeader) ) {
+            tail += _capacity - offset;
+            continue;
+        }
+
+        RecordHeader header;
+        memcpy(&header, _buffer + offset, sizeof(header));
+        if ( header.type != 0 ) {
+            visitor(static_cast<RecordType>(header.type), header.level, reinterpret_cast<const char*>(_buffer + offset + sizeof(header)), header.len);
+            nb_records += 1;
+        }
+        tail += channel_align(sizeof(RecordHeader) + header.len);
+        _tail.store(tail, std::memory_order_release);
+    }
+
+    _records += nb_records;
+    _batches += 1;
+    _max_batch_records = std::max(_max_batch_records, nb_records);
+    _pending_flushes.fetch_sub(1);
+
+    std::lock_guard<std::mutex> lock(_mtx);
+    _cv.notify_all();
+}
+
+bool FFCallbackChannel::isDrained() const {
+    // threadsafe function 已关闭时剩余消息无法再投递;
+    return _pending_flushes.load() == 0 && (_closed.load() || _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire));
+}
+
+void FFCallbackChannel::waitUntilDrained() {
+    flush();
+    std::unique_lock<std::mutex> lock(_mtx);
+    _cv.wait(lock, [this] { return isDrained(); });
+}
+
+FFCallbackChannel::Stats FFCallbackChannel::getStats() {
+    return {
+        _records,
+        _batches,
+        _max_batch_records,
+        _dropped_logs.load(),
+        _blocked_writes.load()
+    };
+}
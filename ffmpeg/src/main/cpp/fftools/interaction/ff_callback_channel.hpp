@@ -0,0 +1,134 @@
+/**
+    This file is part of @sj/ffmpeg.
+
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/21.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef FFMPEGPROJ_FF_CALLBACK_CHANNEL_H
+#define FFMPEGPROJ_FF_CALLBACK_CHANNEL_H
+
+#include "napi/native_api.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+/**
+ * 执行命令期间, 将日志/进度/输出消息传递到 js 线程的通道;
+ *
+ * 单生产者(执行命令的线程)单消费者(js 线程)的环形缓冲区, 写入时不分配内存也不等待 js 线程;
+ * 消息累积到 flush_threshold 字节或距上次投递超过 flush_interval_ms 时, 通过 threadsafe function 批量投递到 js 线程;
+ * 进度消息到达时立即投递; 消息内容按字节复制, 也可以是二进制数据;
+ */
+class FFCallbackChannel {
+public:
+    enum RecordType : uint32_t {
+        LOG = 1,
+        PROGRESS = 2,
+        OUTPUT = 3,
+        PROGRESS_STATS = 4, // 二进制的进度数据(NativeProgress);
+    };
+
+    // 缓冲区已满时日志消息的处理方式; 进度及输出消息总是等待, 不会丢弃;
+    enum OverflowPolicy {
+        BLOCK,  // 等待 js 线程消费;
+        DROP,   // 丢弃新消息并计数;
+    };
+
+    struct Options {
+        size_t buffer_size = 256 * 1024;
+        size_t flush_threshold = 16 * 1024;
+        int flush_interval_ms = 100;
+        OverflowPolicy log_overflow_policy = BLOCK;
+        int progress_interval_ms = 0; // 结构化进度的最小上报间隔;
+        uint32_t enabled_types = 0; // (1 << RecordType) 的组合, 未开启的类型直接忽略;
+    };
+
+    struct Stats {
+        uint64_t records;           // 已投递的消息数量;
+        uint64_t batches;           // 投递批次;
+        uint32_t max_batch_records; // 单批次最多的消息数量;
+        uint64_t dropped_logs;      // 因缓冲区已满被丢弃的日志数量;
+        uint64_t blocked_writes;    // 因缓冲区已满等待的次数;
+    };
+
+    // flush_ref: 调用时 data 参数为当前 channel, 请在 js 线程中调用 drain;
+    FFCallbackChannel(napi_threadsafe_function flush_ref, const Options& options);
+    ~FFCallbackChannel();
+
+    FFCallbackChannel(const FFCallbackChannel&) = delete;
+    FFCallbackChannel& operator=(const FFCallbackChannel&) = delete;
+
+    bool isEnabled(RecordType type) const;
+    const Options& options() const { return _options; }
+
+    // 生产者线程调用;
+    void push(RecordType type, int level, const char* msg, size_t len);
+    // 立即投递缓冲区中的消息(如果有);
+    void flush();
+
+    // js 线程调用; 依次回调当前缓冲区中的消息, msg 仅在回调期间有效;
+    using Visitor = std::function<void(RecordType type, int level, const char* msg, size_t len)>;
+    void drain(const Visitor& visitor);
+
+    // 所有消息都已被 js 线程消费;
+    bool isDrained() const;
+    // 投递剩余消息并阻塞等待 js 线程消费完毕; 由最后一次 drain 唤醒;
+    void waitUntilDrained();
+
+    Stats getStats();
+
+private:
+    struct RecordHeader {
+        uint32_t type;
+        int32_t level;
+        uint32_t len;
+    };
+
+    friend class FFCallbackFlushTimer;
+
+    void scheduleFlush();
+    bool flushIfIdle(int64_t now_us); // 定时器线程调用;
+    bool tryWrite(RecordType type, int level, const char* msg, size_t len);
+
+    napi_threadsafe_function _flush_ref;
+    Options _options;
+
+    uint8_t* _buffer;
+    size_t _capacity;
+    std::atomic<uint64_t> _head { 0 }; // 生产者写入位置;
+    std::atomic<uint64_t> _tail { 0 }; // 消费者读取位置;
+
+    std::atomic<bool> _flush_scheduled { false };
+    std::atomic<int> _pending_flushes { 0 };
+    std::atomic<int64_t> _last_flush_time_us { 0 };
+    std::atomic<bool> _closed { false }; // threadsafe function 已不可用;
+
+    std::mutex _mtx;
+    std::condition_variable _cv;
+
+    uint64_t _records { 0 };
+    uint64_t _batches { 0 };
+    uint32_t _max_batch_records { 0 };
+    std::atomic<uint64_t> _dropped_logs { 0 };
+    std::atomic<uint64_t> _blocked_writes { 0 };
+};
+
+#endif //FFMPEGPROJ_FF_CALLBACK_CHANNEL_H
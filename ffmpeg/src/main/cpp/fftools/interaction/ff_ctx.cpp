@@ -21,57 +21,113 @@
 // please include "napi/native_api.h".
 
 #include "ff_ctx.hpp"
-#include <unistd.h>  // for sleep (UNIX systems)
+#include <chrono>
+#include <cstring>
 
 EXTERN_C_START
 
 _Thread_local static struct {
-    atomic_int pendingCallbacks;
-    napi_threadsafe_function log_callback_ref;
-    napi_threadsafe_function progress_callback_ref;
-    napi_threadsafe_function output_callback_ref;
-} ff_ctx = { 0, nullptr, nullptr, nullptr }; 
+    FFCallbackChannel *channel;
+    int64_t last_progress_stats_time_us;
+    std::string *output_buffer;
+    size_t output_chunk_size;
+} ff_ctx = { nullptr, 0, nullptr, 0 }; 
 
-void 
-ff_set_callback_refs(
-    napi_threadsafe_function log_callback_ref,
-    napi_threadsafe_function progress_callback_ref,
-    napi_threadsafe_function output_callback_ref
-) {
-    ff_ctx.log_callback_ref = log_callback_ref;
-    ff_ctx.progress_callback_ref = progress_callback_ref;
-    ff_ctx.output_callback_ref = output_callback_ref;
+static int64_t 
+ff_now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void
+ff_set_callback_channel(FFCallbackChannel *channel) {
+    ff_ctx.channel = channel;
+    ff_ctx.last_progress_stats_time_us = 0;
 }
 
 void 
 ff_invoke_log_callback(int level, const char *message) {
-    if ( ff_ctx.log_callback_ref ) {
-        atomic_fetch_add(&ff_ctx.pendingCallbacks, 1);
-        napi_call_threadsafe_function(ff_ctx.log_callback_ref, new FFCallbackData { &ff_ctx.pendingCallbacks, message, level }, napi_tsfn_blocking);
+    if ( ff_ctx.channel ) {
+        ff_ctx.channel->push(FFCallbackChannel::LOG, level, message, strlen(message));
     }
 }
 
 void 
 ff_invoke_progress_callback(const char *message) {
-    if ( ff_ctx.progress_callback_ref ) {
-        atomic_fetch_add(&ff_ctx.pendingCallbacks, 1);
-        napi_call_threadsafe_function(ff_ctx.progress_callback_ref, new FFCallbackData { &ff_ctx.pendingCallbacks, message, 0 }, napi_tsfn_blocking);
+    if ( ff_ctx.channel ) {
+        ff_ctx.channel->push(FFCallbackChannel::PROGRESS, 0, message, strlen(message));
     }
 }
 
 void 
 ff_invoke_output_callback(const char *message) {
-    if ( ff_ctx.output_callback_ref ) {
-        atomic_fetch_add(&ff_ctx.pendingCallbacks, 1);
-        napi_call_threadsafe_function(ff_ctx.output_callback_ref, new FFCallbackData { &ff_ctx.pendingCallbacks, message, 0 }, napi_tsfn_blocking);
+    ff_invoke_output_callback_len(message, strlen(message));
+}
+
+void 
+ff_invoke_output_callback_len(const char *message, size_t len) {
+    if ( ff_ctx.output_buffer ) {
+        ff_ctx.output_buffer->append(message, len);
+        if ( ff_ctx.output_chunk_size > 0 && ff_ctx.output_buffer->size() >= ff_ctx.output_chunk_size ) {
+            size_t chunk_size = ff_ctx.output_chunk_size;
+            size_t offset = 0;
+            size_t size = ff_ctx.output_buffer->size();
+            while ( size - offset >= chunk_size ) {
+                if ( ff_ctx.channel ) ff_ctx.channel->push(FFCallbackChannel::OUTPUT, 0, ff_ctx.output_buffer->data() + offset, chunk_size);
+                offset += chunk_size;
+            }
+            ff_ctx.output_buffer->erase(0, offset);
+        }
+        return;
+    }
+    
+    if ( ff_ctx.channel ) {
+        ff_ctx.channel->push(FFCallbackChannel::OUTPUT, 0, message, len);
     }
 }
 
+void
+ff_set_output_buffer(std::string *buffer, size_t chunk_size) {
+    ff_ctx.output_buffer = buffer;
+    ff_ctx.output_chunk_size = chunk_size;
+    if ( buffer && chunk_size > 0 ) buffer->reserve(chunk_size * 2);
+}
+
+void
+ff_flush_output() {
+    if ( ff_ctx.output_buffer && ff_ctx.output_chunk_size > 0 && !ff_ctx.output_buffer->empty() ) {
+        if ( ff_ctx.channel ) ff_ctx.channel->push(FFCallbackChannel::OUTPUT, 0, ff_ctx.output_buffer->data(), ff_ctx.output_buffer->size());
+        ff_ctx.output_buffer->clear();
+    }
+}
+
+int
+ff_progress_stats_enabled(void) {
+    return ff_ctx.channel && ff_ctx.channel->isEnabled(FFCallbackChannel::PROGRESS_STATS);
+}
+
 void 
+ff_invoke_progress_stats_callback(const NativeProgress *progress) {
+    if ( !ff_progress_stats_enabled() ) {
+        return;
+    }
+    int64_t now_us = ff_now_us();
+    int64_t interval_us = ff_ctx.channel->options().progress_interval_ms * 1000LL;
+    if ( !progress->is_last && ff_ctx.last_progress_stats_time_us != 0 && now_us - ff_ctx.last_progress_stats_time_us < interval_us ) {
+        return;
+    }
+    ff_ctx.last_progress_stats_time_us = now_us;
+    int nb_outputs = progress->nb_outputs < NATIVE_PROGRESS_MAX_OUTPUTS ? progress->nb_outputs : NATIVE_PROGRESS_MAX_OUTPUTS;
+    ff_ctx.channel->push(FFCallbackChannel::PROGRESS_STATS, 0, reinterpret_cast<const char *>(progress), NATIVE_PROGRESS_SIZE(nb_outputs));
+}
+
+int64_t 
 ff_wait_callbacks() {
-    while (atomic_load(&ff_ctx.pendingCallbacks) > 0) {
-        usleep(10 * 1000);  // 让出 CPU (10ms)
+    if ( ff_ctx.channel == nullptr ) {
+        return 0;
     }
+    int64_t start_us = ff_now_us();
+    ff_ctx.channel->waitUntilDrained();
+    return ff_now_us() - start_us;
 }
 
 EXTERN_C_END
@@ -23,23 +23,14 @@
 #ifndef FFMPEGPROJ_FF_CTX_H
 #define FFMPEGPROJ_FF_CTX_H
 #include "napi/native_api.h"
+#include "ff_callback_channel.hpp"
+#include "progress_callback.h"
 #include <string>
 
 EXTERN_C_START
-#include <stdatomic.h>
 
-typedef struct {
-    atomic_int* pendingCallbacks;
-    std::string msg;
-    int level;
-} FFCallbackData;
-
-void 
-ff_set_callback_refs(
-    napi_threadsafe_function log_callback_ref,
-    napi_threadsafe_function progress_callback_ref,
-    napi_threadsafe_function output_callback_ref
-);
+void
+ff_set_callback_channel(FFCallbackChannel *channel);
 
 void 
 ff_invoke_log_callback(int level, const char *message);
@@ -51,6 +42,25 @@ void
 ff_invoke_output_callback(const char *message);
 
 void 
+ff_invoke_output_callback_len(const char *message, size_t len);
+
+// 设置后输出消息写入 buffer; chunk_size > 0 时每累积 chunk_size 字节通过 channel 投递一次, 否则全部保留在 buffer 中;
+void
+ff_set_output_buffer(std::string *buffer, size_t chunk_size);
+
+// 投递 buffer 中剩余的分块消息;
+void
+ff_flush_output();
+
+int
+ff_progress_stats_enabled(void);
+
+// 按 progress_interval_ms 限流, 最后一次进度总是上报;
+void 
+ff_invoke_progress_stats_callback(const NativeProgress *progress);
+
+// 等待所有消息被 js 线程消费; 返回等待时长(微秒);
+int64_t 
 ff_wait_callbacks();
 
 EXTERN_C_END
@@ -0,0 +1,123 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/24.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "ff_output_sink.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+extern "C" {
+#include "libavformat/avio.h"
+#include "libavutil/error.h"
+}
+
+static constexpr int64_t SINK_WAIT_TICK_MS = 20;
+static constexpr size_t SINK_MIN_CHUNK_SIZE = 4 * 1024;
+
+FFOutputSink::FFOutputSink(const Options& options, Deliver deliver): _options(options), _deliver(std::move(deliver)) {
+    _options.chunk_size = std::max(_options.chunk_size, SINK_MIN_CHUNK_SIZE);
+    _options.high_water_mark = std::max(_options.high_water_mark, _options.chunk_size);
+}
+
+FFOutputSink::~FFOutputSink() {
+    free(_chunk);
+}
+
+int FFOutputSink::write(const uint8_t* data, size_t len, const AVIOInterruptCB* int_cb) {
+    while ( len > 0 ) {
+        if ( _chunk == nullptr ) {
+            _chunk = reinterpret_cast<uint8_t*>(malloc(_options.chunk_size));
+            _chunk_len = 0;
+            if ( _chunk == nullptr ) return AVERROR(ENOMEM);
+        }
+        
+        size_t n = std::min(len, _options.chunk_size - _chunk_len);
+        memcpy(_chunk + _chunk_len, data, n);
+        _chunk_len += n;
+        data += n;
+        len -= n;
+        
+        if ( _chunk_len == _options.chunk_size ) {
+            uint8_t* chunk = _chunk;
+            _chunk = nullptr;
+            int ret = deliverChunk(chunk, _options.chunk_size, int_cb);
+            if ( ret < 0 ) return ret;
+        }
+    }
+    return 0;
+}
+
+int FFOutputSink::finish(const AVIOInterruptCB* int_cb) {
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        if ( _finished ) return 0;
+        _finished = true;
+    }
+    
+    int ret = 0;
+    if ( _chunk != nullptr && _chunk_len > 0 ) {
+        uint8_t* chunk = _chunk;
+        _chunk = nullptr;
+        ret = deliverChunk(chunk, _chunk_len, int_cb);
+    }
+    // 结束标记总是投递, 接收方据此释放资源;
+    _deliver(nullptr, 0);
+    return ret;
+}
+
+void FFOutputSink::consumed(size_t len) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _queued_bytes -= std::min(len, _queued_bytes);
+    _cv.notify_all();
+}
+
+void FFOutputSink::cancel() {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _cancelled = true;
+    _cv.notify_all();
+}
+
+int FFOutputSink::deliverChunk(uint8_t* data, size_t len, const AVIOInterruptCB* int_cb) {
+    {
+        std::unique_lock<std::mutex> lock(_mtx);
+        // js 侧处理不及时, 等待消费;
+        while ( !_cancelled && _queued_bytes >= _options.high_water_mark ) {
+            if ( int_cb && int_cb->callback && int_cb->callback(int_cb->opaque) ) {
+                free(data);
+                return AVERROR_EXIT;
+            }
+            _cv.wait_for(lock, std::chrono::milliseconds(SINK_WAIT_TICK_MS));
+        }
+        if ( _cancelled ) {
+            free(data);
+            return AVERROR(EPIPE);
+        }
+        _queued_bytes += len;
+    }
+    
+    if ( !_deliver(data, len) ) {
+        consumed(len);
+        return AVERROR(EPIPE);
+    }
+    return 0;
+}
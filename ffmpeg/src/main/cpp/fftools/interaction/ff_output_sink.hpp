@@ -0,0 +1,85 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/24.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef FFMPEGPROJ_FF_OUTPUT_SINK_H
+#define FFMPEGPROJ_FF_OUTPUT_SINK_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+struct AVIOInterruptCB;
+
+/**
+ * sink://<id> 的输出端;
+ *
+ * 封装线程写入的数据按 chunk_size 分块后交给 deliver, 由调用方投递到 js 线程;
+ * 已投递但未被消费(consumed)的数据超过 high_water_mark 时写入线程等待, 直到 js 侧处理完毕或命令被取消;
+ */
+class FFOutputSink {
+public:
+    struct Options {
+        size_t chunk_size = 64 * 1024;
+        size_t high_water_mark = 1024 * 1024;
+    };
+    
+    // 投递一个分块, data 由 malloc 分配, 所有权转移给接收方; data 为空时表示输出结束; 返回 false 表示无法投递;
+    using Deliver = std::function<bool(uint8_t* data, size_t len)>;
+    
+    FFOutputSink(const Options& options, Deliver deliver);
+    ~FFOutputSink();
+    
+    FFOutputSink(const FFOutputSink&) = delete;
+    FFOutputSink& operator=(const FFOutputSink&) = delete;
+    
+    // 写入线程调用; int_cb 返回非 0 时停止等待;
+    int write(const uint8_t* data, size_t len, const AVIOInterruptCB* int_cb);
+    // 投递剩余数据及结束标记, 仅生效一次; int_cb 同 write, 命令中止时不再等待消费, 剩余数据丢弃;
+    int finish(const AVIOInterruptCB* int_cb);
+    
+    // 任意线程调用; 通知已消费的字节数;
+    void consumed(size_t len);
+    // 唤醒并终止等待中的写入, 之后的写入直接失败;
+    void cancel();
+    
+    const Options& options() const { return _options; }
+    
+private:
+    int deliverChunk(uint8_t* data, size_t len, const AVIOInterruptCB* int_cb);
+    
+    Options _options;
+    Deliver _deliver;
+    
+    uint8_t* _chunk { nullptr };
+    size_t _chunk_len { 0 };
+    
+    std::mutex _mtx;
+    std::condition_variable _cv;
+    size_t _queued_bytes { 0 }; // 已投递未消费的字节数;
+    bool _cancelled { false };
+    bool _finished { false };
+};
+
+#endif //FFMPEGPROJ_FF_OUTPUT_SINK_H
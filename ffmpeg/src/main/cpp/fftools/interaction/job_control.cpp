@@ -0,0 +1,195 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/25.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "job_control.h"
+#include <algorithm>
+#include <chrono>
+extern "C" {
+#include "libavformat/avio.h"
+}
+
+// 暂停及限速期间检查中断的间隔;
+static constexpr int64_t JOB_CONTROL_TICK_MS = 50;
+// 落后超过该时长(如暂停后或设备性能不足)时重新取基准, 避免之后集中追赶;
+static constexpr int64_t JOB_PACER_MAX_LAG_US = 500000;
+// cpu 占比: 每连续执行该时长后按比例阻塞;
+static constexpr int64_t JOB_PACER_CPU_SLICE_US = 20000;
+
+static thread_local FFJobControl *current_job_control = nullptr;
+
+static int64_t job_control_now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void FFJobControl::pause() {
+    std::lock_guard<std::mutex> lock(_mtx);
+    if ( _paused.exchange(true, std::memory_order_acq_rel) ) {
+        return;
+    }
+    _pause_start_time_us = job_control_now_us();
+}
+
+void FFJobControl::resume() {
+    std::lock_guard<std::mutex> lock(_mtx);
+    if ( !_paused.exchange(false, std::memory_order_acq_rel) ) {
+        return;
+    }
+    _paused_time_us.fetch_add(job_control_now_us() - _pause_start_time_us);
+    _cv.notify_all();
+}
+
+int64_t FFJobControl::waitWhilePaused(int (*interrupted)(void *opaque), void *opaque) {
+    if ( !isPaused() ) {
+        return 0;
+    }
+
+    int64_t start_time_us = job_control_now_us();
+    std::unique_lock<std::mutex> lock(_mtx);
+    while ( _paused.load(std::memory_order_acquire) ) {
+        if ( interrupted && interrupted(opaque) ) {
+            break;
+        }
+        _cv.wait_for(lock, std::chrono::milliseconds(JOB_CONTROL_TICK_MS));
+    }
+    return job_control_now_us() - start_time_us;
+}
+
+void FFJobControl::setThrottle(double speed, double cpu_share) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _speed.store(speed > 0 ? speed : 0);
+    _cpu_share.store(cpu_share > 0 && cpu_share < 1 ? cpu_share : 0);
+    _generation.fetch_add(1);
+    _cv.notify_all();
+}
+
+void FFJobControl::beginSharedPacing() {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _shared_pacing_jobs.fetch_add(1);
+    _generation.fetch_add(1);
+    _cv.notify_all();
+}
+
+void FFJobControl::endSharedPacing() {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _shared_pacing_jobs.fetch_sub(1);
+    _generation.fetch_add(1);
+    _cv.notify_all();
+}
+
+int64_t FFJobControl::sleepUntil(int64_t deadline_us, int64_t generation, int (*interrupted)(void *opaque), void *opaque) {
+    int64_t start_time_us = job_control_now_us();
+    std::unique_lock<std::mutex> lock(_mtx);
+    while ( true ) {
+        int64_t now_us = job_control_now_us();
+        if ( now_us >= deadline_us || _generation.load() != generation || isPaused() ) {
+            break;
+        }
+        if ( interrupted && interrupted(opaque) ) {
+            break;
+        }
+        _cv.wait_for(lock, std::chrono::microseconds(std::min(deadline_us - now_us, JOB_CONTROL_TICK_MS * 1000)));
+    }
+    lock.unlock();
+    int64_t slept_us = job_control_now_us() - start_time_us;
+    _throttled_time_us.fetch_add(slept_us);
+    return slept_us;
+}
+
+int64_t FFJobControl::paceMedia(NativeJobPacer* pacer, int64_t media_time_us, int (*interrupted)(void *opaque), void *opaque) {
+    double speed = throttleSpeed();
+    int64_t generation = _generation.load();
+    if ( speed <= 0 ) {
+        pacer->generation = 0;
+        return 0;
+    }
+    // 并发的命令平分倍速;
+    int shared_jobs = _shared_pacing_jobs.load();
+    if ( shared_jobs > 1 ) speed /= shared_jobs;
+
+    int64_t now_us = job_control_now_us();
+    int64_t deadline_us = pacer->wall_time_us + static_cast<int64_t>((media_time_us - pacer->media_time_us) / speed);
+    if ( pacer->generation != generation || media_time_us < pacer->media_time_us || now_us - deadline_us > JOB_PACER_MAX_LAG_US ) {
+        pacer->generation = generation;
+        pacer->wall_time_us = now_us;
+        pacer->media_time_us = media_time_us;
+        return 0;
+    }
+    return deadline_us > now_us ? sleepUntil(deadline_us, generation, interrupted, opaque) : 0;
+}
+
+int64_t FFJobControl::paceCpu(NativeJobPacer* pacer, int (*interrupted)(void *opaque), void *opaque) {
+    double cpu_share = cpuShare();
+    int64_t now_us = job_control_now_us();
+    if ( cpu_share <= 0 || pacer->slice_start_us == 0 ) {
+        pacer->slice_start_us = now_us;
+        return 0;
+    }
+
+    int64_t busy_us = now_us - pacer->slice_start_us;
+    if ( busy_us < JOB_PACER_CPU_SLICE_US ) {
+        return 0;
+    }
+    int64_t idle_us = static_cast<int64_t>(busy_us * (1 - cpu_share) / cpu_share);
+    int64_t slept_us = sleepUntil(now_us + idle_us, _generation.load(), interrupted, opaque);
+    pacer->slice_start_us = job_control_now_us();
+    return slept_us;
+}
+
+void ff_set_job_control(FFJobControl *control) {
+    current_job_control = control;
+}
+
+void *native_job_control_current(void) {
+    return current_job_control;
+}
+
+int64_t native_job_control_wait(void *control, const AVIOInterruptCB *int_cb) {
+    if ( control == nullptr ) {
+        return 0;
+    }
+    FFJobControl *job_control = reinterpret_cast<FFJobControl *>(control);
+    return int_cb ? job_control->waitWhilePaused(int_cb->callback, int_cb->opaque) : job_control->waitWhilePaused(nullptr, nullptr);
+}
+
+int64_t native_job_control_pace_media(void *control, NativeJobPacer *pacer, int64_t media_time_us, const AVIOInterruptCB *int_cb) {
+    if ( control == nullptr ) {
+        return 0;
+    }
+    FFJobControl *job_control = reinterpret_cast<FFJobControl *>(control);
+    return int_cb ? job_control->paceMedia(pacer, media_time_us, int_cb->callback, int_cb->opaque) : job_control->paceMedia(pacer, media_time_us, nullptr, nullptr);
+}
+
+int64_t native_job_control_pace_cpu(void *control, NativeJobPacer *pacer, const AVIOInterruptCB *int_cb) {
+    if ( control == nullptr ) {
+        return 0;
+    }
+    FFJobControl *job_control = reinterpret_cast<FFJobControl *>(control);
+    return int_cb ? job_control->paceCpu(pacer, int_cb->callback, int_cb->opaque) : job_control->paceCpu(pacer, nullptr, nullptr);
+}
+
+int native_job_control_is_throttled(void *control) {
+    return control ? reinterpret_cast<FFJobControl *>(control)->isThrottled() : 0;
+}
+
+int64_t native_job_control_throttled_time(void *control) {
+    return control ? reinterpret_cast<FFJobControl *>(control)->throttledTimeUs() : 0;
+}
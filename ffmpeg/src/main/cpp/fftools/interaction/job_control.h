@@ -0,0 +1,119 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/25.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef FFMPEGPROJ_JOB_CONTROL_H
+#define FFMPEGPROJ_JOB_CONTROL_H
+
+#include <stdint.h>
+
+struct AVIOInterruptCB;
+
+// 限速的状态, 由调用方持有, 每个调用位置一个; 初始化为 0;
+typedef struct NativeJobPacer {
+    int64_t generation;     // 限速设置变化后重新取基准;
+    int64_t wall_time_us;   // 基准时间;
+    int64_t media_time_us;  // 基准时间对应的媒体时间;
+    int64_t slice_start_us; // cpu 占比: 本轮开始执行的时间;
+} NativeJobPacer;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+    // 当前线程执行的命令的控制器, 未设置时为空;
+    void *native_job_control_current(void);
+    // 暂停期间阻塞当前线程直到恢复; int_cb 用于中断等待, 可以为空; 返回阻塞的时长(微秒);
+    // control 为空时立即返回;
+    int64_t native_job_control_wait(void *control, const struct AVIOInterruptCB *int_cb);
+    // 按限速倍率控制读取速度: media_time_us 为即将处理的 packet 的媒体时间, 超前时阻塞; 返回阻塞的时长(微秒);
+    int64_t native_job_control_pace_media(void *control, NativeJobPacer *pacer, int64_t media_time_us, const struct AVIOInterruptCB *int_cb);
+    // 按 cpu 占比控制主循环, 每次循环调用一次; 连续执行一段时间后按比例阻塞; 返回阻塞的时长(微秒);
+    // 暂停后需将 pacer->slice_start_us 置为 0;
+    int64_t native_job_control_pace_cpu(void *control, NativeJobPacer *pacer, const struct AVIOInterruptCB *int_cb);
+    // 是否设置了限速, 以及因限速累计阻塞的时长(微秒);
+    int native_job_control_is_throttled(void *control);
+    int64_t native_job_control_throttled_time(void *control);
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+/**
+ * 执行中命令的控制器, 由 js 线程修改, 命令的主循环及读取线程在每个 packet 之前检查;
+ *
+ * 暂停时线程阻塞在条件变量上, 不占用 cpu; 读取线程停止读取, 缓存的 packet 数量受各队列上限约束;
+ * 限速: 按媒体时间限制处理速度(倍速, 类似 -readrate 但可以随时调整), 或限制命令执行时间的占比(cpu 占比), 同时设置时均生效;
+ */
+class FFJobControl {
+public:
+    void pause();
+    void resume();
+    bool isPaused() const { return _paused.load(std::memory_order_acquire); }
+
+    // 暂停期间阻塞, 每隔一段时间检查 interrupted, 返回 true 时立即返回; 返回阻塞的时长(微秒);
+    int64_t waitWhilePaused(int (*interrupted)(void *opaque), void *opaque);
+
+    // 累计暂停的时长(微秒), 不包括正在进行中的暂停;
+    int64_t pausedTimeUs() const { return _paused_time_us.load(); }
+
+    // speed <= 0 表示不限制倍速; cpu_share 不在 (0, 1) 范围内时表示不限制占比;
+    void setThrottle(double speed, double cpu_share);
+    double throttleSpeed() const { return _speed.load(); }
+    double cpuShare() const { return _cpu_share.load(); }
+    bool isThrottled() const { return throttleSpeed() > 0 || cpuShare() > 0; }
+
+    // 共用倍速限制的并发命令(如并行转码的分段), 各命令按 speed / 并发数 限速, 合计不超过设置的倍速;
+    // 命令开始前调用 beginSharedPacing, 结束后调用 endSharedPacing; 并发数变化后各命令重新取基准;
+    void beginSharedPacing();
+    void endSharedPacing();
+
+    int64_t paceMedia(NativeJobPacer* pacer, int64_t media_time_us, int (*interrupted)(void *opaque), void *opaque);
+    int64_t paceCpu(NativeJobPacer* pacer, int (*interrupted)(void *opaque), void *opaque);
+
+    // 因限速累计阻塞的时长(微秒);
+    int64_t throttledTimeUs() const { return _throttled_time_us.load(); }
+
+private:
+    // 阻塞到 deadline_us, 期间限速设置变化、暂停或中断时提前返回; 返回阻塞的时长(微秒);
+    int64_t sleepUntil(int64_t deadline_us, int64_t generation, int (*interrupted)(void *opaque), void *opaque);
+
+    std::atomic<bool> _paused { false };
+    std::atomic<int64_t> _paused_time_us { 0 };
+    int64_t _pause_start_time_us { 0 };
+    std::atomic<double> _speed { 0 };
+    std::atomic<double> _cpu_share { 0 };
+    std::atomic<int> _shared_pacing_jobs { 0 };
+    std::atomic<int64_t> _generation { 1 };
+    std::atomic<int64_t> _throttled_time_us { 0 };
+    std::mutex _mtx;
+    std::condition_variable _cv;
+};
+
+// 设置当前线程执行的命令的控制器; 命令开始前设置, 结束后清除;
+void ff_set_job_control(FFJobControl *control);
+#endif
+
+#endif //FFMPEGPROJ_JOB_CONTROL_H
@@ -0,0 +1,136 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/9/1.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "job_report.h"
+#include <chrono>
+#include <sys/resource.h>
+
+static thread_local FFJobReport *current_job_report = nullptr;
+static thread_local int current_stage = NATIVE_JOB_STAGE_NONE;
+static thread_local int64_t current_stage_start_us = 0;
+
+static int64_t job_report_now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static int64_t timeval_us(const struct timeval& tv) {
+    return static_cast<int64_t>(tv.tv_sec) * 1000000LL + tv.tv_usec;
+}
+
+void FFJobReport::begin() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    _start_user_time_us = timeval_us(usage.ru_utime);
+    _start_sys_time_us = timeval_us(usage.ru_stime);
+    getrusage(RUSAGE_THREAD, &usage);
+    _start_thread_user_time_us = timeval_us(usage.ru_utime);
+    _start_thread_sys_time_us = timeval_us(usage.ru_stime);
+    _start_wall_time_us = job_report_now_us();
+}
+
+void FFJobReport::end() {
+    _wall_time_us = job_report_now_us() - _start_wall_time_us;
+    
+    struct rusage usage;
+    getrusage(RUSAGE_THREAD, &usage);
+    addThreadTime(timeval_us(usage.ru_utime) - _start_thread_user_time_us, timeval_us(usage.ru_stime) - _start_thread_sys_time_us);
+    getrusage(RUSAGE_SELF, &usage);
+    _user_time_us = timeval_us(usage.ru_utime) - _start_user_time_us;
+    _sys_time_us = timeval_us(usage.ru_stime) - _start_sys_time_us;
+    _max_rss = static_cast<int64_t>(usage.ru_maxrss) * 1024;
+}
+
+void FFJobReport::addStageTime(int stage, int64_t time_us) {
+    if ( stage >= 0 && stage < NATIVE_JOB_STAGE_NB ) _stage_time_us[stage].fetch_add(time_us, std::memory_order_relaxed);
+}
+
+void FFJobReport::addThreadTime(int64_t user_time_us, int64_t sys_time_us) {
+    _thread_user_time_us.fetch_add(user_time_us, std::memory_order_relaxed);
+    _thread_sys_time_us.fetch_add(sys_time_us, std::memory_order_relaxed);
+}
+
+void FFJobReport::addIO(int64_t bytes_read, int64_t bytes_written) {
+    if ( bytes_read > 0 ) _bytes_read.fetch_add(bytes_read, std::memory_order_relaxed);
+    if ( bytes_written > 0 ) _bytes_written.fetch_add(bytes_written, std::memory_order_relaxed);
+}
+
+void FFJobReport::setSummary(const NativeJobSummary& summary) {
+    _summary = summary;
+}
+
+void ff_set_job_report(FFJobReport *report) {
+    current_job_report = report;
+    current_stage = NATIVE_JOB_STAGE_NONE;
+}
+
+void *native_job_report_current(void) {
+    return current_job_report;
+}
+
+void native_job_report_bind(void *report) {
+    ff_set_job_report(static_cast<FFJobReport *>(report));
+}
+
+void native_job_report_thread_finish(void) {
+    FFJobReport *report = current_job_report;
+    if ( report ) {
+        // 读取/封装线程每次命令新建, 线程的全部 cpu 时间都属于该命令;
+        struct rusage usage;
+        getrusage(RUSAGE_THREAD, &usage);
+        report->addThreadTime(timeval_us(usage.ru_utime), timeval_us(usage.ru_stime));
+    }
+    ff_set_job_report(nullptr);
+}
+
+int native_job_report_stage_enter(int stage) {
+    FFJobReport *report = current_job_report;
+    if ( report == nullptr ) {
+        return NATIVE_JOB_STAGE_NONE;
+    }
+    int64_t now_us = job_report_now_us();
+    int previous = current_stage;
+    if ( previous != NATIVE_JOB_STAGE_NONE ) report->addStageTime(previous, now_us - current_stage_start_us);
+    current_stage = stage;
+    current_stage_start_us = now_us;
+    return previous;
+}
+
+void native_job_report_stage_leave(int previous) {
+    FFJobReport *report = current_job_report;
+    if ( report == nullptr ) {
+        return;
+    }
+    int64_t now_us = job_report_now_us();
+    if ( current_stage != NATIVE_JOB_STAGE_NONE ) report->addStageTime(current_stage, now_us - current_stage_start_us);
+    current_stage = previous;
+    current_stage_start_us = now_us;
+}
+
+void native_job_report_add_io(int64_t bytes_read, int64_t bytes_written) {
+    FFJobReport *report = current_job_report;
+    if ( report ) report->addIO(bytes_read, bytes_written);
+}
+
+void native_job_report_set_summary(const NativeJobSummary *summary) {
+    FFJobReport *report = current_job_report;
+    if ( report && summary ) report->setSummary(*summary);
+}
@@ -0,0 +1,150 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/9/1.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef FFMPEGPROJ_JOB_REPORT_H
+#define FFMPEGPROJ_JOB_REPORT_H
+
+#include <stdint.h>
+
+#define NATIVE_REPORT_MAX_STREAMS 32
+
+// 命令执行的阶段; 主线程负责解码/滤镜/编码, 读取及封装各自在独立的线程中;
+typedef enum NativeJobStage {
+    NATIVE_JOB_STAGE_NONE = -1,
+    NATIVE_JOB_STAGE_DEMUX = 0,
+    NATIVE_JOB_STAGE_DECODE,
+    NATIVE_JOB_STAGE_FILTER,
+    NATIVE_JOB_STAGE_ENCODE,
+    NATIVE_JOB_STAGE_MUX,
+    NATIVE_JOB_STAGE_NB,
+} NativeJobStage;
+
+// 单个输入/输出流的统计;
+typedef struct NativeStreamReport {
+    int32_t file_index;
+    int32_t stream_index;
+    int32_t media_type;         // enum AVMediaType;
+    int32_t is_output;
+    char codec_name[32];        // 输入: 解码器名称, 未解码时为编码格式; 输出: 编码器名称, 流复制时为 copy;
+    int64_t packets;            // 输入: 读取的包数量; 输出: 写入的包数量;
+    int64_t frames;             // 输入: 解码的帧数; 输出: 编码的帧数;
+    int64_t samples;            // 音频解码/编码的采样数;
+    int64_t bytes;              // 包的总大小;
+    int64_t decode_errors;      // 仅输入;
+} NativeStreamReport;
+
+// 命令共享的 packet/frame 对象池的统计;
+typedef struct NativePoolReport {
+    int64_t hits;               // 复用池中对象的次数;
+    int64_t misses;             // 池为空时新分配的次数;
+    int64_t discarded;          // 超出保留上限被释放的次数;
+    int64_t high_water;         // 同时在用的最大数量;
+} NativePoolReport;
+
+// 命令结束时 fftools 填充的统计;
+typedef struct NativeJobSummary {
+    int64_t frames_decoded;     // 成功解码的帧数;
+    int64_t decode_errors;      // 解码失败的次数;
+    int64_t dup_frames;
+    int64_t drop_frames;
+    NativePoolReport packet_pool;
+    NativePoolReport frame_pool;
+    int32_t nb_streams;         // 最多 NATIVE_REPORT_MAX_STREAMS 个;
+    NativeStreamReport streams[NATIVE_REPORT_MAX_STREAMS];
+} NativeJobSummary;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+    // 当前线程执行的命令的报告, 未设置时为空;
+    void *native_job_report_current(void);
+    // 读取/封装线程启动后关联到命令的报告, report 可以为空;
+    void native_job_report_bind(void *report);
+    // 读取/封装线程结束前调用, 计入线程的 cpu 时间并解除关联;
+    void native_job_report_thread_finish(void);
+    // 进入阶段, 返回之前所处的阶段, 离开时原样传入; 之前阶段的计时在此期间暂停; 未关联报告时不计时;
+    int native_job_report_stage_enter(int stage);
+    void native_job_report_stage_leave(int previous);
+    // 读取/写入的字节数(文件或内存 io);
+    void native_job_report_add_io(int64_t bytes_read, int64_t bytes_written);
+    void native_job_report_set_summary(const NativeJobSummary *summary);
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+#include <atomic>
+
+/**
+ * 单次命令的资源及性能统计, 每次执行都会收集, 与 -benchmark 无关;
+ *
+ * 各阶段的耗时由所在线程分段计时(嵌套时外层暂停计时), 仅在关联了报告的线程中计时;
+ * user/sys 时间及峰值内存取自进程级的 getrusage, 同时执行多个命令时包含其他命令的消耗;
+ * 命令自身线程(主线程/读取/封装线程)的 cpu 时间单独统计, 不包括编解码器及滤镜内部的工作线程;
+ */
+class FFJobReport {
+public:
+    // 在执行命令的线程中调用;
+    void begin();
+    void end();
+
+    int64_t wallTimeUs() const { return _wall_time_us; }
+    int64_t userTimeUs() const { return _user_time_us; }
+    int64_t sysTimeUs() const { return _sys_time_us; }
+    int64_t maxRss() const { return _max_rss; } // 字节, 进程的峰值;
+    int64_t threadUserTimeUs() const { return _thread_user_time_us.load(); }
+    int64_t threadSysTimeUs() const { return _thread_sys_time_us.load(); }
+    int64_t bytesRead() const { return _bytes_read.load(); }
+    int64_t bytesWritten() const { return _bytes_written.load(); }
+    int64_t stageTimeUs(int stage) const { return _stage_time_us[stage].load(); }
+    // 命令结束后读取;
+    const NativeJobSummary& summary() const { return _summary; }
+
+    void addStageTime(int stage, int64_t time_us);
+    void addThreadTime(int64_t user_time_us, int64_t sys_time_us);
+    void addIO(int64_t bytes_read, int64_t bytes_written);
+    void setSummary(const NativeJobSummary& summary);
+
+private:
+    int64_t _start_wall_time_us { 0 };
+    int64_t _start_user_time_us { 0 };
+    int64_t _start_sys_time_us { 0 };
+    int64_t _start_thread_user_time_us { 0 };
+    int64_t _start_thread_sys_time_us { 0 };
+
+    int64_t _wall_time_us { 0 };
+    int64_t _user_time_us { 0 };
+    int64_t _sys_time_us { 0 };
+    int64_t _max_rss { 0 };
+    std::atomic<int64_t> _thread_user_time_us { 0 };
+    std::atomic<int64_t> _thread_sys_time_us { 0 };
+    std::atomic<int64_t> _bytes_read { 0 };
+    std::atomic<int64_t> _bytes_written { 0 };
+    std::atomic<int64_t> _stage_time_us[NATIVE_JOB_STAGE_NB] {};
+    NativeJobSummary _summary {};
+};
+
+// 设置当前线程执行的命令的报告; 命令开始前设置, 结束后清除;
+void ff_set_job_report(FFJobReport *report);
+#endif
+
+#endif //FFMPEGPROJ_JOB_REPORT_H
@@ -41,6 +41,7 @@
 
 #include "log_callback.h"
 #include "ff_ctx.hpp"
+#include <cstring>
 
 EXTERN_C_START
 static void 
@@ -48,50 +49,39 @@ native_log_callback(int level, const char *message) {
     ff_invoke_log_callback(level, message);
 }
 
-static char *
-native_log_msg_concat(const char *prev, const char *next) {
-    size_t prev_len = prev != nullptr ? strlen(prev) : 0;
-    size_t next_len = next != nullptr ? strlen(next) : 0;
-    if ( prev_len == 0 && next_len == 0 ) return nullptr;
-    
-    // 计算总长度并分配空间
-    size_t total_len = prev_len + next_len + 1; // +1 预留 '\0';
-    char *result = new char[total_len];
-    if (prev != nullptr) {
-        strcpy(result, prev);
-    } 
-    else {
-        result[0] = '\0';
-    }
-    if (next != nullptr) {
-        strcat(result, next);
-    }
-    return result;
-}
+// 单行日志的最大长度, 超出后先输出已拼接的部分;
+#define NATIVE_LOG_LINE_SIZE 4096
 
 void
 native_log(int level, const char *next_msg) {
     _Thread_local static int prev_level = 0;
-    _Thread_local static const char *msg_line = nullptr; // 记录一行的日志;
+    _Thread_local static char msg_line[NATIVE_LOG_LINE_SIZE]; // 记录一行的日志;
+    _Thread_local static size_t msg_line_len = 0;
     
     // 如果level更换了, 则输出之前的log;
-    if ( msg_line != nullptr && level != prev_level ) {
+    if ( msg_line_len > 0 && level != prev_level ) {
         native_log_callback(prev_level, msg_line);
-        delete [] msg_line;
-        msg_line = nullptr;
+        msg_line_len = 0;
     }
     
     size_t next_len = strlen(next_msg);
     bool ends_with_newline = (next_len > 0 && next_msg[next_len - 1] == '\n');
-    char *new_msg = native_log_msg_concat(msg_line, next_msg);
-    delete[] msg_line;
-    msg_line = new_msg;
+    
+    // 缓冲区不足时先输出已拼接的部分;
+    if ( msg_line_len > 0 && msg_line_len + next_len >= NATIVE_LOG_LINE_SIZE ) {
+        native_log_callback(level, msg_line);
+        msg_line_len = 0;
+    }
+    
+    size_t copy_len = next_len < NATIVE_LOG_LINE_SIZE - 1 ? next_len : NATIVE_LOG_LINE_SIZE - 1;
+    memcpy(msg_line + msg_line_len, next_msg, copy_len);
+    msg_line_len += copy_len;
+    msg_line[msg_line_len] = '\0';
 
     // 如果一行结束, 则输出拼接后的完整消息并清空 `msg_line`;
-    if (ends_with_newline && msg_line != nullptr) {
+    if ( ends_with_newline && msg_line_len > 0 ) {
         native_log_callback(level, msg_line);
-        delete[] msg_line;
-        msg_line = nullptr;
+        msg_line_len = 0;
     } 
     else {
         prev_level = level;  // 更新日志级别;
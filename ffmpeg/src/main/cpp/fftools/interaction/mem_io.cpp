@@ -0,0 +1,368 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/23.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "mem_io.h"
+#include "napi/native_api.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+extern "C" {
+#include "libavformat/avio.h"
+#include "libavutil/error.h"
+#include "libavutil/mem.h"
+}
+
+static constexpr int MEM_IO_BUFFER_SIZE = 32 * 1024;
+static constexpr size_t MEM_IO_MIN_CAPACITY = 64 * 1024;
+
+struct MemIOEntry {
+    bool is_output;
+    
+    // sink://<id>, 数据写入后直接投递;
+    std::shared_ptr<FFOutputSink> sink;
+    
+    // fifo://<id>, 读取端与写入端各一个;
+    std::shared_ptr<FFBytePipe> pipe;
+    bool pipe_reader_opened = false;
+    bool pipe_writer_opened = false;
+    
+    // 输入, 数据由 js 侧的 ArrayBuffer 持有;
+    const uint8_t* data = nullptr;
+    void* owner = nullptr;
+    
+    // 输出;
+    uint8_t* out_data = nullptr;
+    size_t capacity = 0;
+    
+    size_t size = 0;
+    int open_count = 0; // 受 registry 锁保护;
+    
+    ~MemIOEntry() {
+        free(out_data);
+    }
+};
+
+struct MemIOHandle {
+    uint32_t id;
+    std::shared_ptr<MemIOEntry> entry;
+    int64_t pos;
+    AVIOInterruptCB int_cb;
+};
+
+static std::mutex mem_io_mtx;
+static std::unordered_map<uint32_t, std::shared_ptr<MemIOEntry>> mem_io_entries;
+static std::atomic<uint32_t> mem_io_next_id { 1 };
+
+static uint32_t mem_io_insert(std::shared_ptr<MemIOEntry> entry) {
+    uint32_t id = mem_io_next_id.fetch_add(1);
+    if ( id == 0 ) id = mem_io_next_id.fetch_add(1);
+    std::lock_guard<std::mutex> lock(mem_io_mtx);
+    mem_io_entries[id] = std::move(entry);
+    return id;
+}
+
+static int mem_io_read(void* opaque, uint8_t* buf, int buf_size) {
+    MemIOHandle* h = reinterpret_cast<MemIOHandle*>(opaque);
+    MemIOEntry* e = h->entry.get();
+    if ( h->pos >= static_cast<int64_t>(e->size) ) {
+        return AVERROR_EOF;
+    }
+    size_t len = std::min<size_t>(buf_size, e->size - h->pos);
+    memcpy(buf, (e->is_output ? e->out_data : e->data) + h->pos, len);
+    h->pos += len;
+    return static_cast<int>(len);
+}
+
+static int mem_io_write(void* opaque, uint8_t* buf, int buf_size) {
+    MemIOHandle* h = reinterpret_cast<MemIOHandle*>(opaque);
+    MemIOEntry* e = h->entry.get();
+    size_t end = h->pos + buf_size;
+    if ( end > e->capacity ) {
+        // 按 2 倍扩容, 减少 realloc 次数;
+        size_t capacity = std::max({ end, e->capacity * 2, MEM_IO_MIN_CAPACITY });
+        uint8_t* out_data = reinterpret_cast<uint8_t*>(realloc(e->out_data, capacity));
+        if ( out_data == nullptr ) {
+            return AVERROR(ENOMEM);
+        }
+        e->out_data = out_data;
+        e->capacity = capacity;
+    }
+    // seek 到末尾之后写入时, 中间部分补零;
+    if ( static_cast<size_t>(h->pos) > e->size ) {
+        memset(e->out_data + e->size, 0, h->pos - e->size);
+    }
+    memcpy(e->out_data + h->pos, buf, buf_size);
+    h->pos = end;
+    e->size = std::max(e->size, end);
+    return buf_size;
+}
+
+static int sink_io_write(void* opaque, uint8_t* buf, int buf_size) {
+    MemIOHandle* h = reinterpret_cast<MemIOHandle*>(opaque);
+    int ret = h->entry->sink->write(buf, buf_size, &h->int_cb);
+    return ret < 0 ? ret : buf_size;
+}
+
+static int fifo_io_write(void* opaque, uint8_t* buf, int buf_size) {
+    MemIOHandle* h = reinterpret_cast<MemIOHandle*>(opaque);
+    int ret = h->entry->pipe->write(buf, buf_size, &h->int_cb);
+    return ret < 0 ? ret : buf_size;
+}
+
+static int fifo_io_read(void* opaque, uint8_t* buf, int buf_size) {
+    MemIOHandle* h = reinterpret_cast<MemIOHandle*>(opaque);
+    return h->entry->pipe->read(buf, buf_size, &h->int_cb);
+}
+
+static const char* mem_io_scheme(const char* url) {
+    if ( url == nullptr ) return nullptr;
+    if ( strncmp(url, NATIVE_MEM_IO_SCHEME, strlen(NATIVE_MEM_IO_SCHEME)) == 0 ) return NATIVE_MEM_IO_SCHEME;
+    if ( strncmp(url, NATIVE_SINK_IO_SCHEME, strlen(NATIVE_SINK_IO_SCHEME)) == 0 ) return NATIVE_SINK_IO_SCHEME;
+    if ( strncmp(url, NATIVE_FIFO_IO_SCHEME, strlen(NATIVE_FIFO_IO_SCHEME)) == 0 ) return NATIVE_FIFO_IO_SCHEME;
+    return nullptr;
+}
+
+static int64_t mem_io_seek(void* opaque, int64_t offset, int whence) {
+    MemIOHandle* h = reinterpret_cast<MemIOHandle*>(opaque);
+    MemIOEntry* e = h->entry.get();
+    int64_t pos;
+    switch ( whence & ~AVSEEK_FORCE ) {
+        case AVSEEK_SIZE:
+            return e->size;
+        case SEEK_SET:
+            pos = offset;
+            break;
+        case SEEK_CUR:
+            pos = h->pos + offset;
+            break;
+        case SEEK_END:
+            pos = e->size + offset;
+            break;
+        default:
+            return AVERROR(EINVAL);
+    }
+    if ( pos < 0 || (!e->is_output && pos > static_cast<int64_t>(e->size)) ) {
+        return AVERROR(EINVAL);
+    }
+    h->pos = pos;
+    return pos;
+}
+
+EXTERN_C_START
+int
+native_mem_io_is_url(const char *url) {
+    return mem_io_scheme(url) != nullptr;
+}
+
+int
+native_mem_io_open(AVIOContext **pb, const char *url, int flags, const AVIOInterruptCB *int_cb) {
+    uint32_t id = ff_mem_io_parse_id(url);
+    bool write_flag = flags & AVIO_FLAG_WRITE;
+    std::shared_ptr<MemIOEntry> entry;
+    {
+        std::lock_guard<std::mutex> lock(mem_io_mtx);
+        auto it = mem_io_entries.find(id);
+        if ( it == mem_io_entries.end() ) {
+            return AVERROR(ENOENT);
+        }
+        entry = it->second;
+        const char* scheme = mem_io_scheme(url);
+        bool is_sink_url = strcmp(scheme, NATIVE_SINK_IO_SCHEME) == 0;
+        bool is_fifo_url = strcmp(scheme, NATIVE_FIFO_IO_SCHEME) == 0;
+        if ( is_sink_url != (entry->sink != nullptr) || is_fifo_url != (entry->pipe != nullptr) ) {
+            return AVERROR(ENOENT);
+        }
+        if ( entry->pipe ) {
+            // 读取端与写入端各打开一次;
+            bool& opened = write_flag ? entry->pipe_writer_opened : entry->pipe_reader_opened;
+            if ( opened ) {
+                return AVERROR(EBUSY);
+            }
+            opened = true;
+        }
+        else {
+            if ( write_flag != entry->is_output ) {
+                return AVERROR(EACCES);
+            }
+            // 输出同时只能有一个写入者;
+            if ( write_flag && entry->open_count > 0 ) {
+                return AVERROR(EBUSY);
+            }
+        }
+        entry->open_count += 1;
+    }
+    
+    if ( write_flag && !entry->pipe ) entry->size = 0;
+    
+    uint8_t* buffer = reinterpret_cast<uint8_t*>(av_malloc(MEM_IO_BUFFER_SIZE));
+    MemIOHandle* h = new MemIOHandle { id, entry, 0, int_cb ? *int_cb : AVIOInterruptCB { nullptr, nullptr } };
+    AVIOContext* ctx = nullptr;
+    if ( buffer && entry->pipe ) {
+        ctx = avio_alloc_context(buffer, MEM_IO_BUFFER_SIZE, write_flag, h, write_flag ? nullptr : fifo_io_read, write_flag ? fifo_io_write : nullptr, nullptr);
+    }
+    else if ( buffer && entry->sink ) {
+        ctx = avio_alloc_context(buffer, MEM_IO_BUFFER_SIZE, 1, h, nullptr, sink_io_write, nullptr);
+    }
+    else if ( buffer ) {
+        ctx = avio_alloc_context(buffer, MEM_IO_BUFFER_SIZE, write_flag, h, write_flag ? nullptr : mem_io_read, write_flag ? mem_io_write : nullptr, mem_io_seek);
+    }
+    if ( ctx == nullptr ) {
+        av_free(buffer);
+        delete h;
+        if ( entry->sink ) entry->sink->finish(int_cb);
+        if ( entry->pipe ) write_flag ? entry->pipe->closeWriter() : entry->pipe->closeReader();
+        std::lock_guard<std::mutex> lock(mem_io_mtx);
+        entry->open_count -= 1;
+        if ( entry->sink ) mem_io_entries.erase(id);
+        return AVERROR(ENOMEM);
+    }
+    *pb = ctx;
+    return 0;
+}
+
+int
+native_mem_io_closep(AVIOContext **pb) {
+    AVIOContext* ctx = *pb;
+    if ( ctx == nullptr ) {
+        return 0;
+    }
+    
+    if ( ctx->write_flag ) avio_flush(ctx);
+    int ret = ctx->error;
+    MemIOHandle* h = reinterpret_cast<MemIOHandle*>(ctx->opaque);
+    if ( h->entry->sink ) {
+        // 封装线程中止时(int_cb)不等待 js 侧消费;
+        int finish_ret = h->entry->sink->finish(&h->int_cb);
+        if ( ret >= 0 ) ret = finish_ret;
+    }
+    if ( h->entry->pipe ) {
+        ctx->write_flag ? h->entry->pipe->closeWriter() : h->entry->pipe->closeReader();
+    }
+    av_freep(&ctx->buffer);
+    avio_context_free(pb);
+    {
+        std::lock_guard<std::mutex> lock(mem_io_mtx);
+        h->entry->open_count -= 1;
+        // sink 已投递的数据无法重写, 只能打开一次;
+        if ( h->entry->sink ) mem_io_entries.erase(h->id);
+    }
+    delete h;
+    return ret;
+}
+EXTERN_C_END
+
+uint32_t ff_mem_io_register_input(const uint8_t *data, size_t size, void *owner) {
+    auto entry = std::make_shared<MemIOEntry>();
+    entry->is_output = false;
+    entry->data = data;
+    entry->size = size;
+    entry->owner = owner;
+    return mem_io_insert(std::move(entry));
+}
+
+uint32_t ff_mem_io_register_output(size_t initial_capacity) {
+    auto entry = std::make_shared<MemIOEntry>();
+    entry->is_output = true;
+    if ( initial_capacity > 0 ) {
+        entry->out_data = reinterpret_cast<uint8_t*>(malloc(initial_capacity));
+        if ( entry->out_data ) entry->capacity = initial_capacity;
+    }
+    return mem_io_insert(std::move(entry));
+}
+
+uint32_t ff_mem_io_register_sink(std::shared_ptr<FFOutputSink> sink) {
+    auto entry = std::make_shared<MemIOEntry>();
+    entry->is_output = true;
+    entry->sink = std::move(sink);
+    return mem_io_insert(std::move(entry));
+}
+
+uint32_t ff_mem_io_register_pipe(size_t capacity) {
+    auto entry = std::make_shared<MemIOEntry>();
+    entry->is_output = false;
+    entry->pipe = std::make_shared<FFBytePipe>(capacity);
+    return mem_io_insert(std::move(entry));
+}
+
+std::shared_ptr<FFOutputSink> ff_mem_io_get_sink(uint32_t id) {
+    std::lock_guard<std::mutex> lock(mem_io_mtx);
+    auto it = mem_io_entries.find(id);
+    return it != mem_io_entries.end() ? it->second->sink : nullptr;
+}
+
+std::shared_ptr<FFBytePipe> ff_mem_io_get_pipe(uint32_t id) {
+    std::lock_guard<std::mutex> lock(mem_io_mtx);
+    auto it = mem_io_entries.find(id);
+    return it != mem_io_entries.end() ? it->second->pipe : nullptr;
+}
+
+int ff_mem_io_unregister(uint32_t id, void **owner) {
+    std::lock_guard<std::mutex> lock(mem_io_mtx);
+    auto it = mem_io_entries.find(id);
+    if ( it == mem_io_entries.end() ) {
+        return AVERROR(ENOENT);
+    }
+    if ( it->second->open_count > 0 ) {
+        return AVERROR(EBUSY);
+    }
+    if ( owner ) *owner = it->second->owner;
+    mem_io_entries.erase(it);
+    return 0;
+}
+
+int ff_mem_io_take_output(uint32_t id, uint8_t **data, size_t *size) {
+    std::lock_guard<std::mutex> lock(mem_io_mtx);
+    auto it = mem_io_entries.find(id);
+    if ( it == mem_io_entries.end() || !it->second->is_output || it->second->sink ) {
+        return AVERROR(ENOENT);
+    }
+    MemIOEntry* e = it->second.get();
+    if ( e->open_count > 0 ) {
+        return AVERROR(EBUSY);
+    }
+    // 直接转移缓冲区, 不做复制;
+    *data = e->out_data;
+    *size = e->size;
+    e->out_data = nullptr;
+    e->capacity = 0;
+    mem_io_entries.erase(it);
+    return 0;
+}
+
+uint32_t ff_mem_io_parse_id(const char *url) {
+    const char* scheme = mem_io_scheme(url);
+    if ( scheme == nullptr ) {
+        return 0;
+    }
+    const char* p = url + strlen(scheme);
+    char* end = nullptr;
+    unsigned long id = strtoul(p, &end, 10);
+    if ( end == p || (*end != '\0' && *end != '.') ) {
+        return 0;
+    }
+    return static_cast<uint32_t>(id);
+}
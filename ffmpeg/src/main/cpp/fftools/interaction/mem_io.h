@@ -0,0 +1,78 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/23.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+//
+// mem://<id>, sink://<id>, fifo://<id>
+
+#ifndef UTILITIES_MEM_IO_H
+#define UTILITIES_MEM_IO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define NATIVE_MEM_IO_SCHEME "mem://"
+#define NATIVE_SINK_IO_SCHEME "sink://"
+#define NATIVE_FIFO_IO_SCHEME "fifo://"
+
+struct AVIOContext;
+struct AVIOInterruptCB;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+    // url 是否为 mem://<id>, sink://<id> 或 fifo://<id>, 可以带扩展名(如 mem://1.mp4)用于推断格式;
+    int native_mem_io_is_url(const char *url);
+    // 为已注册的内存输入/输出创建 AVIOContext; 输出在打开时清空已有数据; sink 仅能打开一次, 且不支持 seek;
+    // fifo 的读取端与写入端各打开一次, 不支持 seek;
+    // int_cb 用于中断等待中的 sink/fifo 读写, 可以为空;
+    int native_mem_io_open(struct AVIOContext **pb, const char *url, int flags, const struct AVIOInterruptCB *int_cb);
+    // 释放 native_mem_io_open 创建的 AVIOContext, 输出会先写入剩余数据; sink 关闭时投递结束标记并自动注销;
+    int native_mem_io_closep(struct AVIOContext **pb);
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+#include <memory>
+#include "ff_byte_pipe.hpp"
+#include "ff_output_sink.hpp"
+
+// 注册内存输入, 执行期间 data 需保持有效; owner 由调用方管理, 注销时原样返回;
+uint32_t ff_mem_io_register_input(const uint8_t *data, size_t size, void *owner);
+// 注册内存输出, 写入时按需扩容;
+uint32_t ff_mem_io_register_output(size_t initial_capacity);
+// 注册输出端, 返回 sink://<id> 的 id;
+uint32_t ff_mem_io_register_sink(std::shared_ptr<FFOutputSink> sink);
+// 注册管道, 返回 fifo://<id> 的 id;
+uint32_t ff_mem_io_register_pipe(size_t capacity);
+// 获取已注册的输出端, 不存在时返回空;
+std::shared_ptr<FFOutputSink> ff_mem_io_get_sink(uint32_t id);
+// 获取已注册的管道, 不存在时返回空;
+std::shared_ptr<FFBytePipe> ff_mem_io_get_pipe(uint32_t id);
+// 注销; 正在被使用时返回 AVERROR(EBUSY), 不存在时返回 AVERROR(ENOENT);
+int ff_mem_io_unregister(uint32_t id, void **owner);
+// 取出输出数据并注销, data 由调用方 free;
+int ff_mem_io_take_output(uint32_t id, uint8_t **data, size_t *size);
+// 解析 mem://<id>, sink://<id> 或 fifo://<id>, 失败时返回 0;
+uint32_t ff_mem_io_parse_id(const char *url);
+#endif
+
+#endif //UTILITIES_MEM_IO_H
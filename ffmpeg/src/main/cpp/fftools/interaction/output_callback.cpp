@@ -47,4 +47,9 @@ void
 native_report_output(const char *message) {
     ff_invoke_output_callback(message);
 }
+
+void
+native_report_output_len(const char *message, size_t len) {
+    ff_invoke_output_callback_len(message, len);
+}
 EXTERN_C_END
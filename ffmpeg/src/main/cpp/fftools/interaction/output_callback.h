@@ -44,10 +44,13 @@
 #ifndef UTILITIES_OUTPUT_CALLBACK_H
 #define UTILITIES_OUTPUT_CALLBACK_H
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
     void native_report_output(const char *msg);
+    void native_report_output_len(const char *msg, size_t len);
 #ifdef __cplusplus
 }
 #endif
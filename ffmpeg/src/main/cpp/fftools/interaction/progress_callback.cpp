@@ -47,4 +47,14 @@ void
 native_report_progress(const char *message) {
     ff_invoke_progress_callback(message);
 }
+
+int
+native_progress_stats_enabled(void) {
+    return ff_progress_stats_enabled();
+}
+
+void 
+native_report_progress_stats(const NativeProgress *progress) {
+    ff_invoke_progress_stats_callback(progress);
+}
 EXTERN_C_END
@@ -44,10 +44,50 @@
 #ifndef UTILITIES_PROGRESS_CALLBACK_H
 #define UTILITIES_PROGRESS_CALLBACK_H
 
+#include <stddef.h>
+#include <stdint.h>
+
+#define NATIVE_PROGRESS_MAX_OUTPUTS 32
+
+// 单个输出流的进度;
+typedef struct NativeOutputProgress {
+    int32_t file_index;
+    int32_t stream_index;
+    int32_t media_type;         // enum AVMediaType;
+    float q;                    // 编码质量, 未编码时为 -1;
+    int64_t packets_written;    // 写入的包数量(视频即帧数);
+    int64_t frames_encoded;
+    int64_t data_size;          // 写入的字节数;
+    int64_t out_time_us;        // 最近写入的 dts, 未知时为 -1;
+} NativeOutputProgress;
+
+// 结构化的进度信息, 与 print_report 输出的 key=value 文本对应; 未知的值为 -1;
+typedef struct NativeProgress {
+    int64_t frame;
+    double fps;
+    int64_t out_time_us;
+    int64_t total_size;
+    double bitrate;             // bits/s;
+    double speed;
+    int64_t dup_frames;
+    int64_t drop_frames;
+    int32_t is_last;
+    int32_t throttled;          // 是否设置了限速;
+    int64_t throttled_time_us;  // 因限速累计等待的时长;
+    int32_t nb_outputs;         // 最多 NATIVE_PROGRESS_MAX_OUTPUTS 个;
+    NativeOutputProgress outputs[NATIVE_PROGRESS_MAX_OUTPUTS];
+} NativeProgress;
+
+// 有效数据的大小(忽略未使用的 outputs);
+#define NATIVE_PROGRESS_SIZE(nb_outputs) (offsetof(NativeProgress, outputs) + (nb_outputs) * sizeof(NativeOutputProgress))
+
 #ifdef __cplusplus
 extern "C" {
 #endif
     void native_report_progress(const char *progress);
+    // 是否需要上报结构化的进度; 未设置回调时 print_report 可跳过填充;
+    int native_progress_stats_enabled(void);
+    void native_report_progress_stats(const NativeProgress *progress);
 #ifdef __cplusplus
 }
 #endif
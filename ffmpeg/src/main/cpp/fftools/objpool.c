@@ -16,7 +16,9 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include <stdatomic.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "libavcodec/packet.h"
 
@@ -24,18 +26,31 @@
 #include "libavutil/error.h"
 #include "libavutil/frame.h"
 #include "libavutil/mem.h"
+#include "libavutil_thread.h"
 
 #include "objpool.h"
 
+#define OBJPOOL_MIN_RETAINED 32
+#define OBJPOOL_MAX_RETAINED 1024
+
 struct ObjPool {
-    void        *pool[32];
+    void       **pool;
     unsigned int pool_count;
+    unsigned int pool_size;
 
     ObjPoolCBAlloc alloc;
     ObjPoolCBReset reset;
     ObjPoolCBFree  free;
+
+    pthread_mutex_t lock;
+    atomic_int      refcount;
+
+    ObjPoolStats stats;
 };
 
+static _Thread_local ObjPool *job_packet_pool;
+static _Thread_local ObjPool *job_frame_pool;
+
 ObjPool *objpool_alloc(ObjPoolCBAlloc cb_alloc, ObjPoolCBReset cb_reset,
                        ObjPoolCBFree cb_free)
 {
@@ -44,10 +59,30 @@ ObjPool *objpool_alloc(ObjPoolCBAlloc cb_alloc, ObjPoolCBReset cb_reset,
     if (!op)
         return NULL;
 
+    if (pthread_mutex_init(&op->lock, NULL)) {
+        av_freep(&op);
+        return NULL;
+    }
+
+    op->pool_size = OBJPOOL_MIN_RETAINED;
+    op->pool      = av_calloc(op->pool_size, sizeof(*op->pool));
+    if (!op->pool) {
+        pthread_mutex_destroy(&op->lock);
+        av_freep(&op);
+        return NULL;
+    }
+
     op->alloc = cb_alloc;
     op->reset = cb_reset;
     op->free  = cb_free;
+    atomic_init(&op->refcount, 1);
+
+    return op;
+}
 
+ObjPool *objpool_ref(ObjPool *op)
+{
+    atomic_fetch_add(&op->refcount, 1);
     return op;
 }
 
@@ -57,39 +92,98 @@ void objpool_free(ObjPool **pop)
 
     if (!op)
         return;
+    *pop = NULL;
+
+    if (atomic_fetch_sub(&op->refcount, 1) > 1)
+        return;
 
     for (unsigned int i = 0; i < op->pool_count; i++)
         op->free(&op->pool[i]);
+    av_freep(&op->pool);
 
-    av_freep(pop);
+    pthread_mutex_destroy(&op->lock);
+    av_free(op);
 }
 
 int  objpool_get(ObjPool *op, void **obj)
 {
+    pthread_mutex_lock(&op->lock);
+
+    op->stats.gets++;
     if (op->pool_count) {
         *obj = op->pool[--op->pool_count];
         op->pool[op->pool_count] = NULL;
-    } else
+        op->stats.hits++;
+    } else {
+        *obj = NULL;
+        op->stats.misses++;
+    }
+
+    pthread_mutex_unlock(&op->lock);
+
+    if (!*obj)
         *obj = op->alloc();
+    if (!*obj)
+        return AVERROR(ENOMEM);
+
+    pthread_mutex_lock(&op->lock);
+    op->stats.outstanding++;
+    op->stats.high_water = FFMAX(op->stats.high_water, op->stats.outstanding);
+    pthread_mutex_unlock(&op->lock);
 
-    return *obj ? 0 : AVERROR(ENOMEM);
+    return 0;
 }
 
 void objpool_release(ObjPool *op, void **obj)
 {
+    unsigned int retained;
+    int kept = 0;
+
     if (!*obj)
         return;
 
     op->reset(*obj);
 
-    if (op->pool_count < FF_ARRAY_ELEMS(op->pool))
-        op->pool[op->pool_count++] = *obj;
-    else
+    pthread_mutex_lock(&op->lock);
+
+    if (op->stats.outstanding)
+        op->stats.outstanding--;
+
+    /* keep enough objects to serve the deepest queue seen so far */
+    retained = av_clip(op->stats.high_water, OBJPOOL_MIN_RETAINED, OBJPOOL_MAX_RETAINED);
+    if (op->pool_count < retained) {
+        if (op->pool_count == op->pool_size) {
+            unsigned int new_size = FFMIN(op->pool_size * 2, OBJPOOL_MAX_RETAINED);
+            void **pool = av_realloc_array(op->pool, new_size, sizeof(*op->pool));
+            if (pool) {
+                op->pool      = pool;
+                op->pool_size = new_size;
+            }
+        }
+        if (op->pool_count < op->pool_size) {
+            op->pool[op->pool_count++] = *obj;
+            kept = 1;
+        }
+    }
+    if (!kept)
+        op->stats.discarded++;
+
+    pthread_mutex_unlock(&op->lock);
+
+    if (!kept)
         op->free(obj);
 
     *obj = NULL;
 }
 
+void objpool_get_stats(ObjPool *op, ObjPoolStats *stats)
+{
+    pthread_mutex_lock(&op->lock);
+    *stats        = op->stats;
+    stats->pooled = op->pool_count;
+    pthread_mutex_unlock(&op->lock);
+}
+
 static void *alloc_packet(void)
 {
     return av_packet_alloc();
@@ -129,3 +223,32 @@ ObjPool *objpool_alloc_frames(void)
 {
     return objpool_alloc(alloc_frame, reset_frame, free_frame);
 }
+
+ObjPool *objpool_job_packets(void)
+{
+    if (!job_packet_pool)
+        job_packet_pool = objpool_alloc_packets();
+    return job_packet_pool;
+}
+ObjPool *objpool_job_frames(void)
+{
+    if (!job_frame_pool)
+        job_frame_pool = objpool_alloc_frames();
+    return job_frame_pool;
+}
+
+void objpool_job_stats(ObjPoolStats *packets, ObjPoolStats *frames)
+{
+    memset(packets, 0, sizeof(*packets));
+    memset(frames,  0, sizeof(*frames));
+    if (job_packet_pool)
+        objpool_get_stats(job_packet_pool, packets);
+    if (job_frame_pool)
+        objpool_get_stats(job_frame_pool, frames);
+}
+
+void objpool_job_uninit(void)
+{
+    objpool_free(&job_packet_pool);
+    objpool_free(&job_frame_pool);
+}
@@ -19,19 +19,64 @@
 #ifndef FFTOOLS_OBJPOOL_H
 #define FFTOOLS_OBJPOOL_H
 
+#include <stdint.h>
+
 typedef struct ObjPool ObjPool;
 
 typedef void* (*ObjPoolCBAlloc)(void);
 typedef void  (*ObjPoolCBReset)(void *);
 typedef void  (*ObjPoolCBFree)(void **);
 
+typedef struct ObjPoolStats {
+    uint64_t gets;
+    /* objects served from the pool / freshly allocated */
+    uint64_t hits;
+    uint64_t misses;
+    /* released objects freed because the pool was at its retention limit */
+    uint64_t discarded;
+    /* objects currently handed out, and the maximum seen so far */
+    uint64_t outstanding;
+    uint64_t high_water;
+    /* objects currently kept for reuse */
+    uint64_t pooled;
+} ObjPoolStats;
+
+/**
+ * Pools are reference counted and thread-safe, so one pool may be shared
+ * by queues living on different threads. The number of objects kept for
+ * reuse follows the high-water mark of outstanding objects, clamped to
+ * [32, 1024].
+ */
 void     objpool_free(ObjPool **op);
 ObjPool *objpool_alloc(ObjPoolCBAlloc cb_alloc, ObjPoolCBReset cb_reset,
                        ObjPoolCBFree cb_free);
 ObjPool *objpool_alloc_packets(void);
 ObjPool *objpool_alloc_frames(void);
+/**
+ * Return a new reference to op; it is dropped with objpool_free().
+ */
+ObjPool *objpool_ref(ObjPool *op);
 
 int  objpool_get(ObjPool *op, void **obj);
 void objpool_release(ObjPool *op, void **obj);
 
+void objpool_get_stats(ObjPool *op, ObjPoolStats *stats);
+
+/**
+ * Packet/frame pools shared by all queues of the ffmpeg command running on
+ * the calling thread, created on first use. The returned pool is owned by
+ * the command; callers that keep it must take their own reference with
+ * objpool_ref(). May return NULL on allocation failure.
+ */
+ObjPool *objpool_job_packets(void);
+ObjPool *objpool_job_frames(void);
+/**
+ * Statistics of the shared pools; zeroed when a pool was never created.
+ */
+void     objpool_job_stats(ObjPoolStats *packets, ObjPoolStats *frames);
+/**
+ * Drop the command's references to the shared pools.
+ */
+void     objpool_job_uninit(void);
+
 #endif // FFTOOLS_OBJPOOL_H
@@ -415,8 +415,11 @@ SyncQueue *sq_alloc(enum SyncQueueType type, int64_t buf_size_us)
     sq->head_stream          = -1;
     sq->head_finished_stream = -1;
 
-    sq->pool = (type == SYNC_QUEUE_PACKETS) ? objpool_alloc_packets() :
-                                              objpool_alloc_frames();
+    /* share the command's pool with the other queues */
+    sq->pool = (type == SYNC_QUEUE_PACKETS) ? objpool_job_packets() :
+                                              objpool_job_frames();
+    if (sq->pool)
+        sq->pool = objpool_ref(sq->pool);
     if (!sq->pool) {
         av_freep(&sq);
         return NULL;
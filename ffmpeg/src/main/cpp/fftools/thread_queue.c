@@ -16,9 +16,18 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include <stdatomic.h>
 #include <stdint.h>
 #include <string.h>
 
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include "libavutil/time.h"
+#endif
+
 #include "libavutil/avassert.h"
 #include "libavutil/error.h"
 #include "libavutil/fifo.h"
@@ -39,6 +48,16 @@ typedef struct FifoElem {
     unsigned int stream_idx;
 } FifoElem;
 
+/**
+ * Parking word for the lock-free variant: the waiter samples seq, re-checks
+ * its condition and sleeps only while seq is unchanged; the notifier bumps
+ * seq after publishing and issues a wake only when someone is parked.
+ */
+typedef struct TQEvent {
+    atomic_uint seq;
+    atomic_int  waiters;
+} TQEvent;
+
 struct ThreadQueue {
     int              *finished;
     unsigned int    nb_streams;
@@ -50,8 +69,53 @@ struct ThreadQueue {
 
     pthread_mutex_t lock;
     pthread_cond_t  cond;
+
+    /* lock-free single-producer/single-consumer variant, see tq_alloc_spsc() */
+    int          spsc;
+    FifoElem    *slots;
+    size_t       nb_slots;
+    atomic_int  *spsc_finished;
+    /* written by the producer only */
+    _Alignas(64) atomic_size_t tail;
+    /* written by the consumer only */
+    _Alignas(64) atomic_size_t head;
+    TQEvent      can_read;
+    TQEvent      can_write;
 };
 
+/* polls before parking; a hand-off usually completes within this window */
+#define TQ_SPIN_COUNT 100
+
+static void event_wait(TQEvent *ev, unsigned int seq)
+{
+    for (int i = 0; i < TQ_SPIN_COUNT; i++) {
+        if (atomic_load(&ev->seq) != seq)
+            return;
+#if defined(__aarch64__)
+        __asm__ __volatile__("yield");
+#elif defined(__x86_64__) || defined(__i386__)
+        __asm__ __volatile__("pause");
+#endif
+    }
+
+#if defined(__linux__)
+    syscall(SYS_futex, &ev->seq, FUTEX_WAIT_PRIVATE, seq, NULL, NULL, 0);
+#else
+    if (atomic_load(&ev->seq) == seq)
+        av_usleep(100);
+#endif
+}
+
+static void event_notify(TQEvent *ev)
+{
+    atomic_fetch_add(&ev->seq, 1);
+    if (atomic_load(&ev->waiters) > 0) {
+#if defined(__linux__)
+        syscall(SYS_futex, &ev->seq, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+#endif
+    }
+}
+
 void tq_free(ThreadQueue **ptq)
 {
     ThreadQueue *tq = *ptq;
@@ -66,6 +130,16 @@ void tq_free(ThreadQueue **ptq)
     }
     av_fifo_freep2(&tq->fifo);
 
+    /* slot objects are allocated on first use and reused afterwards; pending
+     * items are still owned by their slot */
+    if (tq->slots) {
+        for (size_t i = 0; i < tq->nb_slots; i++)
+            if (tq->slots[i].obj)
+                objpool_release(tq->obj_pool, &tq->slots[i].obj);
+    }
+    av_freep(&tq->slots);
+    av_freep(&tq->spsc_finished);
+
     objpool_free(&tq->obj_pool);
 
     av_freep(&tq->finished);
@@ -117,12 +191,171 @@ fail:
     return NULL;
 }
 
+ThreadQueue *tq_alloc_spsc(unsigned int nb_streams, size_t queue_size,
+                           ObjPool *obj_pool, void (*obj_move)(void *dst, void *src))
+{
+    ThreadQueue *tq;
+
+    tq = av_mallocz(sizeof(*tq));
+    if (!tq)
+        return NULL;
+
+    /* tq_free() tears these down unconditionally */
+    if (pthread_cond_init(&tq->cond, NULL)) {
+        av_freep(&tq);
+        return NULL;
+    }
+    if (pthread_mutex_init(&tq->lock, NULL)) {
+        pthread_cond_destroy(&tq->cond);
+        av_freep(&tq);
+        return NULL;
+    }
+
+    tq->spsc     = 1;
+    tq->nb_slots = FFMAX(queue_size, 1);
+    tq->obj_pool = obj_pool;
+    tq->obj_move = obj_move;
+
+    tq->spsc_finished = av_calloc(nb_streams, sizeof(*tq->spsc_finished));
+    if (!tq->spsc_finished)
+        goto fail;
+    for (unsigned int i = 0; i < nb_streams; i++)
+        atomic_init(&tq->spsc_finished[i], 0);
+    tq->nb_streams = nb_streams;
+
+    tq->slots = av_calloc(tq->nb_slots, sizeof(*tq->slots));
+    if (!tq->slots)
+        goto fail;
+
+    atomic_init(&tq->head, 0);
+    atomic_init(&tq->tail, 0);
+    atomic_init(&tq->can_read.seq, 0);
+    atomic_init(&tq->can_read.waiters, 0);
+    atomic_init(&tq->can_write.seq, 0);
+    atomic_init(&tq->can_write.waiters, 0);
+
+    return tq;
+fail:
+    tq_free(&tq);
+    return NULL;
+}
+
+static int spsc_send(ThreadQueue *tq, unsigned int stream_idx, void *data)
+{
+    atomic_int *finished = &tq->spsc_finished[stream_idx];
+    size_t tail = atomic_load_explicit(&tq->tail, memory_order_relaxed);
+    FifoElem *slot;
+    int ret;
+
+    if (atomic_load(finished) & FINISHED_SEND)
+        return AVERROR(EINVAL);
+
+    while (1) {
+        unsigned int seq;
+
+        if (atomic_load(finished) & FINISHED_RECV) {
+            atomic_fetch_or(finished, FINISHED_SEND);
+            return AVERROR_EOF;
+        }
+        if (tail - atomic_load(&tq->head) < tq->nb_slots)
+            break;
+
+        atomic_fetch_add(&tq->can_write.waiters, 1);
+        seq = atomic_load(&tq->can_write.seq);
+        if (!(atomic_load(finished) & FINISHED_RECV) &&
+            tail - atomic_load(&tq->head) >= tq->nb_slots)
+            event_wait(&tq->can_write, seq);
+        atomic_fetch_sub(&tq->can_write.waiters, 1);
+    }
+
+    slot = &tq->slots[tail % tq->nb_slots];
+    if (!slot->obj) {
+        ret = objpool_get(tq->obj_pool, &slot->obj);
+        if (ret < 0)
+            return ret;
+    }
+
+    tq->obj_move(slot->obj, data);
+    slot->stream_idx = stream_idx;
+
+    atomic_store(&tq->tail, tail + 1);
+    event_notify(&tq->can_read);
+
+    return 0;
+}
+
+static int spsc_try_receive(ThreadQueue *tq, int *stream_idx, void *data)
+{
+    size_t head = atomic_load_explicit(&tq->head, memory_order_relaxed);
+    unsigned int nb_finished = 0;
+
+    if (atomic_load(&tq->tail) != head) {
+        FifoElem *slot = &tq->slots[head % tq->nb_slots];
+
+        tq->obj_move(data, slot->obj);
+        *stream_idx = slot->stream_idx;
+
+        atomic_store(&tq->head, head + 1);
+        event_notify(&tq->can_write);
+        return 0;
+    }
+
+    for (unsigned int i = 0; i < tq->nb_streams; i++) {
+        int finished = atomic_load(&tq->spsc_finished[i]);
+
+        if (!(finished & FINISHED_SEND))
+            continue;
+
+        /* items are published before the send-finished flag, so one may
+         * have arrived since the check above */
+        if (atomic_load(&tq->tail) != head)
+            return AVERROR(EAGAIN);
+
+        if (!(finished & FINISHED_RECV)) {
+            atomic_fetch_or(&tq->spsc_finished[i], FINISHED_RECV);
+            event_notify(&tq->can_write);
+            *stream_idx = i;
+            return AVERROR_EOF;
+        }
+
+        nb_finished++;
+    }
+
+    return nb_finished == tq->nb_streams ? AVERROR_EOF : AVERROR(ENODATA);
+}
+
+static int spsc_receive(ThreadQueue *tq, int *stream_idx, void *data)
+{
+    while (1) {
+        unsigned int seq;
+        int ret = spsc_try_receive(tq, stream_idx, data);
+
+        if (ret == AVERROR(EAGAIN))
+            continue;
+        if (ret != AVERROR(ENODATA))
+            return ret;
+
+        atomic_fetch_add(&tq->can_read.waiters, 1);
+        seq = atomic_load(&tq->can_read.seq);
+        ret = spsc_try_receive(tq, stream_idx, data);
+        if (ret == AVERROR(ENODATA))
+            event_wait(&tq->can_read, seq);
+        atomic_fetch_sub(&tq->can_read.waiters, 1);
+
+        if (ret != AVERROR(ENODATA) && ret != AVERROR(EAGAIN))
+            return ret;
+    }
+}
+
 int tq_send(ThreadQueue *tq, unsigned int stream_idx, void *data)
 {
     int *finished;
     int ret;
 
     av_assert0(stream_idx < tq->nb_streams);
+
+    if (tq->spsc)
+        return spsc_send(tq, stream_idx, data);
     finished = &tq->finished[stream_idx];
 
     pthread_mutex_lock(&tq->lock);
@@ -194,6 +427,9 @@ int tq_receive(ThreadQueue *tq, int *stream_idx, void *data)
 
     *stream_idx = -1;
 
+    if (tq->spsc)
+        return spsc_receive(tq, stream_idx, data);
+
     pthread_mutex_lock(&tq->lock);
 
     while (1) {
@@ -218,6 +454,12 @@ void tq_send_finish(ThreadQueue *tq, unsigned int stream_idx)
 {
     av_assert0(stream_idx < tq->nb_streams);
 
+    if (tq->spsc) {
+        atomic_fetch_or(&tq->spsc_finished[stream_idx], FINISHED_SEND);
+        event_notify(&tq->can_read);
+        return;
+    }
+
     pthread_mutex_lock(&tq->lock);
 
     /* mark the stream as send-finished;
@@ -233,6 +475,12 @@ void tq_receive_finish(ThreadQueue *tq, unsigned int stream_idx)
 {
     av_assert0(stream_idx < tq->nb_streams);
 
+    if (tq->spsc) {
+        atomic_fetch_or(&tq->spsc_finished[stream_idx], FINISHED_RECV);
+        event_notify(&tq->can_write);
+        return;
+    }
+
     pthread_mutex_lock(&tq->lock);
 
     /* mark the stream as recv-finished;
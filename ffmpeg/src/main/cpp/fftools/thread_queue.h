@@ -38,6 +38,17 @@ typedef struct ThreadQueue ThreadQueue;
  */
 ThreadQueue *tq_alloc(unsigned int nb_streams, size_t queue_size,
                       ObjPool *obj_pool, void (*obj_move)(void *dst, void *src));
+/**
+ * Allocate a lock-free queue with the same semantics as tq_alloc(), for the
+ * case where tq_send()/tq_send_finish() are only ever called from one thread
+ * and tq_receive()/tq_receive_finish() only from one other thread.
+ *
+ * Items are handed over through a ring of queue_size slots without taking a
+ * lock; a side that has to wait (empty or full ring) parks on a futex and is
+ * only woken when the other side actually made progress.
+ */
+ThreadQueue *tq_alloc_spsc(unsigned int nb_streams, size_t queue_size,
+                           ObjPool *obj_pool, void (*obj_move)(void *dst, void *src));
 void         tq_free(ThreadQueue **tq);
 
 /**
@@ -0,0 +1,134 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/25.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "FFJobController.h"
+
+namespace FFAV {
+
+napi_value FFJobController::Init(napi_env env, napi_value exports) {
+    napi_property_descriptor properties[] = {
+        { "pause", nullptr, Pause, nullptr, nullptr, nullptr, napi_default, nullptr},
+        { "resume", nullptr, Resume, nullptr, nullptr, nullptr, napi_default, nullptr},
+        { "paused", nullptr, nullptr, GetPaused, nullptr, nullptr, napi_default, nullptr},
+        { "setThrottle", nullptr, SetThrottle, nullptr, nullptr, nullptr, napi_default, nullptr},
+    };
+    size_t property_count = sizeof(properties) / sizeof(properties[0]);
+    napi_value cons;
+    napi_define_class(env, "FFJobController", NAPI_AUTO_LENGTH, New, nullptr, property_count, properties, &cons);
+    napi_set_named_property(env, exports, "FFJobController", cons);
+    return exports;
+}
+
+void FFJobController::Destructor(napi_env env, void *nativeObject, void *finalize_hint) {     
+    FFJobController* obj = reinterpret_cast<FFJobController*>(nativeObject);
+    // 不再能恢复, 避免命令一直处于暂停状态;
+    obj->control->resume();
+    delete obj;
+}
+
+napi_value FFJobController::New(napi_env env, napi_callback_info info) {
+    napi_value new_target;
+    napi_get_new_target(env, info, &new_target);
+    if ( new_target == nullptr ) {
+        napi_throw_error(env, nullptr, "FFJobController must be called with 'new'");
+        return nullptr;
+    }
+
+    napi_value js_this;
+    napi_get_cb_info(env, info, nullptr, nullptr, &js_this, nullptr);
+    
+    FFJobController* obj = new FFJobController();
+    napi_wrap(env, js_this, reinterpret_cast<void*>(obj), FFJobController::Destructor, nullptr, nullptr);
+    return js_this;
+}
+
+napi_value FFJobController::Pause(napi_env env, napi_callback_info info) {
+    napi_value js_this;
+    napi_get_cb_info(env, info, nullptr, nullptr, &js_this, nullptr);
+
+    FFJobController* obj;
+    napi_unwrap(env, js_this, reinterpret_cast<void**>(&obj));
+    obj->control->pause();
+    return nullptr;
+}
+
+napi_value FFJobController::Resume(napi_env env, napi_callback_info info) {
+    napi_value js_this;
+    napi_get_cb_info(env, info, nullptr, nullptr, &js_this, nullptr);
+
+    FFJobController* obj;
+    napi_unwrap(env, js_this, reinterpret_cast<void**>(&obj));
+    obj->control->resume();
+    return nullptr;
+}
+
+napi_value FFJobController::GetPaused(napi_env env, napi_callback_info info) {
+    napi_value js_this;
+    napi_get_cb_info(env, info, nullptr, nullptr, &js_this, nullptr);
+
+    FFJobController* obj;
+    napi_unwrap(env, js_this, reinterpret_cast<void**>(&obj));
+    napi_value paused;
+    napi_get_boolean(env, obj->control->isPaused(), &paused);
+    return paused;
+}
+
+napi_value FFJobController::SetThrottle(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = { nullptr };
+    napi_value js_this;
+    napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
+
+    FFJobController* obj;
+    napi_unwrap(env, js_this, reinterpret_cast<void**>(&obj));
+    
+    napi_valuetype options_valuetype = napi_undefined;
+    if ( argc > 0 ) napi_typeof(env, args[0], &options_valuetype);
+    if ( options_valuetype == napi_object ) {
+        ApplyThrottle(env, args[0], obj->control.get());
+    }
+    else {
+        obj->control->setThrottle(0, 0);
+    }
+    return nullptr;
+}
+
+void FFJobController::ApplyThrottle(napi_env env, napi_value options, FFJobControl* control) {
+    double speed = 0;
+    double cpu_share = 0;
+    napi_value opt_value;
+    napi_valuetype opt_valuetype;
+    
+    // speed
+    napi_get_named_property(env, options, "speed", &opt_value);
+    napi_typeof(env, opt_value, &opt_valuetype);
+    if ( opt_valuetype == napi_number ) napi_get_value_double(env, opt_value, &speed);
+    
+    // cpuShare
+    napi_get_named_property(env, options, "cpuShare", &opt_value);
+    napi_typeof(env, opt_value, &opt_valuetype);
+    if ( opt_valuetype == napi_number ) napi_get_value_double(env, opt_value, &cpu_share);
+    
+    control->setThrottle(speed, cpu_share);
+}
+
+}
@@ -0,0 +1,53 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/25.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef FFMPEGPROJ_FFJOBCONTROLLER_H
+#define FFMPEGPROJ_FFJOBCONTROLLER_H
+
+#include "napi/native_api.h"
+#include "fftools/interaction/job_control.h"
+#include <memory>
+
+namespace FFAV {
+
+class FFJobController {
+public:
+    static napi_value Init(napi_env env, napi_value exports);
+    
+    // 解析 ThrottleOptions 并设置到 control;
+    static void ApplyThrottle(napi_env env, napi_value options, FFJobControl* control);
+    
+    // 执行命令时持有 control, controller 被回收后命令仍可继续执行;
+    std::shared_ptr<FFJobControl> control = std::make_shared<FFJobControl>();
+    
+private:
+    static void Destructor(napi_env env, void* nativeObject, void* finalize_hint);
+    
+    static napi_value New(napi_env env, napi_callback_info info);
+    static napi_value Pause(napi_env env, napi_callback_info info);
+    static napi_value Resume(napi_env env, napi_callback_info info);
+    static napi_value GetPaused(napi_env env, napi_callback_info info);
+    static napi_value SetThrottle(napi_env env, napi_callback_info info);
+};
+
+}
+#endif //FFMPEGPROJ_FFJOBCONTROLLER_H
@@ -0,0 +1,598 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/22.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#include "FFProbe.h"
+#include "FFAbortController.h"
+#include "av/utils/job_scheduler.hpp"
+#include "av/utils/probe_cache.hpp"
+#include <algorithm>
+#include <atomic>
+#include <string>
+
+EXTERN_C_START
+#include "libavutil/error.h"
+EXTERN_C_END
+
+namespace FFAV {
+
+struct FFProbeExecutionData {
+    std::string url;
+    MediaProbeOptions options;
+    MediaInfo info;
+    int ff_ret = 0;
+    JobScheduler::Priority priority = JobScheduler::NORMAL;
+    std::atomic<bool> cancel_requested { false };
+    
+    napi_threadsafe_function complete_callback_ref = nullptr;
+    napi_ref abort_signal_ref = nullptr;
+    FFAbortSignal* abort_signal = nullptr;
+    napi_deferred deferred = nullptr;
+};
+
+struct FFScanExecutionData {
+    std::vector<std::string> inputs;
+    MediaScanner::Options options;
+    JobScheduler::Priority priority = JobScheduler::BACKGROUND;
+    std::atomic<bool> cancel_requested { false };
+    uint32_t completed = 0;
+    uint32_t total = 0;
+    
+    napi_threadsafe_function batch_callback_ref = nullptr; // (results: ScanResult[], progress: ScanProgress) => void
+    napi_threadsafe_function complete_callback_ref = nullptr;
+    napi_ref abort_signal_ref = nullptr;
+    FFAbortSignal* abort_signal = nullptr;
+    napi_deferred deferred = nullptr;
+};
+
+struct FFScanBatch {
+    std::vector<MediaScanner::Result> results;
+    uint32_t completed;
+    uint32_t total;
+};
+
+// 未投递的批次数量上限, 超出时工作线程等待 js 线程处理;
+static constexpr size_t FF_SCAN_MAX_QUEUED_BATCHES = 4;
+
+static std::string NapiValueToString(napi_env env, napi_value value) {
+    size_t str_size = 0;
+    napi_get_value_string_utf8(env, value, nullptr, 0, &str_size);
+    
+    std::string result(str_size, '\0');
+    napi_get_value_string_utf8(env, value, &result[0], str_size + 1, &str_size);
+    return result;
+}
+
+// 未知的时间返回 -1;
+static double TimeToMs(int64_t time) {
+    return time != AV_NOPTS_VALUE ? time / 1000.0 : -1;
+}
+
+static void SetMetadata(napi_env env, napi_value object, const std::map<std::string, std::string>& metadata) {
+    napi_value metadata_value;
+    napi_create_object(env, &metadata_value);
+    for ( auto& pair : metadata ) {
+        napi_value value;
+        napi_create_string_utf8(env, pair.second.c_str(), pair.second.size(), &value);
+        napi_set_named_property(env, metadata_value, pair.first.c_str(), value);
+    }
+    napi_set_named_property(env, object, "metadata", metadata_value);
+}
+
+napi_value FFProbe::Init(napi_env env, napi_value exports) {
+    napi_value probe_namespace;
+    napi_create_object(env, &probe_namespace);
+    
+    napi_property_descriptor properties[] = {
+        {"probe", nullptr, Probe, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"scan", nullptr, Scan, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"setCacheMaxSize", nullptr, SetCacheMaxSize, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"clearCache", nullptr, ClearCache, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"flushCache", nullptr, FlushCache, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"getCacheStats", nullptr, GetCacheStats, nullptr, nullptr, nullptr, napi_default, nullptr},
+    };
+    
+    napi_define_properties(env, probe_namespace, sizeof(properties) / sizeof(properties[0]), properties);
+    napi_set_named_property(env, exports, "FFProbe", probe_namespace);
+    return exports;
+}
+
+napi_status FFProbe::ParseProbeOptions(napi_env env, napi_value opts, MediaProbeOptions* options) {
+    napi_valuetype opts_valuetype;
+    napi_typeof(env, opts, &opts_valuetype);
+    if ( opts_valuetype != napi_object ) {
+        return napi_ok;
+    }
+    
+    napi_value opt_value;
+    napi_valuetype opt_valuetype;
+    
+    napi_get_named_property(env, opts, "probeSize", &opt_value);
+    napi_typeof(env, opt_value, &opt_valuetype);
+    if ( opt_valuetype == napi_number ) {
+        napi_get_value_int64(env, opt_value, &options->probesize);
+    }
+    
+    // 毫秒
+    napi_get_named_property(env, opts, "analyzeDuration", &opt_value);
+    napi_typeof(env, opt_value, &opt_valuetype);
+    if ( opt_valuetype == napi_number ) {
+        int64_t analyze_duration_ms;
+        napi_get_value_int64(env, opt_value, &analyze_duration_ms);
+        options->analyzeduration = analyze_duration_ms * 1000;
+    }
+    
+    napi_get_named_property(env, opts, "findStreamInfo", &opt_value);
+    napi_typeof(env, opt_value, &opt_valuetype);
+    if ( opt_valuetype == napi_boolean ) {
+        napi_get_value_bool(env, opt_value, &options->find_stream_info);
+    }
+    
+    napi_get_named_property(env, opts, "cache", &opt_value);
+    napi_typeof(env, opt_value, &opt_valuetype);
+    if ( opt_valuetype == napi_boolean ) {
+        napi_get_value_bool(env, opt_value, &options->use_cache);
+    }
+    
+    napi_get_named_property(env, opts, "verifyContent", &opt_value);
+    napi_typeof(env, opt_value, &opt_valuetype);
+    if ( opt_valuetype == napi_boolean ) {
+        napi_get_value_bool(env, opt_value, &options->verify_content);
+    }
+    
+    napi_get_named_property(env, opts, "httpOptions", &opt_value);
+    napi_typeof(env, opt_value, &opt_valuetype);
+    if ( opt_valuetype == napi_object ) {
+        napi_value keys;
+        napi_get_property_names(env, opt_value, &keys);
+        uint32_t length = 0;
+        napi_get_array_length(env, keys, &length);
+        for ( uint32_t i = 0; i < length; i++ ) {
+            napi_value key, value;
+            napi_get_element(env, keys, i, &key);
+            std::string key_str = NapiValueToString(env, key);
+            napi_get_named_property(env, opt_value, key_str.c_str(), &value);
+            options->format_options[key_str] = NapiValueToString(env, value);
+        }
+    }
+    return napi_ok;
+}
+
+napi_status FFProbe::CreateMediaInfo(napi_env env, const MediaInfo& info, napi_value* result) {
+    napi_value value;
+    napi_create_object(env, result);
+    
+    napi_create_string_utf8(env, info.format_name.c_str(), info.format_name.size(), &value);
+    napi_set_named_property(env, *result, "formatName", value);
+    napi_create_double(env, TimeToMs(info.duration), &value);
+    napi_set_named_property(env, *result, "duration", value);
+    napi_create_double(env, TimeToMs(info.start_time), &value);
+    napi_set_named_property(env, *result, "startTime", value);
+    napi_create_int64(env, info.bit_rate, &value);
+    napi_set_named_property(env, *result, "bitRate", value);
+    SetMetadata(env, *result, info.metadata);
+    
+    napi_value streams;
+    napi_create_array_with_length(env, info.streams.size(), &streams);
+    for ( size_t i = 0 ; i < info.streams.size() ; ++ i ) {
+        const MediaStreamInfo& stream_info = info.streams[i];
+        napi_value stream;
+        napi_create_object(env, &stream);
+        napi_create_int32(env, stream_info.index, &value);
+        napi_set_named_property(env, stream, "index", value);
+        napi_create_int32(env, stream_info.media_type, &value);
+        napi_set_named_property(env, stream, "mediaType", value);
+        napi_create_string_utf8(env, stream_info.codec_name.c_str(), stream_info.codec_name.size(), &value);
+        napi_set_named_property(env, stream, "codecName", value);
+        napi_create_int64(env, stream_info.bit_rate, &value);
+        napi_set_named_property(env, stream, "bitRate", value);
+        napi_create_double(env, TimeToMs(stream_info.duration), &value);
+        napi_set_named_property(env, stream, "duration", value);
+        if ( stream_info.media_type == AVMEDIA_TYPE_AUDIO ) {
+            napi_create_int32(env, stream_info.sample_rate, &value);
+            napi_set_named_property(env, stream, "sampleRate", value);
+            napi_create_int32(env, stream_info.nb_channels, &value);
+            napi_set_named_property(env, stream, "channels", value);
+            const char* sample_fmt_name = av_get_sample_fmt_name(static_cast<AVSampleFormat>(stream_info.sample_format));
+            napi_create_string_utf8(env, sample_fmt_name ? sample_fmt_name : "", NAPI_AUTO_LENGTH, &value);
+            napi_set_named_property(env, stream, "sampleFormat", value);
+        }
+        else if ( stream_info.media_type == AVMEDIA_TYPE_VIDEO ) {
+            napi_create_int32(env, stream_info.width, &value);
+            napi_set_named_property(env, stream, "width", value);
+            napi_create_int32(env, stream_info.height, &value);
+            napi_set_named_property(env, stream, "height", value);
+            napi_create_double(env, stream_info.frame_rate, &value);
+            napi_set_named_property(env, stream, "frameRate", value);
+        }
+        SetMetadata(env, stream, stream_info.metadata);
+        napi_set_element(env, streams, i, stream);
+    }
+    napi_set_named_property(env, *result, "streams", streams);
+    return napi_ok;
+}
+
+napi_status FFProbe::CreateError(napi_env env, int ff_ret, napi_value* result) {
+    napi_value error_code, error_msg;
+    napi_create_string_utf8(env, "FF_PROBE_ERR", NAPI_AUTO_LENGTH, &error_code);
+    napi_create_string_utf8(env, av_err2str(ff_ret), NAPI_AUTO_LENGTH, &error_msg);
+    return napi_create_type_error(env, error_code, error_msg, result);
+}
+
+// probe(url: string, options?: ProbeOptions): Promise<MediaInfo>;
+napi_value FFProbe::Probe(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    int url_idx = 0;
+    int opts_idx = 1;
+    
+    napi_value args[2] = { nullptr };
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+    
+    napi_valuetype url_valuetype = napi_undefined;
+    if ( argc > url_idx ) napi_typeof(env, args[url_idx], &url_valuetype);
+    if ( url_valuetype != napi_string ) {
+        napi_throw_error(env, nullptr, "Invalid argument: url must be a string");
+        return nullptr;
+    }
+    
+    FFProbeExecutionData* d = new FFProbeExecutionData();
+    d->url = NapiValueToString(env, args[url_idx]);
+    napi_valuetype opts_valuetype = napi_undefined;
+    if ( argc > opts_idx ) napi_typeof(env, args[opts_idx], &opts_valuetype);
+    if ( opts_valuetype == napi_object ) {
+        napi_value opts = args[opts_idx];
+        ParseProbeOptions(env, opts, &d->options);
+        
+        napi_value opt_value;
+        napi_valuetype opt_valuetype;
+        napi_get_named_property(env, opts, "priority", &opt_value);
+        napi_typeof(env, opt_value, &opt_valuetype);
+        if ( opt_valuetype == napi_number ) {
+            int32_t priority_value;
+            napi_get_value_int32(env, opt_value, &priority_value);
+            if ( priority_value >= JobScheduler::INTERACTIVE && priority_value <= JobScheduler::BACKGROUND ) {
+                d->priority = static_cast<JobScheduler::Priority>(priority_value);
+            }
+        }
+        
+        napi_get_named_property(env, opts, "signal", &opt_value);
+        napi_typeof(env, opt_value, &opt_valuetype);
+        if ( opt_valuetype == napi_object ) {
+            napi_unwrap(env, opt_value, reinterpret_cast<void**>(&d->abort_signal));
+            napi_create_reference(env, opt_value, 1, &d->abort_signal_ref);
+        }
+    }
+    
+    napi_value promise;
+    napi_create_promise(env, &d->deferred, &promise);
+    
+    napi_value async_resource_name;
+    napi_create_string_utf8(env, "FFProbe", NAPI_AUTO_LENGTH, &async_resource_name);
+    napi_create_threadsafe_function(env, nullptr, nullptr, async_resource_name, 0, 1, nullptr, nullptr, nullptr, FFProbe::InvokeProbeCompleteCallback, &d->complete_callback_ref);
+    
+    JobScheduler::submit([d] { FFProbe::ExecuteProbeJob(d); }, d->priority);
+    return promise;
+}
+
+// setCacheMaxSize(bytes: number): void;
+napi_value FFProbe::SetCacheMaxSize(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = { nullptr };
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+    
+    napi_valuetype valuetype = napi_undefined;
+    if ( argc > 0 ) napi_typeof(env, args[0], &valuetype);
+    if ( valuetype != napi_number ) {
+        napi_throw_error(env, nullptr, "Invalid argument: bytes must be a number");
+        return nullptr;
+    }
+    
+    int64_t max_size = 0;
+    napi_get_value_int64(env, args[0], &max_size);
+    ProbeCache::setMaxSize(max_size > 0 ? static_cast<uint64_t>(max_size) : 0);
+    return nullptr;
+}
+
+// clearCache(): void;
+napi_value FFProbe::ClearCache(napi_env env, napi_callback_info info) {
+    ProbeCache::clear();
+    return nullptr;
+}
+
+// flushCache(): void;
+napi_value FFProbe::FlushCache(napi_env env, napi_callback_info info) {
+    ProbeCache::flush();
+    return nullptr;
+}
+
+// getCacheStats(): ProbeCacheStats;
+napi_value FFProbe::GetCacheStats(napi_env env, napi_callback_info info) {
+    ProbeCache::Stats stats = ProbeCache::getStats();
+    napi_value result, value;
+    napi_create_object(env, &result);
+    napi_create_uint32(env, stats.entries, &value);
+    napi_set_named_property(env, result, "entries", value);
+    napi_create_int64(env, static_cast<int64_t>(stats.size), &value);
+    napi_set_named_property(env, result, "size", value);
+    napi_create_int64(env, static_cast<int64_t>(stats.max_size), &value);
+    napi_set_named_property(env, result, "maxSize", value);
+    napi_create_int64(env, static_cast<int64_t>(stats.hits), &value);
+    napi_set_named_property(env, result, "hits", value);
+    napi_create_int64(env, static_cast<int64_t>(stats.misses), &value);
+    napi_set_named_property(env, result, "misses", value);
+    return result;
+}
+
+void FFProbe::ExecuteProbeJob(void *data) {
+    FFProbeExecutionData* d = reinterpret_cast<FFProbeExecutionData *>(data);
+    FFAbortSignal* signal = d->abort_signal;
+    if ( signal ) signal->setAbortedCallback([d](napi_ref reason_ref) {
+        d->cancel_requested.store(true);
+    });
+    
+    d->ff_ret = MediaProbe::probe(d->url, d->options, d->info, &d->cancel_requested);
+    
+    if ( signal ) signal->setAbortedCallback(nullptr);
+    napi_call_threadsafe_function(d->complete_callback_ref, d, napi_tsfn_nonblocking);
+}
+
+void FFProbe::InvokeProbeCompleteCallback(napi_env env, napi_value js_callback, void* context, void* data) {
+    FFProbeExecutionData* d = reinterpret_cast<FFProbeExecutionData *>(data);
+    if ( d->cancel_requested.load() ) {
+        napi_value error, error_code, error_msg;
+        napi_create_string_utf8(env, "FF_CANCELLED_ERR", NAPI_AUTO_LENGTH, &error_code);
+        napi_create_string_utf8(env, "Probe cancelled by user", NAPI_AUTO_LENGTH, &error_msg);
+        napi_create_type_error(env, error_code, error_msg, &error);
+        napi_reject_deferred(env, d->deferred, error);
+    }
+    else if ( d->ff_ret < 0 ) {
+        napi_value error;
+        CreateError(env, d->ff_ret, &error);
+        napi_reject_deferred(env, d->deferred, error);
+    }
+    else {
+        napi_value result;
+        CreateMediaInfo(env, d->info, &result);
+        napi_resolve_deferred(env, d->deferred, result);
+    }
+    if ( d->abort_signal_ref ) napi_delete_reference(env, d->abort_signal_ref);
+    napi_release_threadsafe_function(d->complete_callback_ref, napi_tsfn_release);
+    delete d;
+}
+
+
+// scan(inputs: string | string[], options: ScanOptions): Promise<ScanSummary>;
+napi_value FFProbe::Scan(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    int inputs_idx = 0;
+    int opts_idx = 1;
+    
+    napi_value args[2] = { nullptr };
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+    
+    std::vector<std::string> inputs;
+    napi_valuetype inputs_valuetype = napi_undefined;
+    bool is_array = false;
+    if ( argc > inputs_idx ) {
+        napi_typeof(env, args[inputs_idx], &inputs_valuetype);
+        napi_is_array(env, args[inputs_idx], &is_array);
+    }
+    if ( inputs_valuetype == napi_string ) {
+        inputs.push_back(NapiValueToString(env, args[inputs_idx]));
+    }
+    else if ( is_array ) {
+        uint32_t length = 0;
+        napi_get_array_length(env, args[inputs_idx], &length);
+        inputs.reserve(length);
+        for ( uint32_t i = 0 ; i < length ; ++ i ) {
+            napi_value element;
+            napi_valuetype element_valuetype;
+            napi_get_element(env, args[inputs_idx], i, &element);
+            napi_typeof(env, element, &element_valuetype);
+            if ( element_valuetype == napi_string ) inputs.push_back(NapiValueToString(env, element));
+        }
+    }
+    else {
+        napi_throw_error(env, nullptr, "Invalid argument: inputs must be a string or an array of strings");
+        return nullptr;
+    }
+    
+    napi_value opts = argc > opts_idx ? args[opts_idx] : nullptr;
+    napi_valuetype opts_valuetype = napi_undefined;
+    if ( opts ) napi_typeof(env, opts, &opts_valuetype);
+    if ( opts_valuetype != napi_object ) {
+        napi_throw_error(env, nullptr, "Invalid argument: options.batchCallback is required");
+        return nullptr;
+    }
+    
+    napi_value opt_value;
+    napi_valuetype opt_valuetype;
+    napi_get_named_property(env, opts, "batchCallback", &opt_value);
+    napi_typeof(env, opt_value, &opt_valuetype);
+    if ( opt_valuetype != napi_function ) {
+        napi_throw_error(env, nullptr, "Invalid argument: options.batchCallback is required");
+        return nullptr;
+    }
+    napi_value batch_callback = opt_value;
+    
+    FFScanExecutionData* d = new FFScanExecutionData();
+    d->inputs = std::move(inputs);
+    ParseProbeOptions(env, opts, &d->options.probe_options);
+    
+    napi_get_named_property(env, opts, "concurrency", &opt_value);
+    napi_typeof(env, opt_value, &opt_valuetype);
+    if ( opt_valuetype == napi_number ) napi_get_value_int32(env, opt_value, &d->options.concurrency);
+    
+    napi_get_named_property(env, opts, "batchSize", &opt_value);
+    napi_typeof(env, opt_value, &opt_valuetype);
+    if ( opt_valuetype == napi_number ) {
+        int32_t batch_size;
+        napi_get_value_int32(env, opt_value, &batch_size);
+        if ( batch_size > 0 ) d->options.batch_size = batch_size;
+    }
+    
+    napi_get_named_property(env, opts, "batchInterval", &opt_value);
+    napi_typeof(env, opt_value, &opt_valuetype);
+    if ( opt_valuetype == napi_number ) napi_get_value_int32(env, opt_value, &d->options.batch_interval_ms);
+    
+    napi_get_named_property(env, opts, "recursive", &opt_value);
+    napi_typeof(env, opt_value, &opt_valuetype);
+    if ( opt_valuetype == napi_boolean ) napi_get_value_bool(env, opt_value, &d->options.recursive);
+    
+    napi_get_named_property(env, opts, "extensions", &opt_value);
+    napi_is_array(env, opt_value, &is_array);
+    if ( is_array ) {
+        uint32_t length = 0;
+        napi_get_array_length(env, opt_value, &length);
+        for ( uint32_t i = 0 ; i < length ; ++ i ) {
+            napi_value element;
+            napi_get_element(env, opt_value, i, &element);
+            std::string ext = NapiValueToString(env, element);
+            if ( !ext.empty() && ext[0] == '.' ) ext.erase(0, 1);
+            std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+            d->options.extensions.push_back(std::move(ext));
+        }
+    }
+    
+    napi_get_named_property(env, opts, "priority", &opt_value);
+    napi_typeof(env, opt_value, &opt_valuetype);
+    if ( opt_valuetype == napi_number ) {
+        int32_t priority_value;
+        napi_get_value_int32(env, opt_value, &priority_value);
+        if ( priority_value >= JobScheduler::INTERACTIVE && priority_value <= JobScheduler::BACKGROUND ) {
+            d->priority = static_cast<JobScheduler::Priority>(priority_value);
+        }
+    }
+    
+    napi_get_named_property(env, opts, "signal", &opt_value);
+    napi_typeof(env, opt_value, &opt_valuetype);
+    if ( opt_valuetype == napi_object ) {
+        napi_unwrap(env, opt_value, reinterpret_cast<void**>(&d->abort_signal));
+        napi_create_reference(env, opt_value, 1, &d->abort_signal_ref);
+    }
+    
+    napi_value promise;
+    napi_create_promise(env, &d->deferred, &promise);
+    
+    napi_value async_resource_name;
+    napi_create_string_utf8(env, "FFProbe scan batch", NAPI_AUTO_LENGTH, &async_resource_name);
+    napi_create_threadsafe_function(env, batch_callback, nullptr, async_resource_name, FF_SCAN_MAX_QUEUED_BATCHES, 1, nullptr, nullptr, nullptr, FFProbe::InvokeBatchCallback, &d->batch_callback_ref);
+    napi_create_string_utf8(env, "FFProbe scan", NAPI_AUTO_LENGTH, &async_resource_name);
+    napi_create_threadsafe_function(env, nullptr, nullptr, async_resource_name, 0, 1, nullptr, nullptr, nullptr, FFProbe::InvokeScanCompleteCallback, &d->complete_callback_ref);
+    
+    JobScheduler::submit([d] { FFProbe::ExecuteScanJob(d); }, d->priority);
+    return promise;
+}
+
+void FFProbe::ExecuteScanJob(void *data) {
+    FFScanExecutionData* d = reinterpret_cast<FFScanExecutionData *>(data);
+    FFAbortSignal* signal = d->abort_signal;
+    if ( signal ) signal->setAbortedCallback([d](napi_ref reason_ref) {
+        d->cancel_requested.store(true);
+    });
+    
+    std::vector<std::string> urls = MediaScanner::collect(d->inputs, d->options);
+    d->total = static_cast<uint32_t>(urls.size());
+    d->completed = MediaScanner::scan(urls, d->options, [d](std::vector<MediaScanner::Result>&& results, uint32_t completed, uint32_t total) {
+        FFScanBatch* batch = new FFScanBatch { std::move(results), completed, total };
+        // 队列已满时阻塞, js 线程处理不及时时暂停扫描;
+        if ( napi_call_threadsafe_function(d->batch_callback_ref, batch, napi_tsfn_blocking) != napi_ok ) {
+            delete batch;
+        }
+    }, &d->cancel_requested);
+    
+    if ( signal ) signal->setAbortedCallback(nullptr);
+    // 批量扫描后在工作线程中写入缓存, 不阻塞 js 线程;
+    ProbeCache::flush();
+    napi_release_threadsafe_function(d->batch_callback_ref, napi_tsfn_release);
+    napi_call_threadsafe_function(d->complete_callback_ref, d, napi_tsfn_nonblocking);
+}
+
+napi_status FFProbe::CreateScanResult(napi_env env, const MediaScanner::Result& result, napi_value* value) {
+    napi_create_object(env, value);
+    napi_value url;
+    napi_create_string_utf8(env, result.url.c_str(), result.url.size(), &url);
+    napi_set_named_property(env, *value, "url", url);
+    if ( result.ret < 0 ) {
+        napi_value error;
+        CreateError(env, result.ret, &error);
+        napi_set_named_property(env, *value, "error", error);
+    }
+    else {
+        napi_value media_info;
+        CreateMediaInfo(env, result.info, &media_info);
+        napi_set_named_property(env, *value, "info", media_info);
+    }
+    return napi_ok;
+}
+
+// (results: ScanResult[], progress: ScanProgress) => void
+void FFProbe::InvokeBatchCallback(napi_env env, napi_value js_callback, void* context, void* data) {
+    FFScanBatch* batch = reinterpret_cast<FFScanBatch *>(data);
+    if ( env != nullptr ) {
+        napi_value results;
+        napi_create_array_with_length(env, batch->results.size(), &results);
+        for ( size_t i = 0 ; i < batch->results.size() ; ++ i ) {
+            napi_value result;
+            CreateScanResult(env, batch->results[i], &result);
+            napi_set_element(env, results, i, result);
+        }
+        
+        napi_value progress, value;
+        napi_create_object(env, &progress);
+        napi_create_uint32(env, batch->completed, &value);
+        napi_set_named_property(env, progress, "completed", value);
+        napi_create_uint32(env, batch->total, &value);
+        napi_set_named_property(env, progress, "total", value);
+        
+        napi_value global;
+        napi_get_global(env, &global);
+        napi_value args[] = { results, progress };
+        napi_call_function(env, global, js_callback, 2, args, nullptr);
+    }
+    delete batch;
+}
+
+void FFProbe::InvokeScanCompleteCallback(napi_env env, napi_value js_callback, void* context, void* data) {
+    FFScanExecutionData* d = reinterpret_cast<FFScanExecutionData *>(data);
+    if ( d->cancel_requested.load() ) {
+        napi_value error, error_code, error_msg;
+        napi_create_string_utf8(env, "FF_CANCELLED_ERR", NAPI_AUTO_LENGTH, &error_code);
+        napi_create_string_utf8(env, "Scan cancelled by user", NAPI_AUTO_LENGTH, &error_msg);
+        napi_create_type_error(env, error_code, error_msg, &error);
+        napi_reject_deferred(env, d->deferred, error);
+    }
+    else {
+        napi_value summary, value;
+        napi_create_object(env, &summary);
+        napi_create_uint32(env, d->completed, &value);
+        napi_set_named_property(env, summary, "completed", value);
+        napi_create_uint32(env, d->total, &value);
+        napi_set_named_property(env, summary, "total", value);
+        napi_resolve_deferred(env, d->deferred, summary);
+    }
+    
+    if ( d->abort_signal_ref ) napi_delete_reference(env, d->abort_signal_ref);
+    napi_release_threadsafe_function(d->complete_callback_ref, napi_tsfn_release);
+    delete d;
+}
+
+}
@@ -0,0 +1,71 @@
+/**
+    This file is part of @sj/ffmpeg.
+    
+    @sj/ffmpeg is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    @sj/ffmpeg is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with @sj/ffmpeg. If not, see <http://www.gnu.org/licenses/>.
+ * */
+//
+// Created on 2025/8/22.
+//
+// Node APIs are not fully supported. To solve the compilation error of the interface cannot be found,
+// please include "napi/native_api.h".
+
+#ifndef FFMPEGPROJ_FFPROBE_H
+#define FFMPEGPROJ_FFPROBE_H
+
+#include "napi/native_api.h"
+#include "av/ffwrap/ff_media_probe.hpp"
+#include "av/ffwrap/ff_media_scanner.hpp"
+
+namespace FFAV {
+
+/**
+ * 直接读取媒体信息, 不经过 ffprobe 命令行及 JSON 解析;
+ */
+class FFProbe {
+public:
+    static napi_value Init(napi_env env, napi_value exports);
+    
+    // options?: ProbeOptions
+    static napi_status ParseProbeOptions(napi_env env, napi_value opts, MediaProbeOptions* options);
+    // 转换为 js 对象 MediaInfo;
+    static napi_status CreateMediaInfo(napi_env env, const MediaInfo& info, napi_value* result);
+    static napi_status CreateError(napi_env env, int ff_ret, napi_value* result);
+    
+private:
+    // probe(url: string, options?: ProbeOptions): Promise<MediaInfo>;
+    static napi_value Probe(napi_env env, napi_callback_info info);
+    
+    // setCacheMaxSize(bytes: number): void;
+    static napi_value SetCacheMaxSize(napi_env env, napi_callback_info info);
+    // clearCache(): void;
+    static napi_value ClearCache(napi_env env, napi_callback_info info);
+    // flushCache(): void;
+    static napi_value FlushCache(napi_env env, napi_callback_info info);
+    // getCacheStats(): ProbeCacheStats;
+    static napi_value GetCacheStats(napi_env env, napi_callback_info info);
+    
+    static void ExecuteProbeJob(void *data);
+    static void InvokeProbeCompleteCallback(napi_env env, napi_value js_callback, void* context, void* data);
+    
+    // scan(inputs: string | string[], options: ScanOptions): Promise<ScanSummary>;
+    static napi_value Scan(napi_env env, napi_callback_info info);
+    static void ExecuteScanJob(void *data);
+    static void InvokeBatchCallback(napi_env env, napi_value js_callback, void* context, void* data);
+    static void InvokeScanCompleteCallback(napi_env env, napi_value js_callback, void* context, void* data);
+    static napi_status CreateScanResult(napi_env env, const MediaScanner::Result& result, napi_value* value);
+};
+
+}
+
+#endif //FFMPEGPROJ_FFPROBE_H
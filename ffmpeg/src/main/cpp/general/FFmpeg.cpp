@@ -21,19 +21,36 @@
 // please include "napi/native_api.h".
 
 #include "FFmpeg.h"
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <cstdio>
+#include <map>
+#include <memory>
+#include <vector>
 #include "FFAbortController.h"
+#include "FFJobController.h"
+#include "av/ffwrap/ff_media_probe.hpp"
+#include "av/ffwrap/ff_parallel_transcoder.hpp"
+#include "av/utils/font_cache.hpp"
+#include "av/utils/job_scheduler.hpp"
+#include "av/utils/probe_cache.hpp"
+#include "av/utils/thread_budget.h"
+#include "av/utils/transcode_checkpoint.hpp"
 #include "fftools/interaction/ff_ctx.hpp"
+#include "fftools/interaction/job_report.h"
+#include "fftools/interaction/mem_io.h"
 
 EXTERN_C_START
 #include "libavutil/error.h"
+#include "fftools/fftools_common.h"
 #include <stdatomic.h>
 #include <sys/stat.h>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <string>
+#include <pthread.h>
 
 int ffmpeg_main(_Atomic bool *is_running, int argc, char **argv);
 int ffprobe_main(_Atomic bool *is_running, int argc, char **argv);
@@ -41,42 +58,211 @@ EXTERN_C_END
 
 namespace FFAV { 
 
+// ffprobe 输出消息的处理方式;
+enum FFOutputMode {
+    FF_OUTPUT_CALLBACK, // 每个片段回调一次 outputCallback;
+    FF_OUTPUT_BUFFER,   // 全部缓存, 执行完成后通过 promise 返回;
+    FF_OUTPUT_CHUNKED,  // 按 outputChunkSize 分块回调 outputCallback;
+};
+
+static constexpr size_t FF_DEFAULT_OUTPUT_CHUNK_SIZE = 64 * 1024;
+
 struct FFmpegExecutionData {
     char** cmds = nullptr;
     uint32_t cmds_count = 0;
     bool is_ffmpeg;
     
     _Atomic bool is_running = true;
-    napi_threadsafe_function log_callback_ref = nullptr; // (level: number, msg: string) => void
-    napi_threadsafe_function progress_callback_ref = nullptr; // (msg: string) => void
-    napi_threadsafe_function output_callback_ref = nullptr; // (msg: string) => void
+    napi_ref log_callback_ref = nullptr; // (level: number, msg: string) => void
+    napi_ref progress_callback_ref = nullptr; // (msg: string) => void
+    napi_ref output_callback_ref = nullptr; // (msg: string) => void
+    napi_ref progress_stats_callback_ref = nullptr; // (progress: ProgressStats) => void
+    napi_ref stats_callback_ref = nullptr; // (stats: ExecutionStats) => void
+    napi_threadsafe_function flush_callback_ref = nullptr; // 批量投递日志/进度/输出消息;
+    FFCallbackChannel* callback_channel = nullptr;
     napi_ref abort_signal_ref = nullptr;
     FFAbortSignal* abort_signal = nullptr;
+    std::shared_ptr<FFJobControl> job_control; // 暂停/恢复;
+    FFJobReport report; // 仅 ffmpeg 命令; 执行成功后通过 promise 返回;
     
-    napi_async_work async_work = nullptr;
+    JobScheduler::Priority priority = JobScheduler::NORMAL;
+    napi_threadsafe_function complete_callback_ref = nullptr; // 执行结束后回到 js 线程 resolve/reject;
     napi_deferred deferred = nullptr;
     
     int ff_ret = 0;
+    int64_t callback_drain_latency_us = 0; // 命令结束后等待 js 线程消费剩余消息的时长;
+    
+    FFOutputMode output_mode = FF_OUTPUT_CALLBACK;
+    size_t output_chunk_size = FF_DEFAULT_OUTPUT_CHUNK_SIZE;
+    std::string output_buffer;
+};
+
+struct FFPipelineStage {
+    char** cmds = nullptr;
+    uint32_t cmds_count = 0;
+    bool is_ffmpeg = true;
+    int ff_ret = 0;
+    std::vector<std::shared_ptr<FFBytePipe>> output_pipes; // 该阶段写入的管道;
+};
+
+struct FFPipelineExecutionData {
+    std::vector<FFPipelineStage> stages;
+    std::vector<uint32_t> pipe_ids; // fifo://<id>, 执行结束后注销;
+    std::string invalid_reason; // 不为空时不执行, 直接以该信息 reject;
+    
+    _Atomic bool is_running = true; // 所有阶段共用, 任一阶段失败或取消时全部停止;
+    std::atomic<bool> cancel_requested { false };
+    std::atomic<int> failed_stage { -1 }; // 最先失败的阶段;
+    
+    napi_ref abort_signal_ref = nullptr;
+    FFAbortSignal* abort_signal = nullptr;
+    std::shared_ptr<FFJobControl> job_control; // 所有阶段共用;
+    JobScheduler::Priority priority = JobScheduler::NORMAL;
+    napi_threadsafe_function complete_callback_ref = nullptr;
+    napi_deferred deferred = nullptr;
+};
+
+struct FFPipelineStageContext {
+    FFPipelineExecutionData* d;
+    size_t index;
 };
 
+struct FFParallelExecutionData {
+    std::string input;
+    std::string output;
+    std::vector<std::string> output_args; // 用户传入的输出选项, 不含 -f;
+    ParallelTranscoder::Options transcode_options;
+    ParallelTranscoder::Plan plan;
+    std::vector<FFPipelineStage> segments; // 各分段的命令;
+    std::vector<uint32_t> output_ids; // 各分段输出的 mem://<id>;
+    std::string checkpoint_dir;
+    std::string checkpoint_job_id; // 不为空时启用检查点, 分段输出写入文件, 再次执行时跳过已完成的分段;
+    std::unique_ptr<TranscodeCheckpoint> checkpoint; // 只有一段时不启用;
+    size_t resumed_segments = 0; // 从检查点复用的分段数;
+    
+    _Atomic bool is_running = true; // 所有分段共用, 任一分段失败或取消时全部停止;
+    std::atomic<bool> cancel_requested { false };
+    std::atomic<int> failed_segment { -1 }; // 最先失败的分段;
+    std::atomic<int> remaining_segments { 0 };
+    int ret = 0; // 分段规划或拼接的错误码;
+    
+    napi_ref abort_signal_ref = nullptr;
+    FFAbortSignal* abort_signal = nullptr;
+    std::shared_ptr<FFJobControl> job_control; // 所有分段共用;
+    JobScheduler::Priority priority = JobScheduler::NORMAL;
+    napi_threadsafe_function complete_callback_ref = nullptr;
+    napi_deferred deferred = nullptr;
+};
+
+static constexpr size_t FF_DEFAULT_PIPE_BUFFER_SIZE = 1024 * 1024;
+// 分段输出的初始容量;
+static constexpr size_t FF_PARALLEL_SEGMENT_CAPACITY = 1024 * 1024;
+static const char* const FF_DEFAULT_CHECKPOINT_DIR = "/data/storage/el2/base/files/sj_ff_av/checkpoints";
+// 启用检查点时默认的分段时长;
+static constexpr int64_t FF_DEFAULT_CHECKPOINT_SEGMENT_DURATION_US = 60 * 1000000LL;
+// 与调度器工作线程保持一致, ffmpeg_main 的调用栈较深;
+static constexpr size_t FF_PIPELINE_STAGE_STACK_SIZE = 8 * 1024 * 1024;
+
+static std::shared_ptr<FFJobControl> GetJobControl(napi_env env, napi_value value) {
+    napi_valuetype valuetype;
+    napi_typeof(env, value, &valuetype);
+    FFJobController* controller = nullptr;
+    if ( valuetype == napi_object && napi_unwrap(env, value, reinterpret_cast<void**>(&controller)) == napi_ok && controller ) {
+        return controller->control;
+    }
+    return nullptr;
+}
+
 napi_value FFmpeg::Init(napi_env env, napi_value exports) {
     napi_value ffmpeg_namespace;
     napi_create_object(env, &ffmpeg_namespace);
     
     napi_property_descriptor properties[] = {
         {"setFontConfigDir", nullptr, SetFontConfigDir, nullptr, nullptr, nullptr, napi_default, nullptr},
-        {"execute", nullptr, Execute, nullptr, nullptr, nullptr, napi_default, nullptr}
+        {"execute", nullptr, Execute, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"setMaxConcurrentJobs", nullptr, SetMaxConcurrentJobs, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"getSchedulerStats", nullptr, GetSchedulerStats, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"prewarmWorkers", nullptr, PrewarmWorkers, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"warmup", nullptr, Warmup, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"setThreadBudget", nullptr, SetThreadBudget, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"getThreadStats", nullptr, GetThreadStats, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"prepareFonts", nullptr, PrepareFonts, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"getFontCacheStats", nullptr, GetFontCacheStats, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"createMemoryInput", nullptr, CreateMemoryInput, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"createMemoryOutput", nullptr, CreateMemoryOutput, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"takeMemoryOutput", nullptr, TakeMemoryOutput, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"releaseMemoryIO", nullptr, ReleaseMemoryIO, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"createOutputSink", nullptr, CreateOutputSink, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"executePipeline", nullptr, ExecutePipeline, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"executeParallel", nullptr, ExecuteParallel, nullptr, nullptr, nullptr, napi_default, nullptr}
     };
 
     size_t property_count = sizeof(properties) / sizeof(properties[0]);
     napi_define_properties(env, ffmpeg_namespace, property_count, properties);
     
-    napi_set_named_property(env, exports, "FFmpeg", ffmpeg_namespace);
+    // enum JobPriority
+    napi_value priority_namespace, priority;
+    napi_create_object(env, &priority_namespace);
+    napi_create_int32(env, JobScheduler::INTERACTIVE, &priority);
+    napi_set_named_property(env, priority_namespace, "INTERACTIVE", priority);
+    napi_create_int32(env, JobScheduler::NORMAL, &priority);
+    napi_set_named_property(env, priority_namespace, "NORMAL", priority);
+    napi_create_int32(env, JobScheduler::BACKGROUND, &priority);
+    napi_set_named_property(env, priority_namespace, "BACKGROUND", priority);
+    napi_set_named_property(env, ffmpeg_namespace, "JobPriority", priority_namespace);
     
-    SetFontConfigDefaultDir();
+    napi_set_named_property(env, exports, "FFmpeg", ffmpeg_namespace);
     return exports;
 }
 
+void FFmpeg::RegisterWorkerInitializer() {
+    // 环境变量在模块初始化的线程中设置, 此时工作线程尚未启动; 工作线程中只生成配置文件;
+    FontCache::initEnv();
+    // 工作线程常驻, 启动时完成 fftools 的初始化及字体配置, 之后的命令复用线程内缓存的数据;
+    JobScheduler::setWorkerInitializer([] {
+        FontCache::ensureConfig();
+        fftools_thread_init();
+    });
+    // 没有任务执行时写入累积的媒体信息缓存, 避免进程退出时丢失;
+    JobScheduler::setIdleCallback([] {
+        ProbeCache::flush();
+    });
+}
+
+struct FFWarmupData {
+    napi_deferred deferred { nullptr };
+    napi_threadsafe_function complete_callback_ref { nullptr };
+};
+
+//  export function warmup(): Promise<void>;
+napi_value FFmpeg::Warmup(napi_env env, napi_callback_info info) {
+    FFWarmupData* d = new FFWarmupData();
+    
+    napi_value promise;
+    napi_create_promise(env, &d->deferred, &promise);
+    
+    napi_value async_resource_name;
+    napi_create_string_utf8(env, "FFmpegWarmup", NAPI_AUTO_LENGTH, &async_resource_name);
+    napi_create_threadsafe_function(env, nullptr, nullptr, async_resource_name, 0, 1, nullptr, nullptr, nullptr, [](napi_env env, napi_value js_callback, void* context, void* data) {
+        FFWarmupData* d = reinterpret_cast<FFWarmupData *>(data);
+        napi_value undefined;
+        napi_get_undefined(env, &undefined);
+        napi_resolve_deferred(env, d->deferred, undefined);
+        napi_release_threadsafe_function(d->complete_callback_ref, napi_tsfn_release);
+        delete d;
+    }, &d->complete_callback_ref);
+    
+    // 以最低优先级提交到调度器, 排队中的命令先执行, 不占用 libuv 线程池;
+    JobScheduler::submit([d] {
+        // 模块加载时不做任何初始化, 这里提前完成首次使用时才会进行的工作;
+        FontCache::ensureConfig();
+        fftools_init();
+        ProbeCache::getStats();
+        napi_call_threadsafe_function(d->complete_callback_ref, d, napi_tsfn_nonblocking);
+    }, JobScheduler::BACKGROUND);
+    return promise;
+}
+
 //  export function setFontConfigDir(dir: string);
 napi_value FFmpeg::SetFontConfigDir(napi_env env, napi_callback_info info) {
     size_t argc = 1;
@@ -103,10 +289,36 @@ napi_value FFmpeg::SetFontConfigDir(napi_env env, napi_callback_info info) {
     std::string dir(dir_len, '\0'); 
     napi_get_value_string_utf8(env, args[dir_len], &dir[0], dir_len + 1, &dir_len);
 
-    SetEnv("FONTCONFIG_PATH", dir.c_str());
+    FontCache::setConfigDir(dir);
+    return nullptr;
+}
+
+//  export function prepareFonts(): void;
+napi_value FFmpeg::PrepareFonts(napi_env env, napi_callback_info info) {
+    FontCache::prepareAsync();
     return nullptr;
 }
 
+//  export function getFontCacheStats(): FontCacheStats;
+napi_value FFmpeg::GetFontCacheStats(napi_env env, napi_callback_info info) {
+    FontCache::Stats stats = FontCache::getStats();
+    
+    napi_value result, value;
+    napi_create_object(env, &result);
+    
+    napi_get_boolean(env, stats.ready, &value);
+    napi_set_named_property(env, result, "ready", value);
+    napi_create_uint32(env, stats.fonts, &value);
+    napi_set_named_property(env, result, "fonts", value);
+    napi_create_int64(env, stats.build_time_ms, &value);
+    napi_set_named_property(env, result, "buildTime", value);
+    napi_create_uint32(env, stats.builds, &value);
+    napi_set_named_property(env, result, "builds", value);
+    napi_create_uint32(env, stats.waits, &value);
+    napi_set_named_property(env, result, "waits", value);
+    return result;
+}
+
 //  export function execute(commands: string[], options?: Options): Promise<void>;
 napi_value FFmpeg::Execute(napi_env env, napi_callback_info info) {     
     napi_deferred deferred = nullptr;
@@ -159,11 +371,14 @@ napi_value FFmpeg::Execute(napi_env env, napi_callback_info info) {
     }
 
     // 获取配置项
-    napi_threadsafe_function log_callback_ref = nullptr;
-    napi_threadsafe_function progress_callback_ref = nullptr;
-    napi_threadsafe_function output_callback_ref = nullptr;
+    napi_ref log_callback_ref = nullptr;
+    napi_ref progress_callback_ref = nullptr;
+    napi_ref output_callback_ref = nullptr;
+    napi_ref progress_stats_callback_ref = nullptr;
+    napi_ref stats_callback_ref = nullptr;
     napi_ref abort_signal_ref = nullptr;
     FFAbortSignal* abort_signal = nullptr;
+    FFCallbackChannel::Options channel_options;
 
     napi_value opts = args[opts_index];
     napi_value opt_value;
@@ -172,27 +387,81 @@ napi_value FFmpeg::Execute(napi_env env, napi_callback_info info) {
     napi_get_named_property(env, opts, "logCallback", &opt_value);
     napi_typeof(env, opt_value, &opt_valuetype);
     if ( opt_valuetype == napi_function ) {
-        napi_value async_resource_name;
-        napi_create_string_utf8(env, "FFmpeg log callback", NAPI_AUTO_LENGTH, &async_resource_name);
-        napi_create_threadsafe_function(env, opt_value, nullptr, async_resource_name, 0, 1, nullptr, nullptr, nullptr, FFmpeg::InvokeLogCallback, &log_callback_ref);
+        napi_create_reference(env, opt_value, 1, &log_callback_ref);
+        channel_options.enabled_types |= 1 << FFCallbackChannel::LOG;
     }
 
     // progressCallback
     napi_get_named_property(env, opts, "progressCallback", &opt_value);
     napi_typeof(env, opt_value, &opt_valuetype);
     if ( opt_valuetype == napi_function ) {
-        napi_value async_resource_name;
-        napi_create_string_utf8(env, "FFmpeg progress callback", NAPI_AUTO_LENGTH, &async_resource_name);
-        napi_create_threadsafe_function(env, opt_value, nullptr, async_resource_name, 0, 1, nullptr, nullptr, nullptr, FFmpeg::InvokeProgressCallback, &progress_callback_ref);
+        napi_create_reference(env, opt_value, 1, &progress_callback_ref);
+        channel_options.enabled_types |= 1 << FFCallbackChannel::PROGRESS;
     }
 
     // outputCallback
     napi_get_named_property(env, opts, "outputCallback", &opt_value);
     napi_typeof(env, opt_value, &opt_valuetype);
     if ( opt_valuetype == napi_function ) {
-        napi_value async_resource_name;
-        napi_create_string_utf8(env, "FFmpeg output callback", NAPI_AUTO_LENGTH, &async_resource_name);
-        napi_create_threadsafe_function(env, opt_value, nullptr, async_resource_name, 0, 1, nullptr, nullptr, nullptr, FFmpeg::InvokeOutputCallback, &output_callback_ref);
+        napi_create_reference(env, opt_value, 1, &output_callback_ref);
+        channel_options.enabled_types |= 1 << FFCallbackChannel::OUTPUT;
+    }
+    
+    // progressStatsCallback
+    napi_get_named_property(env, opts, "progressStatsCallback", &opt_value);
+    napi_typeof(env, opt_value, &opt_valuetype);
+    if ( opt_valuetype == napi_function ) {
+        napi_create_reference(env, opt_value, 1, &progress_stats_callback_ref);
+        channel_options.enabled_types |= 1 << FFCallbackChannel::PROGRESS_STATS;
+    }
+    
+    // progressInterval
+    napi_get_named_property(env, opts, "progressInterval", &opt_value);
+    napi_typeof(env, opt_value, &opt_valuetype);
+    if ( opt_valuetype == napi_number ) {
+        int32_t progress_interval;
+        napi_get_value_int32(env, opt_value, &progress_interval);
+        if ( progress_interval > 0 ) channel_options.progress_interval_ms = progress_interval;
+    }
+    
+    // statsCallback
+    napi_get_named_property(env, opts, "statsCallback", &opt_value);
+    napi_typeof(env, opt_value, &opt_valuetype);
+    if ( opt_valuetype == napi_function ) {
+        napi_create_reference(env, opt_value, 1, &stats_callback_ref);
+    }
+    
+    // delivery
+    napi_get_named_property(env, opts, "delivery", &opt_value);
+    napi_typeof(env, opt_value, &opt_valuetype);
+    if ( opt_valuetype == napi_object ) {
+        ParseDeliveryOptions(env, opt_value, &channel_options);
+    }
+    
+    // outputMode
+    FFOutputMode output_mode = FF_OUTPUT_CALLBACK;
+    napi_get_named_property(env, opts, "outputMode", &opt_value);
+    napi_typeof(env, opt_value, &opt_valuetype);
+    if ( opt_valuetype == napi_string ) {
+        char mode[16] = { 0 };
+        size_t mode_len = 0;
+        napi_get_value_string_utf8(env, opt_value, mode, sizeof(mode), &mode_len);
+        if ( strcmp(mode, "buffer") == 0 ) output_mode = FF_OUTPUT_BUFFER;
+        else if ( strcmp(mode, "chunked") == 0 ) output_mode = FF_OUTPUT_CHUNKED;
+    }
+    
+    // outputChunkSize
+    size_t output_chunk_size = FF_DEFAULT_OUTPUT_CHUNK_SIZE;
+    napi_get_named_property(env, opts, "outputChunkSize", &opt_value);
+    napi_typeof(env, opt_value, &opt_valuetype);
+    if ( opt_valuetype == napi_number ) {
+        int64_t chunk_size;
+        napi_get_value_int64(env, opt_value, &chunk_size);
+        if ( chunk_size > 0 ) output_chunk_size = std::max<size_t>(static_cast<size_t>(chunk_size), 1024);
+    }
+    if ( output_mode == FF_OUTPUT_CHUNKED ) {
+        // 单条消息最多占用缓冲区的 1/4, 确保分块能完整写入;
+        channel_options.buffer_size = std::max(channel_options.buffer_size, (output_chunk_size + 64) * 4);
     }
     
     // signal
@@ -203,6 +472,30 @@ napi_value FFmpeg::Execute(napi_env env, napi_callback_info info) {
         napi_create_reference(env, opt_value, 1, &abort_signal_ref);
     }
     
+    // controller
+    napi_get_named_property(env, opts, "controller", &opt_value);
+    std::shared_ptr<FFJobControl> job_control = GetJobControl(env, opt_value);
+    
+    // throttle
+    napi_get_named_property(env, opts, "throttle", &opt_value);
+    napi_typeof(env, opt_value, &opt_valuetype);
+    if ( opt_valuetype == napi_object ) {
+        if ( !job_control ) job_control = std::make_shared<FFJobControl>();
+        FFJobController::ApplyThrottle(env, opt_value, job_control.get());
+    }
+    
+    // priority
+    JobScheduler::Priority priority = JobScheduler::NORMAL;
+    napi_get_named_property(env, opts, "priority", &opt_value);
+    napi_typeof(env, opt_value, &opt_valuetype);
+    if ( opt_valuetype == napi_number ) {
+        int32_t priority_value;
+        napi_get_value_int32(env, opt_value, &priority_value);
+        if ( priority_value >= JobScheduler::INTERACTIVE && priority_value <= JobScheduler::BACKGROUND ) {
+            priority = static_cast<JobScheduler::Priority>(priority_value);
+        }
+    }
+    
     FFmpegExecutionData* d = new FFmpegExecutionData();
     d->cmds = cmds;
     d->cmds_count = cmds_count;
@@ -211,21 +504,1143 @@ napi_value FFmpeg::Execute(napi_env env, napi_callback_info info) {
     d->log_callback_ref = log_callback_ref;
     d->progress_callback_ref = progress_callback_ref;
     d->output_callback_ref = output_callback_ref;
+    d->progress_stats_callback_ref = progress_stats_callback_ref;
+    d->stats_callback_ref = stats_callback_ref;
     d->abort_signal_ref = abort_signal_ref;
     d->abort_signal = abort_signal;
+    d->job_control = job_control;
     d->deferred = deferred;
+    d->priority = priority;
     d->ff_ret = 0;
+    d->output_mode = output_mode;
+    d->output_chunk_size = output_chunk_size;
     
     napi_value async_resource_name;
     napi_create_string_utf8(env, "ffmpeg", NAPI_AUTO_LENGTH, &async_resource_name);
+    napi_create_threadsafe_function(env, nullptr, nullptr, async_resource_name, 0, 1, nullptr, nullptr, nullptr, FFmpeg::InvokeCompleteCallback, &d->complete_callback_ref);
+    
+    if ( channel_options.enabled_types != 0 ) {
+        napi_value flush_resource_name;
+        napi_create_string_utf8(env, "FFmpeg flush callback", NAPI_AUTO_LENGTH, &flush_resource_name);
+        napi_create_threadsafe_function(env, nullptr, nullptr, flush_resource_name, 0, 1, nullptr, nullptr, d, FFmpeg::InvokeFlushCallback, &d->flush_callback_ref);
+        d->callback_channel = new FFCallbackChannel(d->flush_callback_ref, channel_options);
+    }
     
-    // 创建异步任务
-    napi_create_async_work(env, nullptr, async_resource_name, FFmpeg::AsyncExecuteCallback, FFmpeg::AsyncCompleteCallback, d, &d->async_work);
-    napi_queue_async_work(env, d->async_work);
+    // 提交到调度器, 在独立的工作线程中执行, 不占用 libuv 线程池;
+    JobScheduler::submit([d] { FFmpeg::ExecuteJob(d); }, priority);
     return promise;
 }
 
-void FFmpeg::AsyncExecuteCallback(napi_env env, void *data) {
+//  export function setMaxConcurrentJobs(count: number);
+napi_value FFmpeg::SetMaxConcurrentJobs(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    int count_idx = 0;
+    
+    napi_value args[argc];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+    
+    napi_valuetype count_valuetype;
+    napi_typeof(env, args[count_idx], &count_valuetype);
+    if ( count_valuetype != napi_number ) {
+        napi_throw_error(env, nullptr, "Invalid argument: count must be a number");
+        return nullptr;
+    }
+    
+    int32_t count;
+    napi_get_value_int32(env, args[count_idx], &count);
+    if ( count < 1 ) {
+        napi_throw_error(env, nullptr, "Invalid argument: count must be greater than 0");
+        return nullptr;
+    }
+    
+    JobScheduler::setMaxConcurrentJobs(count);
+    return nullptr;
+}
+
+//  export function prewarmWorkers(count?: number);
+napi_value FFmpeg::PrewarmWorkers(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = { nullptr };
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+    
+    int32_t count = JobScheduler::getMaxConcurrentJobs();
+    napi_valuetype count_valuetype = napi_undefined;
+    if ( argc > 0 ) napi_typeof(env, args[0], &count_valuetype);
+    if ( count_valuetype == napi_number ) napi_get_value_int32(env, args[0], &count);
+    
+    JobScheduler::prewarm(count);
+    return nullptr;
+}
+
+//  export function getSchedulerStats(): SchedulerStats;
+napi_value FFmpeg::GetSchedulerStats(napi_env env, napi_callback_info info) {
+    JobScheduler::Stats stats = JobScheduler::getStats();
+    
+    napi_value result, value;
+    napi_create_object(env, &result);
+    
+    napi_create_int32(env, stats.max_concurrent_jobs, &value);
+    napi_set_named_property(env, result, "maxConcurrentJobs", value);
+    napi_create_int32(env, stats.workers, &value);
+    napi_set_named_property(env, result, "workers", value);
+    napi_create_int32(env, stats.running_jobs, &value);
+    napi_set_named_property(env, result, "runningJobs", value);
+    
+    napi_value queued_jobs;
+    napi_create_object(env, &queued_jobs);
+    napi_create_int32(env, stats.queued_jobs[JobScheduler::INTERACTIVE], &value);
+    napi_set_named_property(env, queued_jobs, "interactive", value);
+    napi_create_int32(env, stats.queued_jobs[JobScheduler::NORMAL], &value);
+    napi_set_named_property(env, queued_jobs, "normal", value);
+    napi_create_int32(env, stats.queued_jobs[JobScheduler::BACKGROUND], &value);
+    napi_set_named_property(env, queued_jobs, "background", value);
+    napi_set_named_property(env, result, "queuedJobs", queued_jobs);
+    
+    napi_create_int64(env, static_cast<int64_t>(stats.completed_jobs), &value);
+    napi_set_named_property(env, result, "completedJobs", value);
+    // 毫秒
+    napi_create_double(env, stats.last_wait_time_us / 1000.0, &value);
+    napi_set_named_property(env, result, "lastWaitTime", value);
+    napi_create_double(env, stats.avg_wait_time_us / 1000.0, &value);
+    napi_set_named_property(env, result, "avgWaitTime", value);
+    napi_create_double(env, stats.max_wait_time_us / 1000.0, &value);
+    napi_set_named_property(env, result, "maxWaitTime", value);
+    return result;
+}
+
+//  export function setThreadBudget(maxThreads: number);
+napi_value FFmpeg::SetThreadBudget(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = { nullptr };
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+    
+    napi_valuetype count_valuetype = napi_undefined;
+    if ( argc > 0 ) napi_typeof(env, args[0], &count_valuetype);
+    if ( count_valuetype != napi_number ) {
+        napi_throw_error(env, nullptr, "Invalid argument: maxThreads must be a number");
+        return nullptr;
+    }
+    
+    int32_t count;
+    napi_get_value_int32(env, args[0], &count);
+    if ( count < 0 ) {
+        napi_throw_error(env, nullptr, "Invalid argument: maxThreads must not be negative");
+        return nullptr;
+    }
+    
+    ThreadBudget::setMaxThreads(count);
+    return nullptr;
+}
+
+//  export function getThreadStats(): ThreadStats;
+napi_value FFmpeg::GetThreadStats(napi_env env, napi_callback_info info) {
+    static const char* const kind_names[] = { "ffmpeg", "ffprobe", "player" };
+    static const char* const thread_names[NATIVE_THREAD_TYPE_NB] = { "job", "demux", "mux", "encode", "decode", "codec", "filter", "reader", "event", "task" };
+    ThreadBudget::Stats stats = ThreadBudget::getStats();
+    
+    napi_value result, value;
+    napi_create_object(env, &result);
+    
+    napi_create_int32(env, stats.max_threads, &value);
+    napi_set_named_property(env, result, "maxThreads", value);
+    napi_create_int32(env, stats.live_threads, &value);
+    napi_set_named_property(env, result, "liveThreads", value);
+    napi_create_int32(env, stats.share, &value);
+    napi_set_named_property(env, result, "codecThreads", value);
+    
+    napi_value jobs;
+    napi_create_array_with_length(env, stats.jobs.size(), &jobs);
+    for ( size_t i = 0 ; i < stats.jobs.size() ; ++ i ) {
+        const ThreadBudget::JobStats& job_stats = stats.jobs[i];
+        napi_value job, threads;
+        napi_create_object(env, &job);
+        napi_create_int64(env, static_cast<int64_t>(job_stats.id), &value);
+        napi_set_named_property(env, job, "id", value);
+        napi_create_string_utf8(env, kind_names[job_stats.kind], NAPI_AUTO_LENGTH, &value);
+        napi_set_named_property(env, job, "kind", value);
+        napi_create_int32(env, job_stats.total, &value);
+        napi_set_named_property(env, job, "totalThreads", value);
+        
+        napi_create_object(env, &threads);
+        for ( int type = 0 ; type < NATIVE_THREAD_TYPE_NB ; ++ type ) {
+            napi_create_int32(env, job_stats.threads[type], &value);
+            napi_set_named_property(env, threads, thread_names[type], value);
+        }
+        napi_set_named_property(env, job, "threads", threads);
+        napi_set_element(env, jobs, static_cast<uint32_t>(i), job);
+    }
+    napi_set_named_property(env, result, "jobs", jobs);
+    return result;
+}
+
+struct FFSinkContext {
+    napi_threadsafe_function callback_ref = nullptr; // (chunk: ArrayBuffer | null) => void | Promise<void>
+    std::weak_ptr<FFOutputSink> sink;
+};
+
+struct FFSinkChunk {
+    FFSinkContext* ctx;
+    std::shared_ptr<FFOutputSink> sink;
+    uint8_t* data; // 为空时表示输出结束;
+    size_t len;
+};
+
+static uint32_t GetMemoryIOId(napi_env env, napi_value value) {
+    napi_valuetype valuetype;
+    napi_typeof(env, value, &valuetype);
+    if ( valuetype != napi_string ) {
+        return 0;
+    }
+    char url[64] = { 0 };
+    size_t len = 0;
+    napi_get_value_string_utf8(env, value, url, sizeof(url), &len);
+    return ff_mem_io_parse_id(url);
+}
+
+static void ThrowMemoryIOError(napi_env env, int ret) {
+    napi_throw_error(env, nullptr, ret == AVERROR(EBUSY) ? "Memory io is being used by a running command" : "Memory io not found");
+}
+
+//  export function createMemoryInput(buffer: ArrayBuffer): string;
+napi_value FFmpeg::CreateMemoryInput(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = { nullptr };
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+    
+    bool is_arraybuffer = false;
+    if ( argc > 0 ) napi_is_arraybuffer(env, args[0], &is_arraybuffer);
+    if ( !is_arraybuffer ) {
+        napi_throw_error(env, nullptr, "Invalid argument: buffer must be an ArrayBuffer");
+        return nullptr;
+    }
+    
+    // 已转移(transfer)的 ArrayBuffer 不再持有数据;
+    bool is_detached = false;
+    napi_is_detached_arraybuffer(env, args[0], &is_detached);
+    if ( is_detached ) {
+        napi_throw_error(env, nullptr, "Invalid argument: buffer is detached");
+        return nullptr;
+    }
+    
+    // 持有 ArrayBuffer 直到 releaseMemoryIO, 执行期间直接读取其中的数据; 引用只能阻止回收, 不能阻止转移, 见 createMemoryInput 的说明;
+    void* data = nullptr;
+    size_t size = 0;
+    napi_get_arraybuffer_info(env, args[0], &data, &size);
+    napi_ref buffer_ref = nullptr;
+    napi_create_reference(env, args[0], 1, &buffer_ref);
+    
+    uint32_t id = ff_mem_io_register_input(reinterpret_cast<const uint8_t*>(data), size, buffer_ref);
+    std::string url = NATIVE_MEM_IO_SCHEME + std::to_string(id);
+    napi_value result;
+    napi_create_string_utf8(env, url.c_str(), url.size(), &result);
+    return result;
+}
+
+//  export function createMemoryOutput(extension?: string, initialCapacity?: number): string;
+napi_value FFmpeg::CreateMemoryOutput(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value args[2] = { nullptr };
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+    
+    std::string extension;
+    napi_valuetype valuetype = napi_undefined;
+    if ( argc > 0 ) napi_typeof(env, args[0], &valuetype);
+    if ( valuetype == napi_string ) {
+        char buf[32] = { 0 };
+        size_t len = 0;
+        napi_get_value_string_utf8(env, args[0], buf, sizeof(buf), &len);
+        extension = buf[0] == '.' ? buf + 1 : buf;
+    }
+    
+    int64_t initial_capacity = 0;
+    valuetype = napi_undefined;
+    if ( argc > 1 ) napi_typeof(env, args[1], &valuetype);
+    if ( valuetype == napi_number ) napi_get_value_int64(env, args[1], &initial_capacity);
+    
+    uint32_t id = ff_mem_io_register_output(initial_capacity > 0 ? static_cast<size_t>(initial_capacity) : 0);
+    // 扩展名用于推断输出格式;
+    std::string url = NATIVE_MEM_IO_SCHEME + std::to_string(id);
+    if ( !extension.empty() ) url += "." + extension;
+    napi_value result;
+    napi_create_string_utf8(env, url.c_str(), url.size(), &result);
+    return result;
+}
+
+//  export function takeMemoryOutput(url: string): ArrayBuffer;
+napi_value FFmpeg::TakeMemoryOutput(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = { nullptr };
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+    
+    uint32_t id = argc > 0 ? GetMemoryIOId(env, args[0]) : 0;
+    uint8_t* data = nullptr;
+    size_t size = 0;
+    int ret = ff_mem_io_take_output(id, &data, &size);
+    if ( ret < 0 ) {
+        ThrowMemoryIOError(env, ret);
+        return nullptr;
+    }
+    
+    napi_value result;
+    if ( data == nullptr ) {
+        napi_create_arraybuffer(env, 0, nullptr, &result);
+        return result;
+    }
+    // 缓冲区直接交给 ArrayBuffer, 回收时释放;
+    napi_create_external_arraybuffer(env, data, size, [](napi_env env, void* data, void* hint) {
+        free(data);
+    }, nullptr, &result);
+    return result;
+}
+
+//  export function releaseMemoryIO(url: string);
+napi_value FFmpeg::ReleaseMemoryIO(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = { nullptr };
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+    
+    uint32_t id = argc > 0 ? GetMemoryIOId(env, args[0]) : 0;
+    std::shared_ptr<FFOutputSink> sink = ff_mem_io_get_sink(id);
+    if ( sink ) {
+        // 正在写入时终止写入, 结束标记在输出关闭时投递; 尚未打开时直接投递结束标记;
+        sink->cancel();
+        if ( ff_mem_io_unregister(id, nullptr) == 0 ) sink->finish(nullptr);
+        return nullptr;
+    }
+    
+    void* owner = nullptr;
+    int ret = ff_mem_io_unregister(id, &owner);
+    if ( ret < 0 ) {
+        ThrowMemoryIOError(env, ret);
+        return nullptr;
+    }
+    if ( owner ) napi_delete_reference(env, reinterpret_cast<napi_ref>(owner));
+    return nullptr;
+}
+
+//  export function createOutputSink(callback: (chunk: ArrayBuffer | null) => void | Promise<void>, options?: OutputSinkOptions): string;
+napi_value FFmpeg::CreateOutputSink(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value args[2] = { nullptr };
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+    
+    napi_valuetype valuetype = napi_undefined;
+    if ( argc > 0 ) napi_typeof(env, args[0], &valuetype);
+    if ( valuetype != napi_function ) {
+        napi_throw_error(env, nullptr, "Invalid argument: callback must be a function");
+        return nullptr;
+    }
+    
+    FFOutputSink::Options options;
+    std::string extension;
+    valuetype = napi_undefined;
+    if ( argc > 1 ) napi_typeof(env, args[1], &valuetype);
+    if ( valuetype == napi_object ) {
+        napi_value opt_value;
+        napi_valuetype opt_valuetype;
+        int64_t number;
+        
+        napi_get_named_property(env, args[1], "chunkSize", &opt_value);
+        napi_typeof(env, opt_value, &opt_valuetype);
+        if ( opt_valuetype == napi_number && napi_get_value_int64(env, opt_value, &number) == napi_ok && number > 0 ) {
+            options.chunk_size = number;
+        }
+        
+        napi_get_named_property(env, args[1], "highWaterMark", &opt_value);
+        napi_typeof(env, opt_value, &opt_valuetype);
+        if ( opt_valuetype == napi_number && napi_get_value_int64(env, opt_value, &number) == napi_ok && number > 0 ) {
+            options.high_water_mark = number;
+        }
+        
+        napi_get_named_property(env, args[1], "extension", &opt_value);
+        napi_typeof(env, opt_value, &opt_valuetype);
+        if ( opt_valuetype == napi_string ) {
+            char buf[32] = { 0 };
+            size_t len = 0;
+            napi_get_value_string_utf8(env, opt_value, buf, sizeof(buf), &len);
+            extension = buf[0] == '.' ? buf + 1 : buf;
+        }
+    }
+    
+    FFSinkContext* ctx = new FFSinkContext();
+    napi_value async_resource_name;
+    napi_create_string_utf8(env, "FFmpeg output sink", NAPI_AUTO_LENGTH, &async_resource_name);
+    napi_create_threadsafe_function(env, args[0], nullptr, async_resource_name, 0, 1, nullptr, nullptr, nullptr, FFmpeg::InvokeSinkCallback, &ctx->callback_ref);
+    
+    // 在封装线程中调用; 未消费的数据量由 FFOutputSink 控制, 这里不阻塞;
+    auto sink = std::make_shared<FFOutputSink>(options, [ctx](uint8_t* data, size_t len) {
+        FFSinkChunk* chunk = new FFSinkChunk { ctx, ctx->sink.lock(), data, len };
+        if ( napi_call_threadsafe_function(ctx->callback_ref, chunk, napi_tsfn_nonblocking) != napi_ok ) {
+            free(data);
+            delete chunk;
+            // 结束标记投递失败时不会再回调到 js 线程, 在这里释放;
+            if ( data == nullptr ) {
+                napi_release_threadsafe_function(ctx->callback_ref, napi_tsfn_release);
+                delete ctx;
+            }
+            return false;
+        }
+        return true;
+    });
+    ctx->sink = sink;
+    
+    uint32_t id = ff_mem_io_register_sink(sink);
+    std::string url = NATIVE_SINK_IO_SCHEME + std::to_string(id);
+    if ( !extension.empty() ) url += "." + extension;
+    napi_value result;
+    napi_create_string_utf8(env, url.c_str(), url.size(), &result);
+    return result;
+}
+
+// (chunk: ArrayBuffer | null) => void | Promise<void>
+void FFmpeg::InvokeSinkCallback(napi_env env, napi_value js_callback, void* context, void* data) {
+    FFSinkChunk* chunk = reinterpret_cast<FFSinkChunk *>(data);
+    FFSinkContext* ctx = chunk->ctx;
+    bool is_end = chunk->data == nullptr;
+    
+    if ( env == nullptr ) {
+        free(chunk->data);
+        if ( chunk->sink ) chunk->sink->consumed(chunk->len);
+    }
+    else {
+        napi_value arg;
+        if ( is_end ) {
+            napi_get_null(env, &arg);
+        }
+        else {
+            // 分块直接交给 ArrayBuffer, 回收时释放;
+            napi_create_external_arraybuffer(env, chunk->data, chunk->len, [](napi_env env, void* data, void* hint) {
+                free(data);
+            }, nullptr, &arg);
+        }
+        
+        napi_value global, ret = nullptr;
+        napi_get_global(env, &global);
+        napi_status status = napi_call_function(env, global, js_callback, 1, &arg, &ret);
+        
+        // 回调抛出异常时清除异常, 避免其作为未捕获异常上抛; 接收方已无法正常处理后续数据, 终止写入使命令失败;
+        bool is_exception_pending = false;
+        napi_is_exception_pending(env, &is_exception_pending);
+        if ( status != napi_ok || is_exception_pending ) {
+            napi_value exception;
+            if ( is_exception_pending ) napi_get_and_clear_last_exception(env, &exception);
+            ret = nullptr;
+            if ( !is_end && chunk->sink ) chunk->sink->cancel();
+        }
+        
+        // 返回 Promise 时, 等待其完成后才计为已消费;
+        bool is_promise = false;
+        if ( ret != nullptr ) napi_is_promise(env, ret, &is_promise);
+        if ( !is_end && is_promise ) {
+            napi_value then, on_settled;
+            napi_get_named_property(env, ret, "then", &then);
+            napi_create_function(env, "onSettled", NAPI_AUTO_LENGTH, FFmpeg::OnSinkChunkSettled, chunk, &on_settled);
+            napi_value argv[] = { on_settled, on_settled };
+            if ( napi_call_function(env, ret, then, 2, argv, nullptr) == napi_ok ) {
+                return;
+            }
+        }
+        if ( chunk->sink ) chunk->sink->consumed(chunk->len);
+    }
+    
+    if ( is_end ) {
+        napi_release_threadsafe_function(ctx->callback_ref, napi_tsfn_release);
+        delete ctx;
+    }
+    delete chunk;
+}
+
+napi_value FFmpeg::OnSinkChunkSettled(napi_env env, napi_callback_info info) {
+    void* data = nullptr;
+    size_t argc = 0;
+    napi_get_cb_info(env, info, &argc, nullptr, nullptr, &data);
+    FFSinkChunk* chunk = reinterpret_cast<FFSinkChunk *>(data);
+    if ( chunk->sink ) chunk->sink->consumed(chunk->len);
+    delete chunk;
+    return nullptr;
+}
+
+static std::string NapiValueToString(napi_env env, napi_value value) {
+    size_t str_size = 0;
+    napi_get_value_string_utf8(env, value, nullptr, 0, &str_size);
+    
+    std::string result(str_size, '\0');
+    napi_get_value_string_utf8(env, value, &result[0], str_size + 1, &str_size);
+    return result;
+}
+
+//  export function executePipeline(stages: string[][], options?: PipelineOptions): Promise<void>;
+napi_value FFmpeg::ExecutePipeline(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value args[2] = { nullptr };
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+    
+    bool is_array = false;
+    if ( argc > 0 ) napi_is_array(env, args[0], &is_array);
+    uint32_t stages_count = 0;
+    if ( is_array ) napi_get_array_length(env, args[0], &stages_count);
+    if ( stages_count == 0 ) {
+        napi_throw_error(env, nullptr, "Invalid argument: stages must be a non-empty array of commands");
+        return nullptr;
+    }
+    
+    napi_value opts = argc > 1 ? args[1] : nullptr;
+    napi_valuetype opts_valuetype = napi_undefined;
+    if ( opts ) napi_typeof(env, opts, &opts_valuetype);
+    
+    size_t pipe_buffer_size = FF_DEFAULT_PIPE_BUFFER_SIZE;
+    napi_value opt_value;
+    napi_valuetype opt_valuetype;
+    if ( opts_valuetype == napi_object ) {
+        napi_get_named_property(env, opts, "pipeBufferSize", &opt_value);
+        napi_typeof(env, opt_value, &opt_valuetype);
+        if ( opt_valuetype == napi_number ) {
+            int64_t size;
+            napi_get_value_int64(env, opt_value, &size);
+            if ( size > 0 ) pipe_buffer_size = static_cast<size_t>(size);
+        }
+    }
+    
+    FFPipelineExecutionData* d = new FFPipelineExecutionData();
+    d->stages.resize(stages_count);
+    
+    // 同名的 fifo://<name> 连接到同一个管道; 每个管道需由一个阶段写入, 另一个阶段读取, 否则执行时会一直等待;
+    struct PipeLink {
+        uint32_t id;
+        int writers = 0;
+        int readers = 0;
+        uint32_t writer_stage = 0;
+        uint32_t reader_stage = 0;
+    };
+    std::map<std::string, PipeLink> pipes;
+    int invalid_stage = -1;
+    for ( uint32_t i = 0 ; i < stages_count ; ++ i ) {
+        napi_value stage_value;
+        napi_get_element(env, args[0], i, &stage_value);
+        uint32_t cmds_count = 0;
+        napi_is_array(env, stage_value, &is_array);
+        if ( is_array ) napi_get_array_length(env, stage_value, &cmds_count);
+        
+        FFPipelineStage& stage = d->stages[i];
+        stage.cmds = new char*[cmds_count];
+        stage.cmds_count = cmds_count;
+        std::vector<std::pair<PipeLink*, bool>> stage_pipes; // 管道及其前一个参数是否为 -i;
+        for ( uint32_t j = 0 ; j < cmds_count ; ++ j ) {
+            napi_value element;
+            napi_get_element(env, stage_value, j, &element);
+            std::string cmd = NapiValueToString(env, element);
+            if ( cmd.compare(0, strlen(NATIVE_FIFO_IO_SCHEME), NATIVE_FIFO_IO_SCHEME) == 0 ) {
+                std::string name = cmd.substr(strlen(NATIVE_FIFO_IO_SCHEME));
+                size_t ext_pos = name.rfind('.');
+                std::string extension = ext_pos != std::string::npos ? name.substr(ext_pos) : "";
+                if ( ext_pos != std::string::npos ) name.erase(ext_pos);
+                auto it = pipes.find(name);
+                if ( it == pipes.end() ) {
+                    it = pipes.emplace(name, PipeLink { ff_mem_io_register_pipe(pipe_buffer_size) }).first;
+                    d->pipe_ids.push_back(it->second.id);
+                }
+                stage_pipes.emplace_back(&it->second, j > 0 && !strcmp(stage.cmds[j - 1], "-i"));
+                cmd = NATIVE_FIFO_IO_SCHEME + std::to_string(it->second.id) + extension;
+            }
+            stage.cmds[j] = new char[cmd.size() + 1];
+            memcpy(stage.cmds[j], cmd.c_str(), cmd.size() + 1);
+        }
+        
+        stage.is_ffmpeg = cmds_count > 0 && !strcmp(stage.cmds[0], "ffmpeg");
+        if ( invalid_stage < 0 && (cmds_count == 0 || (!stage.is_ffmpeg && strcmp(stage.cmds[0], "ffprobe"))) ) invalid_stage = i;
+        
+        // ffmpeg 中 -i 之后的地址为输入, 其余为输出; ffprobe 只读取;
+        for ( auto& pair : stage_pipes ) {
+            PipeLink* link = pair.first;
+            if ( stage.is_ffmpeg && !pair.second ) {
+                link->writers += 1;
+                link->writer_stage = i;
+                std::shared_ptr<FFBytePipe> pipe = ff_mem_io_get_pipe(link->id);
+                if ( pipe ) stage.output_pipes.push_back(pipe);
+            }
+            else {
+                link->readers += 1;
+                link->reader_stage = i;
+            }
+        }
+    }
+    
+    for ( auto& pair : pipes ) {
+        const PipeLink& link = pair.second;
+        if ( link.writers != 1 || link.readers != 1 || link.writer_stage == link.reader_stage ) {
+            d->invalid_reason = "Invalid argument: fifo://" + pair.first + " must be written by exactly one stage and read by exactly one other stage";
+            break;
+        }
+    }
+    
+    napi_value promise;
+    napi_create_promise(env, &d->deferred, &promise);
+    
+    if ( opts_valuetype == napi_object ) {
+        // signal
+        napi_get_named_property(env, opts, "signal", &opt_value);
+        napi_typeof(env, opt_value, &opt_valuetype);
+        if ( opt_valuetype == napi_object ) {
+            napi_unwrap(env, opt_value, reinterpret_cast<void**>(&d->abort_signal));
+            napi_create_reference(env, opt_value, 1, &d->abort_signal_ref);
+        }
+        
+        // controller
+        napi_get_named_property(env, opts, "controller", &opt_value);
+        d->job_control = GetJobControl(env, opt_value);
+        
+        // throttle
+        napi_get_named_property(env, opts, "throttle", &opt_value);
+        napi_typeof(env, opt_value, &opt_valuetype);
+        if ( opt_valuetype == napi_object ) {
+            if ( !d->job_control ) d->job_control = std::make_shared<FFJobControl>();
+            FFJobController::ApplyThrottle(env, opt_value, d->job_control.get());
+        }
+        
+        // priority
+        napi_get_named_property(env, opts, "priority", &opt_value);
+        napi_typeof(env, opt_value, &opt_valuetype);
+        if ( opt_valuetype == napi_number ) {
+            int32_t priority_value;
+            napi_get_value_int32(env, opt_value, &priority_value);
+            if ( priority_value >= JobScheduler::INTERACTIVE && priority_value <= JobScheduler::BACKGROUND ) {
+                d->priority = static_cast<JobScheduler::Priority>(priority_value);
+            }
+        }
+    }
+    
+    napi_value async_resource_name;
+    napi_create_string_utf8(env, "ffmpeg pipeline", NAPI_AUTO_LENGTH, &async_resource_name);
+    napi_create_threadsafe_function(env, nullptr, nullptr, async_resource_name, 0, 1, nullptr, nullptr, nullptr, FFmpeg::InvokePipelineCompleteCallback, &d->complete_callback_ref);
+    
+    if ( invalid_stage >= 0 || !d->invalid_reason.empty() ) {
+        // 复用完成回调释放资源;
+        atomic_store(&d->is_running, false);
+        if ( invalid_stage >= 0 && d->invalid_reason.empty() ) {
+            d->failed_stage.store(invalid_stage);
+            d->stages[invalid_stage].ff_ret = AVERROR(EINVAL);
+        }
+        napi_call_threadsafe_function(d->complete_callback_ref, d, napi_tsfn_nonblocking);
+        return promise;
+    }
+    
+    // 各阶段需要同时执行, 作为一个任务提交到调度器, 由该任务为其余阶段创建线程;
+    // 其余阶段不经过调度器排队(否则并发上限较小时相互等待), 但计入调度器正在运行的任务数;
+    JobScheduler::submit([d] { FFmpeg::ExecutePipelineJob(d); }, d->priority);
+    return promise;
+}
+
+void FFmpeg::ExecutePipelineJob(void *data) {
+    FFPipelineExecutionData* d = reinterpret_cast<FFPipelineExecutionData *>(data);
+    FFAbortSignal* signal = d->abort_signal;
+    if ( signal ) signal->setAbortedCallback([d](napi_ref reason_ref) {
+        d->cancel_requested.store(true);
+        atomic_store(&d->is_running, false);
+    });
+    
+    size_t count = d->stages.size();
+    std::vector<pthread_t> threads(count);
+    std::vector<bool> started(count, false);
+    std::vector<FFPipelineStageContext> contexts(count);
+    int external_jobs = static_cast<int>(count) - 1;
+    JobScheduler::addExternalJobs(external_jobs);
+    for ( size_t i = 1 ; i < count ; ++ i ) {
+        contexts[i] = { d, i };
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setstacksize(&attr, FF_PIPELINE_STAGE_STACK_SIZE);
+        started[i] = pthread_create(&threads[i], &attr, FFmpeg::PipelineStageEntry, &contexts[i]) == 0;
+        pthread_attr_destroy(&attr);
+        if ( !started[i] ) {
+            d->stages[i].ff_ret = AVERROR(EAGAIN);
+            int expected = -1;
+            d->failed_stage.compare_exchange_strong(expected, static_cast<int>(i));
+            atomic_store(&d->is_running, false);
+            break;
+        }
+    }
+    
+    RunPipelineStage(d, 0);
+    for ( size_t i = 1 ; i < count ; ++ i ) {
+        if ( started[i] ) pthread_join(threads[i], nullptr);
+    }
+    JobScheduler::addExternalJobs(-external_jobs);
+    
+    if ( signal ) signal->setAbortedCallback(nullptr);
+    napi_call_threadsafe_function(d->complete_callback_ref, d, napi_tsfn_nonblocking);
+}
+
+void* FFmpeg::PipelineStageEntry(void *data) {
+    FFPipelineStageContext* ctx = reinterpret_cast<FFPipelineStageContext *>(data);
+    pthread_setname_np(pthread_self(), "ff_pipeline");
+    RunPipelineStage(ctx->d, ctx->index);
+    return nullptr;
+}
+
+void FFmpeg::RunPipelineStage(FFPipelineExecutionData* d, size_t index) {
+    FFPipelineStage& stage = d->stages[index];
+    if ( !atomic_load(&d->is_running) ) {
+        return;
+    }
+    
+    FontCache::JobScope font_scope(stage.is_ffmpeg && FontCache::isRequired(stage.cmds_count, stage.cmds));
+    ff_set_job_control(d->job_control.get());
+    uint64_t budget_job = ThreadBudget::beginJob(stage.is_ffmpeg ? ThreadBudget::FFMPEG : ThreadBudget::FFPROBE);
+    {
+        ThreadBudget::ThreadScope budget_scope(budget_job, NATIVE_THREAD_JOB);
+        stage.ff_ret = stage.is_ffmpeg ? ffmpeg_main(&d->is_running, stage.cmds_count, stage.cmds) :
+                                         ffprobe_main(&d->is_running, stage.cmds_count, stage.cmds);
+    }
+    ThreadBudget::endJob(budget_job);
+    ff_set_job_control(nullptr);
+    if ( stage.ff_ret != 0 && atomic_load(&d->is_running) && !stage.output_pipes.empty() ) {
+        // 下游阶段已正常结束(如 -t 只读取了一部分)而提前关闭管道, 写入返回 EPIPE, 视为正常结束;
+        bool broken = true;
+        for ( auto& pipe : stage.output_pipes ) broken = broken && pipe->isBroken();
+        if ( broken ) stage.ff_ret = 0;
+    }
+    if ( stage.ff_ret != 0 ) {
+        // 停止其余阶段, 等待中的管道读写通过 interrupt callback 退出;
+        int expected = -1;
+        d->failed_stage.compare_exchange_strong(expected, static_cast<int>(index));
+        atomic_store(&d->is_running, false);
+    }
+}
+
+void FFmpeg::InvokePipelineCompleteCallback(napi_env env, napi_value js_callback, void* context, void* data) {
+    FFPipelineExecutionData* d = reinterpret_cast<FFPipelineExecutionData *>(data);
+    int failed_stage = d->failed_stage.load();
+    if ( d->cancel_requested.load() ) {
+        napi_value error, error_code, error_msg;
+        napi_create_string_utf8(env, "FF_CANCELLED_ERR", NAPI_AUTO_LENGTH, &error_code);
+        napi_create_string_utf8(env, "Execution cancelled by user", NAPI_AUTO_LENGTH, &error_msg);
+        napi_create_type_error(env, error_code, error_msg, &error);
+        napi_reject_deferred(env, d->deferred, error);
+    }
+    else if ( !d->invalid_reason.empty() ) {
+        napi_value error, error_code, error_msg;
+        napi_create_string_utf8(env, "FF_INVALID_CMD_ERR", NAPI_AUTO_LENGTH, &error_code);
+        napi_create_string_utf8(env, d->invalid_reason.c_str(), d->invalid_reason.size(), &error_msg);
+        napi_create_type_error(env, error_code, error_msg, &error);
+        napi_reject_deferred(env, d->deferred, error);
+    }
+    else if ( failed_stage >= 0 ) {
+        std::string msg = "Pipeline stage " + std::to_string(failed_stage) + " failed: " + av_err2str(d->stages[failed_stage].ff_ret);
+        napi_value error, error_code, error_msg, stage_value;
+        napi_create_string_utf8(env, "FF_GENERIC_ERR", NAPI_AUTO_LENGTH, &error_code);
+        napi_create_string_utf8(env, msg.c_str(), msg.size(), &error_msg);
+        napi_create_type_error(env, error_code, error_msg, &error);
+        napi_create_int32(env, failed_stage, &stage_value);
+        napi_set_named_property(env, error, "stage", stage_value);
+        napi_reject_deferred(env, d->deferred, error);
+    }
+    else {
+        napi_value undefined;
+        napi_get_undefined(env, &undefined);
+        napi_resolve_deferred(env, d->deferred, undefined);
+    }
+    
+    for ( auto id : d->pipe_ids ) ff_mem_io_unregister(id, nullptr);
+    for ( auto& stage : d->stages ) {
+        for ( uint32_t i = 0 ; i < stage.cmds_count ; ++ i ) {
+            delete[] stage.cmds[i];
+        }
+        delete[] stage.cmds;
+    }
+    if ( d->abort_signal_ref ) napi_delete_reference(env, d->abort_signal_ref);
+    napi_release_threadsafe_function(d->complete_callback_ref, napi_tsfn_release);
+    delete d;
+}
+
+static void SetStageCommands(FFPipelineStage& stage, const std::vector<std::string>& cmds) {
+    stage.cmds = new char*[cmds.size()];
+    stage.cmds_count = static_cast<uint32_t>(cmds.size());
+    for ( size_t i = 0 ; i < cmds.size() ; ++ i ) {
+        stage.cmds[i] = new char[cmds[i].size() + 1];
+        memcpy(stage.cmds[i], cmds[i].c_str(), cmds[i].size() + 1);
+    }
+}
+
+static std::string FormatTimeUs(int64_t time_us) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%lld.%06lld", static_cast<long long>(time_us / 1000000), static_cast<long long>(time_us % 1000000));
+    return buf;
+}
+
+//  export function executeParallel(input: string, output: string, args?: string[], options?: ParallelOptions): Promise<void>;
+napi_value FFmpeg::ExecuteParallel(napi_env env, napi_callback_info info) {
+    size_t argc = 4;
+    napi_value args[4] = { nullptr };
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+    
+    napi_valuetype input_valuetype = napi_undefined, output_valuetype = napi_undefined;
+    if ( argc > 0 ) napi_typeof(env, args[0], &input_valuetype);
+    if ( argc > 1 ) napi_typeof(env, args[1], &output_valuetype);
+    if ( input_valuetype != napi_string || output_valuetype != napi_string ) {
+        napi_throw_error(env, nullptr, "Invalid argument: input and output must be strings");
+        return nullptr;
+    }
+    
+    FFParallelExecutionData* d = new FFParallelExecutionData();
+    d->input = NapiValueToString(env, args[0]);
+    d->output = NapiValueToString(env, args[1]);
+    
+    // 解析编码相关的输出选项; -f 只作用于最终输出, 分段固定使用 nut 格式;
+    bool is_array = false;
+    uint32_t args_count = 0;
+    if ( argc > 2 ) napi_is_array(env, args[2], &is_array);
+    if ( is_array ) napi_get_array_length(env, args[2], &args_count);
+    ParallelTranscoder::Options& transcode_options = d->transcode_options;
+    for ( uint32_t i = 0 ; i < args_count ; ++ i ) {
+        napi_value element;
+        napi_get_element(env, args[2], i, &element);
+        std::string arg = NapiValueToString(env, element);
+        std::string value;
+        if ( i + 1 < args_count ) {
+            napi_get_element(env, args[2], i + 1, &element);
+            value = NapiValueToString(env, element);
+        }
+        
+        if ( arg == "-f" && i + 1 < args_count ) {
+            transcode_options.output_format = value;
+            i += 1;
+            continue;
+        }
+        if ( arg == "-c:a" || arg == "-codec:a" || arg == "-acodec" || arg == "-c" || arg == "-codec" ) transcode_options.encoder_name = value;
+        else if ( arg == "-ar" || arg == "-ar:a" ) transcode_options.sample_rate = atoi(value.c_str());
+        else if ( arg == "-ac" || arg == "-ac:a" ) transcode_options.nb_channels = atoi(value.c_str());
+        d->output_args.push_back(std::move(arg));
+    }
+    transcode_options.segments = JobScheduler::getMaxConcurrentJobs();
+    
+    napi_value promise;
+    napi_create_promise(env, &d->deferred, &promise);
+    
+    napi_value opts = argc > 3 ? args[3] : nullptr;
+    napi_valuetype opts_valuetype = napi_undefined;
+    if ( opts ) napi_typeof(env, opts, &opts_valuetype);
+    if ( opts_valuetype == napi_object ) {
+        napi_value opt_value;
+        napi_valuetype opt_valuetype;
+        
+        // segments
+        napi_get_named_property(env, opts, "segments", &opt_value);
+        napi_typeof(env, opt_value, &opt_valuetype);
+        if ( opt_valuetype == napi_number ) {
+            int32_t segments;
+            napi_get_value_int32(env, opt_value, &segments);
+            if ( segments > 0 ) transcode_options.segments = segments;
+        }
+        
+        // minSegmentDuration
+        napi_get_named_property(env, opts, "minSegmentDuration", &opt_value);
+        napi_typeof(env, opt_value, &opt_valuetype);
+        if ( opt_valuetype == napi_number ) {
+            double seconds;
+            napi_get_value_double(env, opt_value, &seconds);
+            if ( seconds >= 0 ) transcode_options.min_segment_duration_us = static_cast<int64_t>(seconds * 1000000);
+        }
+        
+        // checkpoint
+        napi_get_named_property(env, opts, "checkpoint", &opt_value);
+        napi_typeof(env, opt_value, &opt_valuetype);
+        if ( opt_valuetype == napi_object ) {
+            napi_value checkpoint_opts = opt_value;
+            napi_get_named_property(env, checkpoint_opts, "jobId", &opt_value);
+            napi_typeof(env, opt_value, &opt_valuetype);
+            std::string job_id = opt_valuetype == napi_string ? NapiValueToString(env, opt_value) : "";
+            if ( job_id.empty() || job_id.find('/') != std::string::npos || job_id == "." || job_id == ".." ) {
+                napi_value error, error_code, error_msg;
+                napi_create_string_utf8(env, "FF_INVALID_CMD_ERR", NAPI_AUTO_LENGTH, &error_code);
+                napi_create_string_utf8(env, "Invalid argument: checkpoint.jobId must be a non-empty name without '/'", NAPI_AUTO_LENGTH, &error_msg);
+                napi_create_type_error(env, error_code, error_msg, &error);
+                napi_reject_deferred(env, d->deferred, error);
+                delete d;
+                return promise;
+            }
+            d->checkpoint_job_id = job_id;
+            d->checkpoint_dir = FF_DEFAULT_CHECKPOINT_DIR;
+            transcode_options.segment_duration_us = FF_DEFAULT_CHECKPOINT_SEGMENT_DURATION_US;
+            
+            napi_get_named_property(env, checkpoint_opts, "dir", &opt_value);
+            napi_typeof(env, opt_value, &opt_valuetype);
+            if ( opt_valuetype == napi_string ) d->checkpoint_dir = NapiValueToString(env, opt_value);
+            
+            napi_get_named_property(env, checkpoint_opts, "segmentDuration", &opt_value);
+            napi_typeof(env, opt_value, &opt_valuetype);
+            if ( opt_valuetype == napi_number ) {
+                double seconds;
+                napi_get_value_double(env, opt_value, &seconds);
+                if ( seconds > 0 ) transcode_options.segment_duration_us = static_cast<int64_t>(seconds * 1000000);
+            }
+        }
+        
+        // signal
+        napi_get_named_property(env, opts, "signal", &opt_value);
+        napi_typeof(env, opt_value, &opt_valuetype);
+        if ( opt_valuetype == napi_object ) {
+            napi_unwrap(env, opt_value, reinterpret_cast<void**>(&d->abort_signal));
+            napi_create_reference(env, opt_value, 1, &d->abort_signal_ref);
+        }
+        
+        // controller
+        napi_get_named_property(env, opts, "controller", &opt_value);
+        d->job_control = GetJobControl(env, opt_value);
+        
+        // throttle
+        napi_get_named_property(env, opts, "throttle", &opt_value);
+        napi_typeof(env, opt_value, &opt_valuetype);
+        if ( opt_valuetype == napi_object ) {
+            if ( !d->job_control ) d->job_control = std::make_shared<FFJobControl>();
+            FFJobController::ApplyThrottle(env, opt_value, d->job_control.get());
+        }
+        
+        // priority
+        napi_get_named_property(env, opts, "priority", &opt_value);
+        napi_typeof(env, opt_value, &opt_valuetype);
+        if ( opt_valuetype == napi_number ) {
+            int32_t priority_value;
+            napi_get_value_int32(env, opt_value, &priority_value);
+            if ( priority_value >= JobScheduler::INTERACTIVE && priority_value <= JobScheduler::BACKGROUND ) {
+                d->priority = static_cast<JobScheduler::Priority>(priority_value);
+            }
+        }
+    }
+    
+    napi_value async_resource_name;
+    napi_create_string_utf8(env, "ffmpeg parallel", NAPI_AUTO_LENGTH, &async_resource_name);
+    napi_create_threadsafe_function(env, nullptr, nullptr, async_resource_name, 0, 1, nullptr, nullptr, nullptr, FFmpeg::InvokeParallelCompleteCallback, &d->complete_callback_ref);
+    
+    // 先在工作线程中读取输入并规划分段, 再将各分段作为独立任务提交;
+    JobScheduler::submit([d] { FFmpeg::ExecuteParallelJob(d); }, d->priority);
+    return promise;
+}
+
+void FFmpeg::ExecuteParallelJob(void *data) {
+    FFParallelExecutionData* d = reinterpret_cast<FFParallelExecutionData *>(data);
+    FFAbortSignal* signal = d->abort_signal;
+    if ( signal ) signal->setAbortedCallback([d](napi_ref reason_ref) {
+        d->cancel_requested.store(true);
+        atomic_store(&d->is_running, false);
+    });
+    
+    d->ret = ParallelTranscoder::plan(d->input, d->output, d->transcode_options, d->plan);
+    if ( d->ret < 0 || d->cancel_requested.load() ) {
+        FinishParallel(d);
+        return;
+    }
+    
+    size_t count = d->plan.segments.size();
+    if ( count > 1 && !d->checkpoint_job_id.empty() ) {
+        d->checkpoint = std::make_unique<TranscodeCheckpoint>(d->checkpoint_dir, d->checkpoint_job_id);
+        d->ret = d->checkpoint->open(ParallelFingerprint(d), count);
+        if ( d->ret < 0 ) {
+            FinishParallel(d);
+            return;
+        }
+        d->resumed_segments = d->checkpoint->committedCount();
+    }
+    
+    d->segments.resize(count);
+    std::vector<size_t> pending; // 需要执行的分段, 已完成的分段直接复用;
+    std::vector<std::string> cmds;
+    for ( size_t i = 0 ; i < count ; ++ i ) {
+        if ( d->checkpoint && d->checkpoint->isCommitted(i) ) {
+            continue;
+        }
+        pending.push_back(i);
+        
+        const ParallelTranscoder::Segment& segment = d->plan.segments[i];
+        cmds.assign({ "ffmpeg", "-y" });
+        if ( segment.read_start_us > 0 ) cmds.insert(cmds.end(), { "-ss", FormatTimeUs(segment.read_start_us) });
+        if ( segment.read_duration_us > 0 ) cmds.insert(cmds.end(), { "-t", FormatTimeUs(segment.read_duration_us) });
+        cmds.insert(cmds.end(), { "-i", d->input, "-vn", "-sn", "-dn" });
+        cmds.insert(cmds.end(), d->output_args.begin(), d->output_args.end());
+        if ( count == 1 ) {
+            // 无需拼接, 直接输出;
+            if ( !d->transcode_options.output_format.empty() ) cmds.insert(cmds.end(), { "-f", d->transcode_options.output_format });
+            cmds.push_back(d->output);
+        }
+        else if ( d->checkpoint ) {
+            cmds.insert(cmds.end(), { "-f", "nut", d->checkpoint->partialPath(i) });
+        }
+        else {
+            uint32_t id = ff_mem_io_register_output(FF_PARALLEL_SEGMENT_CAPACITY);
+            d->output_ids.push_back(id);
+            cmds.insert(cmds.end(), { "-f", "nut", NATIVE_MEM_IO_SCHEME + std::to_string(id) + ".nut" });
+        }
+        SetStageCommands(d->segments[i], cmds);
+    }
+    
+    if ( pending.empty() ) {
+        FinishParallel(d);
+        return;
+    }
+    
+    d->remaining_segments.store(static_cast<int>(pending.size()));
+    for ( size_t i = 1 ; i < pending.size() ; ++ i ) {
+        size_t index = pending[i];
+        JobScheduler::submit([d, index] { FFmpeg::RunParallelSegment(d, index); }, d->priority);
+    }
+    RunParallelSegment(d, pending[0]);
+}
+
+// 输入、输出、参数及分段方式相同时才能复用已完成的分段; 本地文件额外校验大小及修改时间;
+std::string FFmpeg::ParallelFingerprint(FFParallelExecutionData* d) {
+    std::string fingerprint = d->input + '\n' + d->output + '\n' + d->transcode_options.output_format + '\n';
+    for ( auto& arg : d->output_args ) fingerprint += arg + '\x1f';
+    
+    std::string path = MediaProbe::localPath(d->input);
+    struct stat info;
+    if ( !path.empty() && stat(path.c_str(), &info) == 0 ) {
+        fingerprint += '\n' + std::to_string(info.st_size) + ':' + std::to_string(info.st_mtim.tv_sec) + '.' + std::to_string(info.st_mtim.tv_nsec);
+    }
+    
+    const ParallelTranscoder::Plan& plan = d->plan;
+    fingerprint += '\n' + std::to_string(plan.sample_rate) + ':' + std::to_string(plan.frame_size) + ':' + std::to_string(plan.initial_padding);
+    for ( auto& segment : plan.segments ) {
+        fingerprint += '\n' + std::to_string(segment.read_start_sample) + ':' + std::to_string(segment.keep_end_sample);
+    }
+    return fingerprint;
+}
+
+void FFmpeg::RunParallelSegment(FFParallelExecutionData* d, size_t index) {
+    FFPipelineStage& segment = d->segments[index];
+    if ( atomic_load(&d->is_running) ) {
+        ff_set_job_control(d->job_control.get());
+        // 各分段分别读取各自的输入, 执行中的分段平分倍速限制, 合计的处理速度与单个命令一致;
+        if ( d->job_control ) d->job_control->beginSharedPacing();
+        uint64_t budget_job = ThreadBudget::beginJob(ThreadBudget::FFMPEG);
+        {
+            ThreadBudget::ThreadScope budget_scope(budget_job, NATIVE_THREAD_JOB);
+            segment.ff_ret = ffmpeg_main(&d->is_running, segment.cmds_count, segment.cmds);
+        }
+        ThreadBudget::endJob(budget_job);
+        if ( d->job_control ) d->job_control->endSharedPacing();
+        ff_set_job_control(nullptr);
+        if ( segment.ff_ret == 0 && d->checkpoint && atomic_load(&d->is_running) ) {
+            const ParallelTranscoder::Segment& info = d->plan.segments[index];
+            int64_t end_time_us = info.keep_end_sample == INT64_MAX ? INT64_MAX : av_rescale(info.keep_end_sample, AV_TIME_BASE, d->plan.sample_rate);
+            segment.ff_ret = d->checkpoint->commit(index, end_time_us);
+        }
+        if ( segment.ff_ret != 0 ) {
+            int expected = -1;
+            d->failed_segment.compare_exchange_strong(expected, static_cast<int>(index));
+            atomic_store(&d->is_running, false);
+        }
+    }
+    
+    // 最后结束的分段负责拼接;
+    if ( d->remaining_segments.fetch_sub(1) == 1 ) {
+        FinishParallel(d);
+    }
+}
+
+void FFmpeg::FinishParallel(FFParallelExecutionData* d) {
+    bool should_stitch = d->ret >= 0 && d->plan.segments.size() > 1 && d->failed_segment.load() < 0 && atomic_load(&d->is_running);
+    if ( should_stitch && d->checkpoint ) {
+        std::vector<std::string> segment_urls;
+        for ( size_t i = 0 ; i < d->plan.segments.size() ; ++ i ) {
+            segment_urls.push_back(d->checkpoint->segmentPath(i));
+        }
+        
+        uint64_t budget_job = ThreadBudget::beginJob(ThreadBudget::FFMPEG);
+        {
+            ThreadBudget::ThreadScope budget_scope(budget_job, NATIVE_THREAD_JOB);
+            d->ret = ParallelTranscoder::stitch(segment_urls, d->plan, d->output, d->transcode_options.output_format, &d->cancel_requested);
+        }
+        ThreadBudget::endJob(budget_job);
+        
+        // 拼接完成后不再需要检查点;
+        if ( d->ret >= 0 ) d->checkpoint->remove();
+    }
+    else if ( should_stitch ) {
+        // 分段输出转为内存输入后读取;
+        std::vector<std::string> segment_urls;
+        std::vector<uint32_t> input_ids;
+        for ( auto id : d->output_ids ) {
+            uint8_t* buf = nullptr;
+            size_t size = 0;
+            if ( ff_mem_io_take_output(id, &buf, &size) < 0 ) {
+                d->ret = AVERROR(ENOENT);
+                break;
+            }
+            uint32_t input_id = ff_mem_io_register_input(buf, size, buf);
+            input_ids.push_back(input_id);
+            segment_urls.push_back(NATIVE_MEM_IO_SCHEME + std::to_string(input_id) + ".nut");
+        }
+        
+        if ( d->ret >= 0 ) {
+            uint64_t budget_job = ThreadBudget::beginJob(ThreadBudget::FFMPEG);
+            {
+                ThreadBudget::ThreadScope budget_scope(budget_job, NATIVE_THREAD_JOB);
+                d->ret = ParallelTranscoder::stitch(segment_urls, d->plan, d->output, d->transcode_options.output_format, &d->cancel_requested);
+            }
+            ThreadBudget::endJob(budget_job);
+        }
+        
+        for ( auto id : input_ids ) {
+            void* owner = nullptr;
+            ff_mem_io_unregister(id, &owner);
+            free(owner);
+        }
+    }
+    
+    if ( d->abort_signal ) d->abort_signal->setAbortedCallback(nullptr);
+    napi_call_threadsafe_function(d->complete_callback_ref, d, napi_tsfn_nonblocking);
+}
+
+void FFmpeg::InvokeParallelCompleteCallback(napi_env env, napi_value js_callback, void* context, void* data) {
+    FFParallelExecutionData* d = reinterpret_cast<FFParallelExecutionData *>(data);
+    int failed_segment = d->failed_segment.load();
+    if ( d->cancel_requested.load() ) {
+        napi_value error, error_code, error_msg;
+        napi_create_string_utf8(env, "FF_CANCELLED_ERR", NAPI_AUTO_LENGTH, &error_code);
+        napi_create_string_utf8(env, "Execution cancelled by user", NAPI_AUTO_LENGTH, &error_msg);
+        napi_create_type_error(env, error_code, error_msg, &error);
+        napi_reject_deferred(env, d->deferred, error);
+    }
+    else if ( failed_segment >= 0 || d->ret < 0 ) {
+        std::string msg = failed_segment >= 0 ? "Segment " + std::to_string(failed_segment) + " failed: " + av_err2str(d->segments[failed_segment].ff_ret) :
+                                                std::string("Parallel execution failed: ") + av_err2str(d->ret);
+        napi_value error, error_code, error_msg;
+        napi_create_string_utf8(env, "FF_GENERIC_ERR", NAPI_AUTO_LENGTH, &error_code);
+        napi_create_string_utf8(env, msg.c_str(), msg.size(), &error_msg);
+        napi_create_type_error(env, error_code, error_msg, &error);
+        if ( failed_segment >= 0 ) {
+            napi_value segment_value;
+            napi_create_int32(env, failed_segment, &segment_value);
+            napi_set_named_property(env, error, "segment", segment_value);
+        }
+        napi_reject_deferred(env, d->deferred, error);
+    }
+    else {
+        // { segments, resumedSegments, checkpointed }
+        napi_value result, value;
+        napi_create_object(env, &result);
+        napi_create_uint32(env, static_cast<uint32_t>(d->plan.segments.size()), &value);
+        napi_set_named_property(env, result, "segments", value);
+        napi_create_uint32(env, static_cast<uint32_t>(d->resumed_segments), &value);
+        napi_set_named_property(env, result, "resumedSegments", value);
+        napi_get_boolean(env, d->checkpoint != nullptr, &value);
+        napi_set_named_property(env, result, "checkpointed", value);
+        napi_resolve_deferred(env, d->deferred, result);
+    }
+    
+    // 已取出的输出不存在, 注销时忽略;
+    for ( auto id : d->output_ids ) ff_mem_io_unregister(id, nullptr);
+    for ( auto& segment : d->segments ) {
+        for ( uint32_t i = 0 ; i < segment.cmds_count ; ++ i ) {
+            delete[] segment.cmds[i];
+        }
+        delete[] segment.cmds;
+    }
+    if ( d->abort_signal_ref ) napi_delete_reference(env, d->abort_signal_ref);
+    napi_release_threadsafe_function(d->complete_callback_ref, napi_tsfn_release);
+    delete d;
+}
+
+void FFmpeg::ExecuteJob(void *data) {
     FFmpegExecutionData* d = reinterpret_cast<FFmpegExecutionData *>(data);
     if ( atomic_load(&d->is_running) ) {
         FFAbortSignal* signal = d->abort_signal;
@@ -234,21 +1649,52 @@ void FFmpeg::AsyncExecuteCallback(napi_env env, void *data) {
         });
         
         // init
-        ff_set_callback_refs(d->log_callback_ref, d->progress_callback_ref, d->output_callback_ref);
+        ff_set_callback_channel(d->callback_channel);
+        ff_set_job_control(d->job_control.get());
+        if ( d->output_mode != FF_OUTPUT_CALLBACK ) ff_set_output_buffer(&d->output_buffer, d->output_mode == FF_OUTPUT_CHUNKED ? d->output_chunk_size : 0);
         
-        // execute cmds
-        d->ff_ret = d->is_ffmpeg ? ffmpeg_main(&d->is_running, d->cmds_count, d->cmds) : 
-                                   ffprobe_main(&d->is_running, d->cmds_count, d->cmds);
+        // 字幕/文字滤镜共享进程内的字体索引, 首个使用的命令负责构建, 同时执行的命令等待其完成, 不再各自扫描字体;
+        FontCache::JobScope font_scope(d->is_ffmpeg && FontCache::isRequired(d->cmds_count, d->cmds));
+        if ( d->is_ffmpeg ) {
+            d->report.begin();
+            ff_set_job_report(&d->report);
+        }
         
-        ff_wait_callbacks();
-        ff_set_callback_refs(nullptr, nullptr, nullptr);
+        // execute cmds; 执行期间当前线程关联到线程预算中的任务, 命令内创建的线程及编解码器线程数均计入该任务;
+        uint64_t budget_job = ThreadBudget::beginJob(d->is_ffmpeg ? ThreadBudget::FFMPEG : ThreadBudget::FFPROBE);
+        {
+            ThreadBudget::ThreadScope budget_scope(budget_job, NATIVE_THREAD_JOB);
+            d->ff_ret = d->is_ffmpeg ? ffmpeg_main(&d->is_running, d->cmds_count, d->cmds) : 
+                                       ffprobe_main(&d->is_running, d->cmds_count, d->cmds);
+        }
+        ThreadBudget::endJob(budget_job);
+        
+        if ( d->is_ffmpeg ) {
+            ff_set_job_report(nullptr);
+            d->report.end();
+        }
+        
+        ff_flush_output();
+        d->callback_drain_latency_us = ff_wait_callbacks();
+        ff_set_callback_channel(nullptr);
+        ff_set_job_control(nullptr);
+        ff_set_output_buffer(nullptr, 0);
         
         if ( signal ) signal->setAbortedCallback(nullptr);
     }
+    
+    napi_call_threadsafe_function(d->complete_callback_ref, d, napi_tsfn_nonblocking);
 }
 
-void FFmpeg::AsyncCompleteCallback(napi_env env, napi_status status, void *data) {
+void FFmpeg::InvokeCompleteCallback(napi_env env, napi_value js_callback, void* context, void* data) {
     FFmpegExecutionData* d = reinterpret_cast<FFmpegExecutionData *>(data);
+    if ( d->stats_callback_ref ) {
+        napi_value global, callback, stats;
+        napi_get_global(env, &global);
+        napi_get_reference_value(env, d->stats_callback_ref, &callback);
+        CreateExecutionStats(env, d, &stats);
+        napi_call_function(env, global, callback, 1, &stats, nullptr);
+    }
     if ( !atomic_load(&d->is_running) || d->ff_ret == 255 ) {
         napi_value error, error_code, error_msg;
         napi_create_string_utf8(env, "FF_CANCELLED_ERR", NAPI_AUTO_LENGTH, &error_code);
@@ -263,6 +1709,16 @@ void FFmpeg::AsyncCompleteCallback(napi_env env, napi_status status, void *data)
         napi_create_type_error(env, error_code, error_msg, &error);
         napi_reject_deferred(env, d->deferred, error);
     }
+    else if ( d->output_mode == FF_OUTPUT_BUFFER ) {
+        napi_value output;
+        napi_create_string_utf8(env, d->output_buffer.data(), d->output_buffer.size(), &output);
+        napi_resolve_deferred(env, d->deferred, output);
+    }
+    else if ( d->is_ffmpeg ) {
+        napi_value report;
+        CreateJobReport(env, d->report, &report);
+        napi_resolve_deferred(env, d->deferred, report);
+    }
     else {
         napi_value undefined;
         napi_get_undefined(env, &undefined);
@@ -272,86 +1728,299 @@ void FFmpeg::AsyncCompleteCallback(napi_env env, napi_status status, void *data)
         delete[] d->cmds[i];
     }
     delete[] d->cmds;
-    if ( d->log_callback_ref ) napi_release_threadsafe_function(d->log_callback_ref, napi_tsfn_release);
-    if ( d->progress_callback_ref ) napi_release_threadsafe_function(d->progress_callback_ref, napi_tsfn_release);
-    if ( d->output_callback_ref ) napi_release_threadsafe_function(d->output_callback_ref, napi_tsfn_release);
+    if ( d->callback_channel ) delete d->callback_channel;
+    if ( d->flush_callback_ref ) napi_release_threadsafe_function(d->flush_callback_ref, napi_tsfn_release);
+    if ( d->log_callback_ref ) napi_delete_reference(env, d->log_callback_ref);
+    if ( d->progress_callback_ref ) napi_delete_reference(env, d->progress_callback_ref);
+    if ( d->output_callback_ref ) napi_delete_reference(env, d->output_callback_ref);
+    if ( d->progress_stats_callback_ref ) napi_delete_reference(env, d->progress_stats_callback_ref);
+    if ( d->stats_callback_ref ) napi_delete_reference(env, d->stats_callback_ref);
     if ( d->abort_signal_ref ) napi_delete_reference(env, d->abort_signal_ref);
-    napi_delete_async_work(env, d->async_work);
+    napi_release_threadsafe_function(d->complete_callback_ref, napi_tsfn_release);
     delete d;
 }
 
-// (level: number, msg: string) => void
-void FFmpeg::InvokeLogCallback(napi_env env, napi_value js_callback, void* context, void* data) {
-    FFCallbackData* ff_data = reinterpret_cast<FFCallbackData*>(data);
-    napi_value global, level, msg;
-    napi_get_global(env, &global);
-    napi_create_int32(env, ff_data->level, &level);
-    napi_create_string_utf8(env, ff_data->msg.c_str(), ff_data->msg.length(), &msg);
-    napi_value args[] = { level, msg };
-    napi_call_function(env, global, js_callback, 2, args, nullptr);
-    atomic_fetch_sub(ff_data->pendingCallbacks, 1);
-    delete ff_data;
-}
-
-// (msg: string) => void
-void FFmpeg::InvokeProgressCallback(napi_env env, napi_value js_callback, void* context, void* data) {
-    FFCallbackData* ff_data = reinterpret_cast<FFCallbackData*>(data);
-    napi_value global, msg;
-    napi_get_global(env, &global);
-    napi_create_string_utf8(env, ff_data->msg.c_str(), ff_data->msg.length(), &msg);
-    napi_call_function(env, global, js_callback, 1, &msg, nullptr);
-    atomic_fetch_sub(ff_data->pendingCallbacks, 1);
-    delete ff_data;
-}
-
-// (msg: string) => void
-void FFmpeg::InvokeOutputCallback(napi_env env, napi_value js_callback, void* context, void* data) {
-    FFCallbackData* ff_data = reinterpret_cast<FFCallbackData*>(data);
-    napi_value global, msg;
+// 在 js 线程中依次回调缓冲区中的消息;
+void FFmpeg::InvokeFlushCallback(napi_env env, napi_value js_callback, void* context, void* data) {
+    FFmpegExecutionData* d = reinterpret_cast<FFmpegExecutionData *>(context);
+    FFCallbackChannel* channel = reinterpret_cast<FFCallbackChannel*>(data);
+    if ( env == nullptr ) {
+        channel->drain([](FFCallbackChannel::RecordType type, int level, const char* msg, size_t len) { });
+        return;
+    }
+    
+    napi_value global, log_callback = nullptr, progress_callback = nullptr, output_callback = nullptr, progress_stats_callback = nullptr;
     napi_get_global(env, &global);
-    napi_create_string_utf8(env, ff_data->msg.c_str(), ff_data->msg.length(), &msg);
-    napi_call_function(env, global, js_callback, 1, &msg, nullptr);
-    atomic_fetch_sub(ff_data->pendingCallbacks, 1);
-    delete ff_data;
+    if ( d->log_callback_ref ) napi_get_reference_value(env, d->log_callback_ref, &log_callback);
+    if ( d->progress_callback_ref ) napi_get_reference_value(env, d->progress_callback_ref, &progress_callback);
+    if ( d->output_callback_ref ) napi_get_reference_value(env, d->output_callback_ref, &output_callback);
+    if ( d->progress_stats_callback_ref ) napi_get_reference_value(env, d->progress_stats_callback_ref, &progress_stats_callback);
+    
+    channel->drain([&](FFCallbackChannel::RecordType type, int level, const char* msg, size_t len) {
+        napi_handle_scope scope;
+        napi_open_handle_scope(env, &scope);
+        napi_value msg_value;
+        if ( type != FFCallbackChannel::PROGRESS_STATS ) napi_create_string_utf8(env, msg, len, &msg_value);
+        switch (type) {
+            // (level: number, msg: string) => void
+            case FFCallbackChannel::LOG: {
+                napi_value level_value;
+                napi_create_int32(env, level, &level_value);
+                napi_value args[] = { level_value, msg_value };
+                if ( log_callback ) napi_call_function(env, global, log_callback, 2, args, nullptr);
+            }
+                break;
+            // (msg: string) => void
+            case FFCallbackChannel::PROGRESS:
+                if ( progress_callback ) napi_call_function(env, global, progress_callback, 1, &msg_value, nullptr);
+                break;
+            // (msg: string) => void
+            case FFCallbackChannel::OUTPUT:
+                if ( output_callback ) napi_call_function(env, global, output_callback, 1, &msg_value, nullptr);
+                break;
+            // (progress: ProgressStats) => void
+            case FFCallbackChannel::PROGRESS_STATS: {
+                NativeProgress progress;
+                memcpy(&progress, msg, std::min(len, sizeof(progress)));
+                napi_value progress_value;
+                CreateProgressStats(env, &progress, &progress_value);
+                if ( progress_stats_callback ) napi_call_function(env, global, progress_stats_callback, 1, &progress_value, nullptr);
+            }
+                break;
+        }
+        napi_close_handle_scope(env, scope);
+    });
 }
 
-void FFmpeg::SetFontConfigDefaultDir() {
-    const char* root_dir = "/data/storage/el2/base/files/sj_ff_av";
-    struct stat info;
-    if ( stat(root_dir, &info) != 0 ) {
-        if ( mkdir(root_dir, 0755) != 0 ) {
-            return;
-        }
+napi_status FFmpeg::ParseDeliveryOptions(napi_env env, napi_value delivery_value, FFCallbackChannel::Options* options) {
+    napi_value prop_value;
+    napi_valuetype prop_valuetype;
+    
+    napi_get_named_property(env, delivery_value, "bufferSize", &prop_value);
+    napi_typeof(env, prop_value, &prop_valuetype);
+    if ( prop_valuetype == napi_number ) {
+        int64_t buffer_size;
+        napi_get_value_int64(env, prop_value, &buffer_size);
+        if ( buffer_size > 0 ) options->buffer_size = static_cast<size_t>(buffer_size);
     }
-
-    std::string font_cfg_default_file_path = std::string(root_dir) + "/fonts.conf";
-    if ( stat(font_cfg_default_file_path.c_str(), &info) == 0 ) {
-        return;  
+    
+    napi_get_named_property(env, delivery_value, "flushThreshold", &prop_value);
+    napi_typeof(env, prop_value, &prop_valuetype);
+    if ( prop_valuetype == napi_number ) {
+        int64_t flush_threshold;
+        napi_get_value_int64(env, prop_value, &flush_threshold);
+        if ( flush_threshold >= 0 ) options->flush_threshold = static_cast<size_t>(flush_threshold);
     }
-
-    FILE* file = fopen(font_cfg_default_file_path.c_str(), "w");
-    if ( !file ) {
-        return;
+    
+    napi_get_named_property(env, delivery_value, "flushInterval", &prop_value);
+    napi_typeof(env, prop_value, &prop_valuetype);
+    if ( prop_valuetype == napi_number ) {
+        int32_t flush_interval;
+        napi_get_value_int32(env, prop_value, &flush_interval);
+        if ( flush_interval >= 0 ) options->flush_interval_ms = flush_interval;
     }
-
-    if ( fprintf(file,
-            "<?xml version=\"1.0\"?>"
-            "<!DOCTYPE fontconfig SYSTEM \"fonts.dtd\">"
-            "<fontconfig>"
-                "<dir>/system/fonts</dir>"
-            "</fontconfig>" 
-    ) < 0 ) {
-        fclose(file);
-        return;
+    
+    napi_get_named_property(env, delivery_value, "logOverflowPolicy", &prop_value);
+    napi_typeof(env, prop_value, &prop_valuetype);
+    if ( prop_valuetype == napi_string ) {
+        char policy[16] = { 0 };
+        size_t policy_len = 0;
+        napi_get_value_string_utf8(env, prop_value, policy, sizeof(policy), &policy_len);
+        options->log_overflow_policy = strcmp(policy, "drop") == 0 ? FFCallbackChannel::DROP : FFCallbackChannel::BLOCK;
     }
+    return napi_ok;
+}
 
-    fclose(file);
+napi_status FFmpeg::CreateProgressStats(napi_env env, const NativeProgress* progress, napi_value* result) {
+    napi_value value;
+    napi_create_object(env, result);
+    napi_create_int64(env, progress->frame, &value);
+    napi_set_named_property(env, *result, "frame", value);
+    napi_create_double(env, progress->fps, &value);
+    napi_set_named_property(env, *result, "fps", value);
+    napi_create_int64(env, progress->out_time_us, &value);
+    napi_set_named_property(env, *result, "outTimeUs", value);
+    napi_create_int64(env, progress->total_size, &value);
+    napi_set_named_property(env, *result, "totalSize", value);
+    napi_create_double(env, progress->bitrate, &value);
+    napi_set_named_property(env, *result, "bitrate", value);
+    napi_create_double(env, progress->speed, &value);
+    napi_set_named_property(env, *result, "speed", value);
+    napi_create_int64(env, progress->dup_frames, &value);
+    napi_set_named_property(env, *result, "dupFrames", value);
+    napi_create_int64(env, progress->drop_frames, &value);
+    napi_set_named_property(env, *result, "dropFrames", value);
+    napi_get_boolean(env, progress->is_last != 0, &value);
+    napi_set_named_property(env, *result, "isLast", value);
+    napi_get_boolean(env, progress->throttled != 0, &value);
+    napi_set_named_property(env, *result, "throttled", value);
+    // 毫秒
+    napi_create_double(env, progress->throttled_time_us / 1000.0, &value);
+    napi_set_named_property(env, *result, "throttledTime", value);
+    
+    int nb_outputs = std::min(progress->nb_outputs, NATIVE_PROGRESS_MAX_OUTPUTS);
+    napi_value outputs;
+    napi_create_array_with_length(env, nb_outputs, &outputs);
+    for ( int i = 0 ; i < nb_outputs ; ++ i ) {
+        const NativeOutputProgress& op = progress->outputs[i];
+        napi_value output;
+        napi_create_object(env, &output);
+        napi_create_int32(env, op.file_index, &value);
+        napi_set_named_property(env, output, "fileIndex", value);
+        napi_create_int32(env, op.stream_index, &value);
+        napi_set_named_property(env, output, "streamIndex", value);
+        napi_create_int32(env, op.media_type, &value);
+        napi_set_named_property(env, output, "mediaType", value);
+        napi_create_double(env, op.q, &value);
+        napi_set_named_property(env, output, "q", value);
+        napi_create_int64(env, op.packets_written, &value);
+        napi_set_named_property(env, output, "packetsWritten", value);
+        napi_create_int64(env, op.frames_encoded, &value);
+        napi_set_named_property(env, output, "framesEncoded", value);
+        napi_create_int64(env, op.data_size, &value);
+        napi_set_named_property(env, output, "dataSize", value);
+        napi_create_int64(env, op.out_time_us, &value);
+        napi_set_named_property(env, output, "outTimeUs", value);
+        napi_set_element(env, outputs, i, output);
+    }
+    napi_set_named_property(env, *result, "outputs", outputs);
+    return napi_ok;
+}
 
-    SetEnv("FONTCONFIG_PATH", root_dir);
+// 执行结束后的统计信息;
+napi_status FFmpeg::CreateExecutionStats(napi_env env, FFmpegExecutionData* d, napi_value* result) {
+    napi_value value;
+    napi_create_object(env, result);
+    
+    FFCallbackChannel::Stats channel_stats = { 0 };
+    if ( d->callback_channel ) channel_stats = d->callback_channel->getStats();
+    
+    napi_value delivery;
+    napi_create_object(env, &delivery);
+    napi_create_int64(env, static_cast<int64_t>(channel_stats.records), &value);
+    napi_set_named_property(env, delivery, "records", value);
+    napi_create_int64(env, static_cast<int64_t>(channel_stats.batches), &value);
+    napi_set_named_property(env, delivery, "batches", value);
+    napi_create_uint32(env, channel_stats.max_batch_records, &value);
+    napi_set_named_property(env, delivery, "maxBatchRecords", value);
+    napi_create_int64(env, static_cast<int64_t>(channel_stats.dropped_logs), &value);
+    napi_set_named_property(env, delivery, "droppedLogs", value);
+    napi_create_int64(env, static_cast<int64_t>(channel_stats.blocked_writes), &value);
+    napi_set_named_property(env, delivery, "blockedWrites", value);
+    // 毫秒
+    napi_create_double(env, d->callback_drain_latency_us / 1000.0, &value);
+    napi_set_named_property(env, delivery, "drainLatency", value);
+    napi_set_named_property(env, *result, "delivery", delivery);
+    
+    // 毫秒
+    napi_create_double(env, d->job_control ? d->job_control->pausedTimeUs() / 1000.0 : 0, &value);
+    napi_set_named_property(env, *result, "pausedTime", value);
+    
+    if ( d->is_ffmpeg ) {
+        CreateJobReport(env, d->report, &value);
+        napi_set_named_property(env, *result, "report", value);
+    }
+    return napi_ok;
 }
 
-void FFmpeg::SetEnv(const char *name, const char *value) {
-    setenv(name, value, true);
+napi_status FFmpeg::CreateJobReport(napi_env env, const FFJobReport& report, napi_value* result) {
+    static const char* const stage_names[NATIVE_JOB_STAGE_NB] = { "demux", "decode", "filter", "encode", "mux" };
+    
+    napi_value value;
+    napi_create_object(env, result);
+    
+    // 毫秒
+    napi_create_double(env, report.wallTimeUs() / 1000.0, &value);
+    napi_set_named_property(env, *result, "wallTime", value);
+    napi_create_double(env, report.userTimeUs() / 1000.0, &value);
+    napi_set_named_property(env, *result, "userTime", value);
+    napi_create_double(env, report.sysTimeUs() / 1000.0, &value);
+    napi_set_named_property(env, *result, "sysTime", value);
+    napi_create_double(env, report.threadUserTimeUs() / 1000.0, &value);
+    napi_set_named_property(env, *result, "jobUserTime", value);
+    napi_create_double(env, report.threadSysTimeUs() / 1000.0, &value);
+    napi_set_named_property(env, *result, "jobSysTime", value);
+    napi_create_int64(env, report.maxRss(), &value);
+    napi_set_named_property(env, *result, "maxRss", value);
+    napi_create_int64(env, report.bytesRead(), &value);
+    napi_set_named_property(env, *result, "bytesRead", value);
+    napi_create_int64(env, report.bytesWritten(), &value);
+    napi_set_named_property(env, *result, "bytesWritten", value);
+    
+    const NativeJobSummary& summary = report.summary();
+    napi_create_int64(env, summary.frames_decoded, &value);
+    napi_set_named_property(env, *result, "framesDecoded", value);
+    napi_create_int64(env, summary.decode_errors, &value);
+    napi_set_named_property(env, *result, "decodeErrors", value);
+    napi_create_int64(env, summary.dup_frames, &value);
+    napi_set_named_property(env, *result, "dupFrames", value);
+    napi_create_int64(env, summary.drop_frames, &value);
+    napi_set_named_property(env, *result, "dropFrames", value);
+    
+    napi_value pools;
+    napi_create_object(env, &pools);
+    const NativePoolReport* pool_reports[2] = { &summary.packet_pool, &summary.frame_pool };
+    const char* const pool_names[2] = { "packets", "frames" };
+    for ( int i = 0 ; i < 2 ; ++ i ) {
+        napi_value pool;
+        napi_create_object(env, &pool);
+        napi_create_int64(env, pool_reports[i]->hits, &value);
+        napi_set_named_property(env, pool, "hits", value);
+        napi_create_int64(env, pool_reports[i]->misses, &value);
+        napi_set_named_property(env, pool, "misses", value);
+        napi_create_int64(env, pool_reports[i]->discarded, &value);
+        napi_set_named_property(env, pool, "discarded", value);
+        napi_create_int64(env, pool_reports[i]->high_water, &value);
+        napi_set_named_property(env, pool, "highWater", value);
+        napi_set_named_property(env, pools, pool_names[i], pool);
+    }
+    napi_set_named_property(env, *result, "pools", pools);
+    
+    // 毫秒
+    napi_value stage_times;
+    napi_create_object(env, &stage_times);
+    for ( int stage = 0 ; stage < NATIVE_JOB_STAGE_NB ; ++ stage ) {
+        napi_create_double(env, report.stageTimeUs(stage) / 1000.0, &value);
+        napi_set_named_property(env, stage_times, stage_names[stage], value);
+    }
+    napi_set_named_property(env, *result, "stageTimes", stage_times);
+    
+    napi_value inputs, outputs;
+    uint32_t nb_inputs = 0, nb_outputs = 0;
+    napi_create_array(env, &inputs);
+    napi_create_array(env, &outputs);
+    for ( int i = 0 ; i < summary.nb_streams ; ++ i ) {
+        const NativeStreamReport& stream = summary.streams[i];
+        napi_value item;
+        napi_create_object(env, &item);
+        napi_create_int32(env, stream.file_index, &value);
+        napi_set_named_property(env, item, "fileIndex", value);
+        napi_create_int32(env, stream.stream_index, &value);
+        napi_set_named_property(env, item, "streamIndex", value);
+        napi_create_int32(env, stream.media_type, &value);
+        napi_set_named_property(env, item, "mediaType", value);
+        napi_create_string_utf8(env, stream.codec_name, NAPI_AUTO_LENGTH, &value);
+        napi_set_named_property(env, item, "codec", value);
+        napi_create_int64(env, stream.packets, &value);
+        napi_set_named_property(env, item, "packets", value);
+        napi_create_int64(env, stream.frames, &value);
+        napi_set_named_property(env, item, "frames", value);
+        napi_create_int64(env, stream.samples, &value);
+        napi_set_named_property(env, item, "samples", value);
+        napi_create_int64(env, stream.bytes, &value);
+        napi_set_named_property(env, item, "bytes", value);
+        if ( stream.is_output ) {
+            napi_set_element(env, outputs, nb_outputs ++, item);
+        }
+        else {
+            napi_create_int64(env, stream.decode_errors, &value);
+            napi_set_named_property(env, item, "decodeErrors", value);
+            napi_set_element(env, inputs, nb_inputs ++, item);
+        }
+    }
+    napi_set_named_property(env, *result, "inputs", inputs);
+    napi_set_named_property(env, *result, "outputs", outputs);
+    return napi_ok;
 }
 
 }
\ No newline at end of file
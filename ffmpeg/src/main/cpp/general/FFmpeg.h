@@ -23,28 +23,80 @@
 #ifndef FFMPEGPROJ_FFMPEG_H
 #define FFMPEGPROJ_FFMPEG_H
 #include "napi/native_api.h"
+#include <string>
+#include "fftools/interaction/ff_callback_channel.hpp"
+#include "fftools/interaction/progress_callback.h"
+#include "fftools/interaction/job_report.h"
 
 namespace FFAV {
 
+struct FFmpegExecutionData;
+struct FFPipelineExecutionData;
+struct FFParallelExecutionData;
+
 class FFmpeg {
 public:
     static napi_value Init(napi_env env, napi_value exports);
+    // 模块加载时调用, 只保存初始化函数, 不创建线程;
+    static void RegisterWorkerInitializer();
     
 private:
     //  export function setFontConfigDir(dir: string);
     static napi_value SetFontConfigDir(napi_env env, napi_callback_info info);
-    //  export function execute(commands: string[], options?: Options): Promise<void>;
+    //  export function execute(commands: string[], options?: Options): Promise<JobReport | undefined>;
     static napi_value Execute(napi_env env, napi_callback_info info);
+    //  export function setMaxConcurrentJobs(count: number);
+    static napi_value SetMaxConcurrentJobs(napi_env env, napi_callback_info info);
+    //  export function getSchedulerStats(): SchedulerStats;
+    static napi_value GetSchedulerStats(napi_env env, napi_callback_info info);
+    //  export function prewarmWorkers(count?: number);
+    static napi_value PrewarmWorkers(napi_env env, napi_callback_info info);
+    //  export function warmup(): Promise<void>;
+    static napi_value Warmup(napi_env env, napi_callback_info info);
+    //  export function setThreadBudget(maxThreads: number);
+    static napi_value SetThreadBudget(napi_env env, napi_callback_info info);
+    //  export function getThreadStats(): ThreadStats;
+    static napi_value GetThreadStats(napi_env env, napi_callback_info info);
+    //  export function prepareFonts(): void;
+    static napi_value PrepareFonts(napi_env env, napi_callback_info info);
+    //  export function getFontCacheStats(): FontCacheStats;
+    static napi_value GetFontCacheStats(napi_env env, napi_callback_info info);
+    //  export function createMemoryInput(buffer: ArrayBuffer): string;
+    static napi_value CreateMemoryInput(napi_env env, napi_callback_info info);
+    //  export function createMemoryOutput(extension?: string, initialCapacity?: number): string;
+    static napi_value CreateMemoryOutput(napi_env env, napi_callback_info info);
+    //  export function takeMemoryOutput(url: string): ArrayBuffer;
+    static napi_value TakeMemoryOutput(napi_env env, napi_callback_info info);
+    //  export function releaseMemoryIO(url: string);
+    static napi_value ReleaseMemoryIO(napi_env env, napi_callback_info info);
+    //  export function createOutputSink(callback: (chunk: ArrayBuffer | null) => void | Promise<void>, options?: OutputSinkOptions): string;
+    static napi_value CreateOutputSink(napi_env env, napi_callback_info info);
+    static void InvokeSinkCallback(napi_env env, napi_value js_callback, void* context, void* data);
+    static napi_value OnSinkChunkSettled(napi_env env, napi_callback_info info);
+    
+    //  export function executePipeline(stages: string[][], options?: PipelineOptions): Promise<void>;
+    static napi_value ExecutePipeline(napi_env env, napi_callback_info info);
+    //  export function executeParallel(input: string, output: string, args?: string[], options?: ParallelOptions): Promise<void>;
+    static napi_value ExecuteParallel(napi_env env, napi_callback_info info);
     
-    static void AsyncExecuteCallback(napi_env env, void *data);
-    static void AsyncCompleteCallback(napi_env env, napi_status status, void *data);
+    static void ExecuteJob(void *data);
+    static void ExecutePipelineJob(void *data);
+    static void* PipelineStageEntry(void *data);
+    static void RunPipelineStage(FFPipelineExecutionData* d, size_t index);
+    static void InvokePipelineCompleteCallback(napi_env env, napi_value js_callback, void* context, void* data);
+    static void ExecuteParallelJob(void *data);
+    static void RunParallelSegment(FFParallelExecutionData* d, size_t index);
+    static std::string ParallelFingerprint(FFParallelExecutionData* d);
+    static void FinishParallel(FFParallelExecutionData* d);
+    static void InvokeParallelCompleteCallback(napi_env env, napi_value js_callback, void* context, void* data);
+    static void InvokeCompleteCallback(napi_env env, napi_value js_callback, void* context, void* data);
     
-    static void InvokeLogCallback(napi_env env, napi_value js_callback, void* context, void* data);
-    static void InvokeProgressCallback(napi_env env, napi_value js_callback, void* context, void* data);
-    static void InvokeOutputCallback(napi_env env, napi_value js_callback, void* context, void* data);
+    static void InvokeFlushCallback(napi_env env, napi_value js_callback, void* context, void* data);
     
-    static void SetFontConfigDefaultDir();
-    static void SetEnv(const char* name, const char* value);
+    static napi_status ParseDeliveryOptions(napi_env env, napi_value delivery_value, FFCallbackChannel::Options* options);
+    static napi_status CreateProgressStats(napi_env env, const NativeProgress* progress, napi_value* result);
+    static napi_status CreateExecutionStats(napi_env env, FFmpegExecutionData* d, napi_value* result);
+    static napi_status CreateJobReport(napi_env env, const FFJobReport& report, napi_value* result);
 };
 
 }
@@ -20,21 +20,106 @@
 #endif
 #include "general/FFAudioPlayer.h"
 #include "general/FFAudioWriter.h"
+#include "general/FFJobController.h"
 #include "general/FFPlayWhenReadyChangeReason.h"
 #include "general/FFmpeg.h"
+#include "general/FFProbe.h"
 #include "napi/native_api.h"
+#include <cstdint>
 
-EXTERN_C_START
-static napi_value Init(napi_env env, napi_value exports)
-{    
-    FFAV::FFmpeg::Init(env, exports);
-    FFAV::FFAudioPlayer::Init(env, exports);
-    FFAV::FFAbortController::Init(env, exports);
-    FFAV::FFPlayWhenReadyChangeReason::Init(env, exports);
+namespace {
+
+// 导出的类及命名空间在首次访问时才创建, 模块加载时只定义属性;
+struct LazyExport {
+    const char* name;
+    napi_value (*init)(napi_env env, napi_value exports);
+};
+
+const LazyExport lazy_exports[] = {
+    { "FFmpeg", FFAV::FFmpeg::Init },
+    { "FFAudioPlayer", FFAV::FFAudioPlayer::Init },
+    { "FFAbortController", FFAV::FFAbortController::Init },
+    { "FFJobController", FFAV::FFJobController::Init },
+    { "FFPlayWhenReadyChangeReason", FFAV::FFPlayWhenReadyChangeReason::Init },
 #if __has_include("general/FFAudioMultiStreamPlayer.h")
-    FFAV::FFAudioMultiStreamPlayer::Init(env, exports);
+    { "FFAudioMultiStreamPlayer", FFAV::FFAudioMultiStreamPlayer::Init },
 #endif
-    FFAV::FFAudioWriter::Init(env, exports);
+    { "FFAudioWriter", FFAV::FFAudioWriter::Init },
+    { "FFProbe", FFAV::FFProbe::Init },
+};
+
+constexpr size_t lazy_exports_count = sizeof(lazy_exports) / sizeof(lazy_exports[0]);
+
+// 每个 js 线程一个 env, 创建后的值按线程缓存, 保证多次访问得到同一个类;
+struct LazyExportCache {
+    napi_env env { nullptr };
+    napi_ref refs[lazy_exports_count] { nullptr };
+};
+
+thread_local LazyExportCache lazy_export_cache;
+
+// env 销毁时(cleanup hook)或同一线程切换到新的 env 时释放引用;
+void ReleaseLazyExportCache(void* arg) {
+    LazyExportCache* cache = reinterpret_cast<LazyExportCache*>(arg);
+    for ( napi_ref& ref : cache->refs ) {
+        if ( ref ) napi_delete_reference(cache->env, ref);
+        ref = nullptr;
+    }
+    cache->env = nullptr;
+}
+
+napi_value GetLazyExport(napi_env env, napi_callback_info info) {
+    napi_value this_arg;
+    void* data;
+    napi_get_cb_info(env, info, nullptr, nullptr, &this_arg, &data);
+    size_t idx = reinterpret_cast<uintptr_t>(data);
+    const LazyExport& lazy = lazy_exports[idx];
+    
+    LazyExportCache& cache = lazy_export_cache;
+    if ( cache.env != env ) {
+        if ( cache.env ) {
+            napi_remove_env_cleanup_hook(cache.env, ReleaseLazyExportCache, &cache);
+            ReleaseLazyExportCache(&cache);
+        }
+        cache.env = env;
+        napi_add_env_cleanup_hook(env, ReleaseLazyExportCache, &cache);
+    }
+    
+    napi_value value = nullptr;
+    if ( cache.refs[idx] ) napi_get_reference_value(env, cache.refs[idx], &value);
+    if ( value ) return value;
+    
+    napi_value holder;
+    napi_create_object(env, &holder);
+    lazy.init(env, holder);
+    napi_get_named_property(env, holder, lazy.name, &value);
+    napi_create_reference(env, value, 1, &cache.refs[idx]);
+    
+    // 替换为普通属性, 之后的访问不再经过 getter;
+    napi_valuetype this_type = napi_undefined;
+    napi_typeof(env, this_arg, &this_type);
+    if ( this_type == napi_object ) {
+        napi_property_descriptor desc = { lazy.name, nullptr, nullptr, nullptr, nullptr, value, napi_enumerable, nullptr };
+        napi_define_properties(env, this_arg, 1, &desc);
+    }
+    return value;
+}
+
+}
+
+EXTERN_C_START
+static napi_value Init(napi_env env, napi_value exports)
+{
+    // 模块加载处于应用冷启动路径上, 这里不访问文件系统也不初始化 ffmpeg, 均推迟到首次使用或 FFmpeg.warmup();
+    napi_property_descriptor properties[lazy_exports_count];
+    for ( size_t i = 0 ; i < lazy_exports_count ; ++ i ) {
+        properties[i] = { lazy_exports[i].name, nullptr, nullptr, GetLazyExport, nullptr, nullptr,
+                          static_cast<napi_property_attributes>(napi_enumerable | napi_configurable),
+                          reinterpret_cast<void*>(static_cast<uintptr_t>(i)) };
+    }
+    napi_define_properties(env, exports, lazy_exports_count, properties);
+    
+    FFAV::FFmpeg::RegisterWorkerInitializer();
     return exports;
 }
 EXTERN_C_END
@@ -23,11 +23,321 @@ export namespace FFmpeg {
     logCallback?: (level: number, msg: string) => void
     /** 这个回调是 ffmpeg 进度消息的回调, 请在执行 ffmpeg 命令时设置; */
     progressCallback?: (msg: string) => void
+    /** 结构化的进度回调, 无需再解析文本消息; 请在执行 ffmpeg 命令时设置; */
+    progressStatsCallback?: (progress: ProgressStats) => void
+    /** 毫秒, progressStatsCallback 的最小回调间隔, 最后一次进度总是回调; 默认不限制(ffmpeg 默认每 500ms 产生一次进度, 可通过 -stats_period 调整); */
+    progressInterval?: number
     /** 这个回调是 ffprobe 输出消息的回调, 请在执行 ffprobe 命令时设置; */
     outputCallback?: (msg: string) => void
+    /**
+     * ffprobe 输出消息的处理方式, 默认 'callback';
+     * - 'callback': 每个输出片段回调一次 outputCallback;
+     * - 'buffer': 在 native 层缓存全部输出, 执行成功后通过 promise 返回完整内容;
+     * - 'chunked': 按 outputChunkSize 分块回调 outputCallback;
+     * */
+    outputMode?: 'callback' | 'buffer' | 'chunked'
+    /** 'chunked' 模式下每块的字节数, 默认 64KB, 最小 1KB; */
+    outputChunkSize?: number
     signal?: FFAbortSignal
+    /** 暂停/恢复执行中的命令, 或在执行期间调整限速; */
+    controller?: FFJobController
+    /** 限速, 执行期间可通过 controller.setThrottle 调整; */
+    throttle?: ThrottleOptions
+    /** 调度优先级, 默认为 JobPriority.NORMAL; 排队时优先级高的命令先执行; */
+    priority?: JobPriority
+    /** 日志/进度/输出消息的投递配置; */
+    delivery?: DeliveryOptions
+    /** 执行结束后(Promise 完成前)回调本次执行的统计信息; */
+    statsCallback?: (stats: ExecutionStats) => void
+  }
+
+  /** 未知的值为 -1; */
+  export interface ProgressStats {
+    readonly frame: number;
+    readonly fps: number;
+    readonly outTimeUs: number;
+    readonly totalSize: number;
+    /** bits/s; */
+    readonly bitrate: number;
+    readonly speed: number;
+    readonly dupFrames: number;
+    readonly dropFrames: number;
+    /** 是否为最后一次进度; */
+    readonly isLast: boolean;
+    /** 是否设置了限速; */
+    readonly throttled: boolean;
+    /** 毫秒, 因限速累计等待的时长; */
+    readonly throttledTime: number;
+    /** 各输出流的进度; */
+    readonly outputs: OutputStreamProgress[];
+  }
+
+  export interface OutputStreamProgress {
+    readonly fileIndex: number;
+    readonly streamIndex: number;
+    /** 0: video, 1: audio, 2: data, 3: subtitle, 4: attachment; */
+    readonly mediaType: number;
+    /** 编码质量, 未编码时为 -1; */
+    readonly q: number;
+    readonly packetsWritten: number;
+    readonly framesEncoded: number;
+    /** 写入的字节数; */
+    readonly dataSize: number;
+    readonly outTimeUs: number;
+  }
+
+  /**
+   * 执行期间的消息会先写入缓冲区, 再批量投递到 js 线程回调;
+   * */
+  export interface DeliveryOptions {
+    /** 缓冲区大小(字节), 默认 256KB; */
+    bufferSize?: number
+    /** 缓冲区中的消息累积到指定字节数后立即投递, 默认 16KB; */
+    flushThreshold?: number
+    /** 毫秒, 消息在缓冲区中最多停留的时长, 默认 100ms; */
+    flushInterval?: number
+    /** 缓冲区已满时日志消息的处理方式, 默认 'block'; 'block': 等待 js 线程消费; 'drop': 丢弃并计数; 进度及输出消息不会丢弃; */
+    logOverflowPolicy?: 'block' | 'drop'
+  }
+
+  export interface ExecutionStats {
+    readonly delivery: {
+      /** 已投递的消息数量; */
+      records: number,
+      /** 投递批次; */
+      batches: number,
+      /** 单批次最多的消息数量; */
+      maxBatchRecords: number,
+      /** 因缓冲区已满被丢弃的日志数量; */
+      droppedLogs: number,
+      /** 因缓冲区已满等待的次数; */
+      blockedWrites: number,
+      /** 毫秒, 命令结束后等待剩余消息被回调完毕的时长; */
+      drainLatency: number,
+    };
+    /** 毫秒, 通过 FFJobController 暂停的总时长; */
+    readonly pausedTime: number;
+    /** 本次执行的资源及性能统计, 仅 ffmpeg 命令; 执行失败或取消时为截至结束时的统计; */
+    readonly report?: JobReport;
+  }
+
+  /**
+   * 单次 ffmpeg 命令的资源及性能统计, 每次执行都会收集, 与 -benchmark 无关;
+   *
+   * userTime/sysTime/maxRss 为进程级的统计, 同时执行多个命令时包含其他命令的消耗;
+   * jobUserTime/jobSysTime 仅统计命令自身的线程(主线程/读取/封装线程), 不包括编解码器及滤镜内部的工作线程;
+   * */
+  export interface JobReport {
+    /** 毫秒, 执行耗时; */
+    readonly wallTime: number;
+    /** 毫秒, 执行期间进程的用户态/内核态 cpu 时间; */
+    readonly userTime: number;
+    readonly sysTime: number;
+    /** 毫秒, 命令自身线程的用户态/内核态 cpu 时间; */
+    readonly jobUserTime: number;
+    readonly jobSysTime: number;
+    /** 字节, 进程的峰值常驻内存; */
+    readonly maxRss: number;
+    /** 从输入读取/向输出写入的字节数; */
+    readonly bytesRead: number;
+    readonly bytesWritten: number;
+    /** 成功解码的帧数及解码失败的次数; */
+    readonly framesDecoded: number;
+    readonly decodeErrors: number;
+    readonly dupFrames: number;
+    readonly dropFrames: number;
+    /** 毫秒, 各阶段的耗时; 嵌套的阶段(如解码后立即滤镜)只计入内层阶段; */
+    readonly stageTimes: {
+      demux: number,
+      decode: number,
+      filter: number,
+      encode: number,
+      mux: number,
+    };
+    readonly inputs: JobStreamReport[];
+    readonly outputs: JobStreamReport[];
+    /** 各队列共享的 packet/frame 对象池; */
+    readonly pools: {
+      packets: JobPoolReport,
+      frames: JobPoolReport,
+    };
+  }
+
+  export interface JobPoolReport {
+    /** 复用池中对象的次数; */
+    readonly hits: number;
+    /** 池为空时新分配的次数; */
+    readonly misses: number;
+    /** 超出保留上限被释放的次数; */
+    readonly discarded: number;
+    /** 同时在用的最大数量; */
+    readonly highWater: number;
+  }
+
+  export interface JobStreamReport {
+    readonly fileIndex: number;
+    readonly streamIndex: number;
+    /** 0: video, 1: audio, 2: data, 3: subtitle, 4: attachment; */
+    readonly mediaType: number;
+    /** 输入: 解码器名称, 未解码时为编码格式; 输出: 编码器名称, 流复制时为 copy; */
+    readonly codec: string;
+    /** 输入: 读取的包数量; 输出: 写入的包数量; */
+    readonly packets: number;
+    /** 输入: 解码的帧数; 输出: 编码的帧数; */
+    readonly frames: number;
+    /** 音频的采样数; */
+    readonly samples: number;
+    readonly bytes: number;
+    /** 解码失败的次数, 仅输入; */
+    readonly decodeErrors?: number;
+  }
+
+  export enum JobPriority {
+    INTERACTIVE,
+    NORMAL,
+    BACKGROUND,
+  }
+
+  export interface SchedulerStats {
+    readonly maxConcurrentJobs: number;
+    /** 已创建的工作线程数量, 工作线程常驻并复用; */
+    readonly workers: number;
+    readonly runningJobs: number;
+    readonly queuedJobs: { interactive: number, normal: number, background: number };
+    readonly completedJobs: number;
+    /** 毫秒, 任务在队列中的等待时长; */
+    readonly lastWaitTime: number;
+    readonly avgWaitTime: number;
+    readonly maxWaitTime: number;
+  }
+
+  /**
+   * 设置可同时执行的命令数量上限(最小为 1), 超出的命令将排队等待;
+   *
+   * 命令在独立的工作线程中执行, 不会占用系统的异步任务线程池;
+   * */
+  export function setMaxConcurrentJobs(count: number);
+
+  /**
+   * 预先创建工作线程并完成初始化, 数量默认为并发上限且不超过并发上限;
+   *
+   * 工作线程常驻, 初始化后缓存每个命令都需要的数据; 大量短时命令(如截图、读取信息)时可在启动阶段调用, 避免首批命令等待线程创建及初始化;
+   * */
+  export function prewarmWorkers(count?: number): void;
+
+  /** 获取调度器的状态, 包括排队数量及等待时长; */
+  export function getSchedulerStats(): SchedulerStats;
+
+  export interface JobThreadStats {
+    readonly id: number;
+    readonly kind: 'ffmpeg' | 'ffprobe' | 'player';
+    readonly totalThreads: number;
+    /**
+     * 各类型存活的线程数量;
+     *
+     * job: 执行命令的线程; demux/mux: 每个输入/输出的读写线程; encode/decode: -encoder_threads/-decoder_threads 的编解码线程;
+     * codec/filter: 编解码器及滤镜内部的线程;
+     * reader/event/task: 播放器的读取线程、事件线程及延时任务线程;
+     * */
+    readonly threads: { job: number, demux: number, mux: number, encode: number, decode: number, codec: number, filter: number, reader: number, event: number, task: number };
+  }
+
+  export interface ThreadStats {
+    /** 线程预算, 0 表示未开启; */
+    readonly maxThreads: number;
+    /** 所有任务存活的线程数量; */
+    readonly liveThreads: number;
+    /** 按当前负载, 新打开的编解码器及滤镜可以使用的线程数量; */
+    readonly codecThreads: number;
+    readonly jobs: JobThreadStats[];
   }
 
+  /**
+   * 设置进程内的线程预算, 默认为 cpu 核心数; 0 表示关闭;
+   *
+   * 命令未指定 -threads, -filter_threads 及 -filter_complex_threads 时, 根据当前负载自动设置:
+   * 预算扣除所有命令及播放器的固定线程(执行/读取/写入等线程)后, 由正在执行的 ffmpeg 命令平分, 每个命令至少 1 个;
+   * 仅影响之后打开的编解码器及滤镜;
+   * */
+  export function setThreadBudget(maxThreads: number): void;
+
+  /** 获取各命令及播放器当前存活的线程数量; */
+  export function getThreadStats(): ThreadStats;
+
+  export interface FontCacheStats {
+    /** 字体索引是否已构建; */
+    readonly ready: boolean;
+    /** 索引中的字体数量; */
+    readonly fonts: number;
+    /** 毫秒, 最近一次构建的耗时; 已有缓存时只需加载缓存文件; */
+    readonly buildTime: number;
+    readonly builds: number;
+    /** 等待其他命令构建完成的次数; */
+    readonly waits: number;
+  }
+
+  /**
+   * 在后台构建字体索引;
+   *
+   * 使用 subtitles/ass/drawtext 滤镜的命令在执行前会自动构建, 进程内只构建一次, 扫描结果缓存在应用目录中;
+   * 可在启动阶段调用, 避免首个烧录字幕的命令等待字体扫描;
+   * */
+  export function prepareFonts(): void;
+
+  /** 获取字体索引的状态; */
+  export function getFontCacheStats(): FontCacheStats;
+
+  /**
+   * 在后台完成初始化;
+   *
+   * 模块加载时不做任何初始化, 首次执行命令时才会初始化 ffmpeg 及字体配置;
+   * 可在启动完成后调用, 提前完成这些工作, 避免首个命令的额外耗时;
+   * 以 JobPriority.BACKGROUND 提交到调度器, 排队中的命令优先执行;
+   * */
+  export function warmup(): Promise<void>;
+
+  /**
+   * 将 ArrayBuffer 注册为内存输入, 返回 mem://<id> 地址, 可直接作为 ffmpeg/ffprobe 命令的输入;
+   *
+   * 执行期间直接读取 buffer 中的数据, 不会写入临时文件; 在 releaseMemoryIO 之前 buffer 会一直被持有, 请不要修改其内容;
+   * 在 releaseMemoryIO 之前不能转移 buffer(如 postMessage 的 transfer 列表或 ArrayBuffer.transfer), 转移后数据被释放, 执行中的命令会读取已释放的内存;
+   * 已转移的 buffer 直接抛出异常;
+   * */
+  export function createMemoryInput(buffer: ArrayBuffer): string;
+
+  /**
+   * 创建内存输出, 返回 mem://<id>[.extension] 地址, 可直接作为 ffmpeg 命令的输出;
+   *
+   * @param extension 扩展名, 用于推断输出格式(如 'mp4'); 不设置时请在命令中通过 -f 指定格式;
+   * @param initialCapacity 字节, 初始容量; 写入时按需扩容;
+   * */
+  export function createMemoryOutput(extension?: string, initialCapacity?: number): string;
+
+  /** 取出内存输出的数据并释放该地址; 数据直接转移到返回的 ArrayBuffer, 不做复制; */
+  export function takeMemoryOutput(url: string): ArrayBuffer;
+
+  /** 释放内存输入或输出; 正在被执行中的命令使用时会抛出异常; 释放正在写入的 sink 时会终止写入; */
+  export function releaseMemoryIO(url: string): void;
+
+  export interface OutputSinkOptions {
+    /** 字节, 每次回调的数据大小(最后一块可能较小), 默认 64KB, 最小 4KB; */
+    chunkSize?: number
+    /** 字节, 已回调但未处理完毕的数据超过该值时, 暂停写入等待 callback 处理; 默认 1MB; */
+    highWaterMark?: number
+    /** 扩展名, 用于推断输出格式(如 'ts'); 不设置时请在命令中通过 -f 指定格式; */
+    extension?: string
+  }
+
+  /**
+   * 创建流式输出, 返回 sink://<id>[.extension] 地址, 可直接作为 ffmpeg 命令的输出;
+   *
+   * 封装后的数据按 chunkSize 分块回调, 可以边转码边上传; callback 返回 Promise 时, 在其完成后才计为已处理;
+   * 输出结束时回调 chunk 为 null; 每个地址只能作为一次输出; callback 抛出异常时终止写入, 命令以错误结束;
+   *
+   * 该输出不支持 seek, 需要回写文件头的格式请使用流式封装(如 mp4 添加 -movflags frag_keyframe+empty_moov, 或使用 ts);
+   * */
+  export function createOutputSink(callback: (chunk: ArrayBuffer | null) => void | Promise<void>, options?: OutputSinkOptions): string;
+
   /**
    * 执行脚本命令;
    *
@@ -50,7 +360,93 @@ export namespace FFmpeg {
    * });
    * \endcode
    * */
-  export function execute(commands: string[], options?: Options): Promise<void>;
+  export function execute(commands: string[], options: Options & { outputMode: 'buffer' }): Promise<string>;
+  /** ffmpeg 命令执行成功后返回本次执行的报告, ffprobe 命令返回 undefined; */
+  export function execute(commands: string[], options?: Options): Promise<JobReport | undefined>;
+
+  export interface PipelineOptions {
+    /** 取消整个流水线, 所有阶段都会停止; */
+    signal?: FFAbortSignal
+    /** 暂停/恢复整个流水线; */
+    controller?: FFJobController
+    /** 限速, 作用于每个阶段; */
+    throttle?: ThrottleOptions
+    /** 调度优先级, 默认为 JobPriority.NORMAL; */
+    priority?: JobPriority
+    /** 字节, 每个管道的缓冲区大小, 默认 1MB; */
+    pipeBufferSize?: number
+  }
+
+  /**
+   * 同时执行多个命令, 命令之间通过内存管道传递数据, 不会写入临时文件;
+   *
+   * 命令中的 fifo://<name> 为管道地址, 同名地址连接到同一个管道, 一个命令写入另一个命令读取, 可以带扩展名(如 fifo://a.nut);
+   * 每个管道必须恰好由一个命令写入(ffmpeg 的输出)、另一个命令读取(-i 之后的输入), 否则直接 reject, 不会执行;
+   * 管道不支持 seek, 请使用流式格式(如 nut, matroska, ts, wav)并通过 -f 指定;
+   * 任一命令失败时其余命令全部停止, 返回的错误中 stage 为失败命令的索引; 读取端正常结束后(如 -t)写入端因管道关闭而停止时不视为失败;
+   * 除第一个命令外其余命令在独立线程中执行, 同时计入调度器的并发数;
+   *
+   * \code
+   * FFmpeg.executePipeline([
+   *   ["ffmpeg", "-i", inputPath, "-af", "loudnorm", "-f", "nut", "fifo://normalized"],
+   *   ["ffmpeg", "-f", "nut", "-i", "fifo://normalized", "-c:a", "aac", outputPath],
+   * ], { signal: abortController.signal });
+   * \endcode
+   * */
+  export function executePipeline(stages: string[][], options?: PipelineOptions): Promise<void>;
+
+  export interface CheckpointOptions {
+    /** 任务标识, 不能包含 '/'; 使用相同 jobId 再次执行时跳过已完成的分段; 同一 jobId 同时只能执行一次; */
+    jobId: string
+    /** 检查点目录, 默认为应用 files 目录下的 sj_ff_av/checkpoints; */
+    dir?: string
+    /** 秒, 分段时长, 默认 60s; 即中断后最多需要重新转码的时长; */
+    segmentDuration?: number
+  }
+
+  export interface ParallelOptions {
+    /** 分段数量, 默认为调度器的并发上限; */
+    segments?: number
+    /** 秒, 每段的最短时长, 默认 10s; 输入过短时减少分段; */
+    minSegmentDuration?: number
+    /** 取消执行, 所有分段都会停止; */
+    signal?: FFAbortSignal
+    /** 暂停/恢复所有分段; */
+    controller?: FFJobController
+    /** 限速; speed 为所有分段合计的倍速, 由执行中的分段平分; cpuShare 作用于每个分段; */
+    throttle?: ThrottleOptions
+    /** 调度优先级, 默认为 JobPriority.NORMAL; */
+    priority?: JobPriority
+    /**
+     * 启用检查点; 分段输出写入检查点目录, 完成的分段记录在 checkpoint.txt 中;
+     * 取消、失败或进程被终止后, 以相同的 jobId 及参数再次执行时跳过已完成的分段; 全部完成后删除检查点;
+     * 输入、输出或参数发生变化时已有的检查点作废; 只有一段时(见下方说明)不生效, 结果中 checkpointed 为 false;
+     * */
+    checkpoint?: CheckpointOptions
+  }
+
+  export interface ParallelResult {
+    /** 分段数量, 1 表示未分段; */
+    segments: number
+    /** 从检查点复用、本次未重新转码的分段数; */
+    resumedSegments: number
+    /** 是否启用了检查点; 设置了 checkpoint 但只有一段时为 false, 中断后需要从头执行; */
+    checkpointed: boolean
+  }
+
+  /**
+   * 将单个输入切分为多段同时转码, 再无损拼接为一个输出, 用于长音频的批量转换;
+   *
+   * 仅输出第一条音频流; args 为输出选项(如 ["-c:a", "aac", "-b:a", "128k"]), 请勿使用依赖绝对时间戳的滤镜(如 afade 的 st 参数);
+   * 分段按编码器的帧长对齐, 并在边界前后多编码一小段, 拼接时裁掉重叠的部分, 编码器的开头与结尾填充只保留一次;
+   * 编码器帧长不固定(如 pcm)、流复制或输入时长未知时不分段, 与 execute 相同; 输出已存在时覆盖;
+   * 任一分段失败时其余分段全部停止, 返回的错误中 segment 为失败分段的索引;
+   *
+   * \code
+   * FFmpeg.executeParallel(inputPath, outputPath, ["-c:a", "aac", "-b:a", "128k"], { signal: abortController.signal });
+   * \endcode
+   * */
+  export function executeParallel(input: string, output: string, args?: string[], options?: ParallelOptions): Promise<ParallelResult>;
 }
 
 export class FFAbortController {
@@ -58,6 +454,31 @@ export class FFAbortController {
   abort(reason?: Error): void;
 }
 
+/**
+ * 限速; 同时设置时均生效, 均未设置时不限速;
+ * */
+export interface ThrottleOptions {
+  /** 按媒体时间限制处理速度的倍率(如 4 表示最多 4 倍速), 与 -readrate 类似; */
+  speed?: number;
+  /** (0, 1), 命令执行时间的占比上限, 其余时间等待; 适合与播放等前台任务同时执行时降低占用; */
+  cpuShare?: number;
+}
+
+/**
+ * 控制执行中的命令, 可以同时传给多个命令;
+ *
+ * 暂停后命令在处理完当前 packet 后停止, 读取线程停止读取, 不占用 cpu, 已处理的进度保留; 恢复后继续执行;
+ * 暂停期间命令仍占用一个并发名额; 取消(FFAbortSignal)会立即结束暂停中的命令;
+ * 网络输入长时间暂停可能因服务端超时而失败;
+ * */
+export class FFJobController {
+  pause(): void;
+  resume(): void;
+  get paused(): boolean;
+  /** 调整限速, 立即生效; 不传参数时取消限速; */
+  setThrottle(options?: ThrottleOptions): void;
+}
+
 export class FFAbortSignal {
   get aborted(): boolean;
   get reason(): Error | undefined;
@@ -213,3 +634,137 @@ export class FFAudioWriter {
   public close(callback: (error?: Error) => void);
   public closeSync();
 }
+
+/**
+ * 直接读取媒体信息, 不经过 ffprobe 命令行及 JSON 解析; 适用于批量获取时长、编码、采样率等信息;
+ * */
+export namespace FFProbe {
+  export interface ProbeOptions {
+    /** 字节, 探测格式时最多读取的数据量; 默认使用 ffmpeg 的默认值(5MB); */
+    probeSize?: number
+    /** 毫秒, 探测流信息时最多分析的时长; 默认使用 ffmpeg 的默认值(5s); */
+    analyzeDuration?: number
+    /** 是否读取数据包探测流信息, 默认 true; 容器头部信息足够时(如 mp4, flac)可设置为 false 以减少耗时, 部分格式的时长等信息可能缺失; */
+    findStreamInfo?: boolean
+    /** 设置 http 请求, 同 FFAudioPlaybackOptions.httpOptions; */
+    httpOptions?: Record<string, string>
+    /** 本地文件是否使用持久化的媒体信息缓存, 默认 true; 文件大小或修改时间变化后缓存自动失效; */
+    cache?: boolean
+    /** 使用缓存时是否同时校验文件头部 1KB 的内容, 默认 false; */
+    verifyContent?: boolean
+    /** 取消读取, 取消后以 FF_CANCELLED_ERR reject; */
+    signal?: FFAbortSignal
+    /** 调度优先级, 默认为 JobPriority.NORMAL; 与 ffmpeg 命令共用调度器的并发上限; */
+    priority?: FFmpeg.JobPriority
+  }
+
+  export interface ProbeCacheStats {
+    readonly entries: number;
+    /** 字节 */
+    readonly size: number;
+    readonly maxSize: number;
+    readonly hits: number;
+    readonly misses: number;
+  }
+
+  /** 设置媒体信息缓存文件的大小上限(字节), 默认 8MB; 超出时按最近最少使用淘汰; */
+  export function setCacheMaxSize(bytes: number): void;
+  /** 清除媒体信息缓存; */
+  export function clearCache(): void;
+  /** 立即将媒体信息缓存写入磁盘; 没有执行中的任务时会自动写入, 可在应用退到后台时调用; */
+  export function flushCache(): void;
+  export function getCacheStats(): ProbeCacheStats;
+
+  /** 时间单位为毫秒, 未知时为 -1; */
+  export interface MediaInfo {
+    readonly formatName: string;
+    readonly duration: number;
+    readonly startTime: number;
+    readonly bitRate: number;
+    readonly metadata: Record<string, string>;
+    readonly streams: MediaStreamInfo[];
+  }
+
+  export interface MediaStreamInfo {
+    readonly index: number;
+    /** 0: video, 1: audio, 2: data, 3: subtitle, 4: attachment; */
+    readonly mediaType: number;
+    readonly codecName: string;
+    readonly bitRate: number;
+    readonly duration: number;
+    readonly metadata: Record<string, string>;
+    /** 音频流 */
+    readonly sampleRate?: number;
+    readonly channels?: number;
+    readonly sampleFormat?: string;
+    /** 视频流 */
+    readonly width?: number;
+    readonly height?: number;
+    readonly frameRate?: number;
+  }
+
+  /**
+   * 读取媒体信息;
+   *
+   * \code
+   * FFProbe.probe(inputPath, { findStreamInfo: false }).then((info: FFProbe.MediaInfo) => {
+   *  console.info(`duration: ${info.duration}ms`);
+   * });
+   * \endcode
+   * */
+  export function probe(url: string, options?: ProbeOptions): Promise<MediaInfo>;
+
+  export interface ScanOptions extends ProbeOptions {
+    /** 批量回调, 按扫描完成的顺序回调; 回调处理不及时时扫描会暂停等待; */
+    batchCallback: (results: ScanResult[], progress: ScanProgress) => void
+    /** 同时读取的文件数量, 默认为 CPU 核心数; */
+    concurrency?: number
+    /** 每批次的最大数量, 默认 32; */
+    batchSize?: number
+    /** 毫秒, 批次未满时的最长等待时长, 默认 200ms; */
+    batchInterval?: number
+    /** 是否扫描子目录, 默认 true; */
+    recursive?: boolean
+    /** 扫描目录时仅包含指定扩展名的文件(如 ['mp3', 'flac']), 不区分大小写; 默认包含所有文件; */
+    extensions?: string[]
+    /** 取消扫描, 已回调的结果不受影响; */
+    signal?: FFAbortSignal
+    /** 调度优先级, 默认为 JobPriority.BACKGROUND; */
+    priority?: FFmpeg.JobPriority
+  }
+
+  export interface ScanResult {
+    readonly url: string;
+    /** 读取成功时有值; */
+    readonly info?: MediaInfo;
+    /** 读取失败时有值; */
+    readonly error?: Error;
+  }
+
+  export interface ScanProgress {
+    readonly completed: number;
+    readonly total: number;
+  }
+
+  export interface ScanSummary {
+    readonly completed: number;
+    readonly total: number;
+  }
+
+  /**
+   * 批量读取媒体信息;
+   *
+   * inputs 可以是文件或目录; 多个文件并行读取, 结果分批回调到 js 线程, 本地文件同样使用媒体信息缓存;
+   *
+   * \code
+   * FFProbe.scan(musicDir, {
+   *   extensions: ['mp3', 'flac', 'm4a'],
+   *   findStreamInfo: false,
+   *   batchCallback: (results: FFProbe.ScanResult[], progress: FFProbe.ScanProgress) => {
+   *     console.info(`${progress.completed}/${progress.total}`);
+   *   }
+   * });
+   * \endcode
+   * */
+  export function scan(inputs: string | string[], options: ScanOptions): Promise<ScanSummary>;
+}